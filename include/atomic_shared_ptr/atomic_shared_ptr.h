@@ -0,0 +1,194 @@
+#pragma once
+
+#include "epoch_reclaimer/epoch_reclaimer.h"
+#include "shared_ptr/shared_ptr.h"
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+namespace dev {
+
+/**
+ * @brief A dev::shared_ptr that threads can load and replace concurrently,
+ * without a lock, such as a snapshot of reference data that many readers
+ * take and a writer republishes from time to time.
+ *
+ * It holds a single atomic pointer to a control block, and owns one strong
+ * and one weak reference of that block. A writer swaps the pointer with one
+ * atomic exchange, and drops the strong reference of the old block right
+ * away, so the old object is destroyed as soon as its last reader lets it go.
+ * The weak reference, which keeps the bytes of the block, is retired to
+ * dev::epoch_reclaimer instead.
+ *
+ * A reader pins its thread, loads the pointer, and takes a strong reference
+ * as dev::weak_ptr::lock() does. The block it loaded can not be freed while
+ * the thread is pinned; if its strong count has already dropped to zero, a
+ * writer has replaced it, and the reader loads again. Readers never wait for
+ * writers, nor writers for readers.
+ *
+ * All operations are sequentially consistent on the pointer.
+ */
+template<typename T>
+class atomic_shared_ptr
+{
+    static_assert(!std::is_array_v<T>, "atomic_shared_ptr does not support arrays");
+
+  public:
+    using value_type = shared_ptr<T>;
+
+  private:
+    using base = shared_ptr_base<T>;
+    using control_block_base = typename base::control_block_base;
+
+    std::atomic<control_block_base*> m_control_block_ptr{ nullptr };
+
+    /**
+     * @brief Takes over the strong reference of %ptr, and adds the weak one
+     * of the atomic pointer.
+     */
+    static control_block_base* adopt_aux(shared_ptr<T>&& ptr) noexcept
+    {
+        base& b = ptr;
+        control_block_base* cb = std::exchange(b.m_control_block_ptr, nullptr);
+        b.m_raw_underlying_ptr = nullptr;
+        if (cb)
+            cb->increment_weak();
+        return cb;
+    }
+
+    /**
+     * @brief Hands the strong reference of %cb over to a new shared_ptr.
+     */
+    static shared_ptr<T> share_aux(control_block_base* cb) noexcept
+    {
+        shared_ptr<T> result;
+        if (cb) {
+            base& b = result;
+            b.m_raw_underlying_ptr = cb->get();
+            b.m_control_block_ptr = cb;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Drops the weak reference of a block that has just been replaced,
+     * once no pinned reader can still be looking at it.
+     */
+    static void retire_aux(control_block_base* cb)
+    {
+        if (cb)
+            epoch_reclaimer::retire(cb, [](void* p) { static_cast<control_block_base*>(p)->release_weak(); });
+    }
+
+  public:
+    atomic_shared_ptr() noexcept = default;
+
+    atomic_shared_ptr(shared_ptr<T> desired) noexcept
+      : m_control_block_ptr{ adopt_aux(std::move(desired)) }
+    {
+    }
+
+    atomic_shared_ptr(const atomic_shared_ptr&) = delete;
+    atomic_shared_ptr& operator=(const atomic_shared_ptr&) = delete;
+
+    ~atomic_shared_ptr()
+    {
+        if (control_block_base* cb = m_control_block_ptr.load(std::memory_order_relaxed)) {
+            cb->release_shared();
+            cb->release_weak();
+        }
+    }
+
+    static constexpr bool is_always_lock_free = std::atomic<control_block_base*>::is_always_lock_free;
+
+    [[nodiscard]] bool is_lock_free() const noexcept { return m_control_block_ptr.is_lock_free(); }
+
+    /**
+     * @brief Returns a new owner of the current object.
+     * @throws std::bad_alloc if it is the first time the thread pins itself
+     * and its dev::epoch_reclaimer record cannot be allocated.
+     */
+    [[nodiscard]] shared_ptr<T> load() const
+    {
+        epoch_reclaimer::guard guard;
+        while (true) {
+            control_block_base* cb = m_control_block_ptr.load(std::memory_order_seq_cst);
+            if (!cb || cb->increment_if_nonzero())
+                return share_aux(cb);
+        }
+    }
+
+    operator shared_ptr<T>() const { return load(); }
+
+    /**
+     * @brief Replaces the object with %desired.
+     * @throws std::bad_alloc if the old control block cannot be retired.
+     */
+    void store(shared_ptr<T> desired) { exchange(std::move(desired)); }
+
+    atomic_shared_ptr& operator=(shared_ptr<T> desired)
+    {
+        store(std::move(desired));
+        return *this;
+    }
+
+    /**
+     * @brief Replaces the object with %desired, and returns the previous one.
+     * @throws std::bad_alloc if the old control block cannot be retired.
+     */
+    shared_ptr<T> exchange(shared_ptr<T> desired)
+    {
+        control_block_base* old =
+          m_control_block_ptr.exchange(adopt_aux(std::move(desired)), std::memory_order_seq_cst);
+        // The strong reference goes to the caller, the weak one to the reclaimer
+        shared_ptr<T> result = share_aux(old);
+        retire_aux(old);
+        return result;
+    }
+
+    /**
+     * @brief Replaces the object with %desired if the current one is owned by
+     * the same control block as %expected; otherwise loads the current one
+     * into %expected.
+     * @throws std::bad_alloc if the old control block cannot be retired, or
+     * the thread cannot be pinned.
+     */
+    bool compare_exchange_strong(shared_ptr<T>& expected, shared_ptr<T> desired)
+    {
+        const base& e = expected;
+        control_block_base* const wanted = e.m_control_block_ptr;
+        // The references are taken before the block can be published
+        control_block_base* const next = adopt_aux(std::move(desired));
+        epoch_reclaimer::guard guard;
+        while (true) {
+            control_block_base* current = wanted;
+            if (m_control_block_ptr.compare_exchange_strong(current, next, std::memory_order_seq_cst)) {
+                if (current) {
+                    current->release_shared();
+                    retire_aux(current);
+                }
+                return true;
+            }
+            // A block whose strong count has dropped to zero was replaced
+            // meanwhile, so the comparison starts over
+            if (!current || current->increment_if_nonzero()) {
+                if (next) {
+                    next->release_weak();
+                    next->release_shared();
+                }
+                expected = share_aux(current);
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief Same as compare_exchange_strong(), which never fails spuriously.
+     */
+    bool compare_exchange_weak(shared_ptr<T>& expected, shared_ptr<T> desired)
+    {
+        return compare_exchange_strong(expected, std::move(desired));
+    }
+};
+
+} // namespace dev
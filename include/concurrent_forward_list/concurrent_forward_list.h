@@ -0,0 +1,309 @@
+#pragma once
+
+#include "epoch_reclaimer/epoch_reclaimer.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+namespace dev {
+
+/**
+ * @brief A sorted set in a lock-free singly-linked list, after Harris's
+ * algorithm with Michael's eager unlinking.
+ *
+ * insert(), erase() and contains() take no lock. An element is erased in two
+ * steps: first it is marked, by setting the low bit of its own next pointer,
+ * which makes it logically absent and stops any insertion behind it; then it
+ * is unlinked by a compare-and-swap on the link of its predecessor. Whichever
+ * thread walks past a marked node unlinks it, so a stalled eraser never
+ * blocks the others.
+ *
+ * Unlinked nodes are freed through dev::epoch_reclaimer: every operation pins
+ * the calling thread, so a node is only freed once no thread can still be
+ * walking through it.
+ *
+ * Iteration is lock-free too, and weakly consistent: it sees every element
+ * present for the whole iteration, in order, and may or may not see elements
+ * inserted or erased meanwhile. An iterator pins its thread while it lives, so
+ * it must stay on that thread and should not be kept around.
+ *
+ * size() is maintained with a relaxed counter, so under concurrent updates it
+ * is only a snapshot.
+ */
+template<typename T, typename Compare = std::less<T>>
+class concurrent_forward_list
+{
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using value_compare = Compare;
+    using reference = const T&;
+    using const_reference = const T&;
+
+  private:
+    // A tagged pointer to the next node; the low bit marks the node holding
+    // the link as erased
+    using link = std::uintptr_t;
+    static constexpr link mark_bit = 1;
+
+    struct node
+    {
+        T value;
+        std::atomic<link> next{ 0 };
+
+        template<typename... Args>
+        explicit node(Args&&... args)
+          : value(std::forward<Args>(args)...)
+        {
+        }
+    };
+
+    static_assert(alignof(node) > 1, "the low bit of node addresses marks erased nodes");
+
+    static node* to_node(link l) noexcept { return reinterpret_cast<node*>(l & ~mark_bit); }
+    static link to_link(node* n) noexcept { return reinterpret_cast<link>(n); }
+    static bool is_marked(link l) noexcept { return l & mark_bit; }
+
+    std::atomic<link> m_head{ 0 };
+    std::atomic<size_type> m_size{ 0 };
+    [[no_unique_address]] Compare m_comp;
+
+    /**
+     * @brief The position of a key: the link that points to the first node
+     * not less than it, and that node.
+     */
+    struct position
+    {
+        std::atomic<link>* prev;
+        node* curr;
+        bool found;
+    };
+
+    /**
+     * @brief Finds the position of %key, unlinking the marked nodes on the
+     * way. The caller must be pinned.
+     */
+    template<typename K>
+    position search_aux(const K& key)
+    {
+    retry:
+        std::atomic<link>* prev = &m_head;
+        node* curr = to_node(prev->load(std::memory_order_acquire));
+        while (curr) {
+            link next = curr->next.load(std::memory_order_acquire);
+            if (is_marked(next)) {
+                // Fails if the predecessor changed or was marked in turn
+                link expected = to_link(curr);
+                if (!prev->compare_exchange_strong(
+                      expected, next & ~mark_bit, std::memory_order_acq_rel))
+                    goto retry;
+                epoch_reclaimer::retire(curr);
+                curr = to_node(next);
+                continue;
+            }
+            if (!m_comp(curr->value, key))
+                return { prev, curr, !m_comp(key, curr->value) };
+            prev = &curr->next;
+            curr = to_node(next);
+        }
+        return { prev, nullptr, false };
+    }
+
+    /**
+     * @brief Links %n, whose element is %key, unless an equivalent element is
+     * present, in which case %n is deleted. The caller must be pinned.
+     */
+    bool emplace_aux(const T& key, node* n)
+    {
+        while (true) {
+            position pos = search_aux(key);
+            if (pos.found) {
+                delete n;
+                return false;
+            }
+            n->next.store(to_link(pos.curr), std::memory_order_relaxed);
+            link expected = to_link(pos.curr);
+            if (pos.prev->compare_exchange_strong(
+                  expected, to_link(n), std::memory_order_release, std::memory_order_relaxed)) {
+                m_size.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+  public:
+    /**
+     * @brief A forward iterator that skips erased elements. It keeps the
+     * calling thread pinned, so the element it points to stays valid even if
+     * another thread erases it.
+     */
+    class const_iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+      private:
+        friend class concurrent_forward_list;
+
+        epoch_reclaimer::guard m_guard;
+        node* m_node{ nullptr };
+
+        void skip_erased_aux() noexcept
+        {
+            while (m_node && is_marked(m_node->next.load(std::memory_order_acquire)))
+                m_node = to_node(m_node->next.load(std::memory_order_acquire));
+        }
+
+      public:
+        const_iterator() = default;
+
+        reference operator*() const noexcept { return m_node->value; }
+        pointer operator->() const noexcept { return &m_node->value; }
+
+        const_iterator& operator++() noexcept
+        {
+            m_node = to_node(m_node->next.load(std::memory_order_acquire));
+            skip_erased_aux();
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            auto temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) noexcept
+        {
+            return lhs.m_node == rhs.m_node;
+        }
+    };
+
+    using iterator = const_iterator;
+
+    concurrent_forward_list() = default;
+
+    explicit concurrent_forward_list(const Compare& comp)
+      : m_comp(comp)
+    {
+    }
+
+    concurrent_forward_list(const concurrent_forward_list&) = delete;
+    concurrent_forward_list& operator=(const concurrent_forward_list&) = delete;
+
+    /**
+     * @brief Frees all nodes. No other thread may access the list anymore.
+     */
+    ~concurrent_forward_list()
+    {
+        node* n = to_node(m_head.load(std::memory_order_relaxed));
+        while (n) {
+            node* next = to_node(n->next.load(std::memory_order_relaxed));
+            delete n;
+            n = next;
+        }
+    }
+
+    size_type size() const noexcept { return m_size.load(std::memory_order_relaxed); }
+    bool empty() const { return begin() == end(); }
+
+    /**
+     * @brief Returns an iterator to the smallest element. It must be
+     * compared with end() on the thread that created it.
+     */
+    const_iterator begin() const
+    {
+        // The guard of the iterator is constructed before the head is read
+        const_iterator it;
+        it.m_node = to_node(m_head.load(std::memory_order_acquire));
+        it.skip_erased_aux();
+        return it;
+    }
+
+    const_iterator cbegin() const { return begin(); }
+    const_iterator end() const { return const_iterator(); }
+    const_iterator cend() const { return end(); }
+
+    /**
+     * @brief Inserts %value unless an equivalent element is present.
+     * @return Whether %value was inserted.
+     */
+    bool insert(const T& value) { return emplace(value); }
+    bool insert(T&& value) { return emplace(std::move(value)); }
+
+    template<typename... Args>
+    bool emplace(Args&&... args)
+    {
+        epoch_reclaimer::guard guard;
+        node* n = new node(std::forward<Args>(args)...);
+        return emplace_aux(n->value, n);
+    }
+
+    /**
+     * @brief Erases the element equivalent to %key, if any.
+     * @return Whether this call erased it. Of several threads erasing the
+     * same element, exactly one succeeds.
+     */
+    template<typename K = T>
+    bool erase(const K& key)
+    {
+        epoch_reclaimer::guard guard;
+        while (true) {
+            position pos = search_aux(key);
+            if (!pos.found)
+                return false;
+            link next = pos.curr->next.load(std::memory_order_acquire);
+            if (is_marked(next))
+                continue;
+            // Marking the node is the linearization point of the erasure
+            if (!pos.curr->next.compare_exchange_weak(
+                  next, next | mark_bit, std::memory_order_acq_rel, std::memory_order_relaxed))
+                continue;
+            m_size.fetch_sub(1, std::memory_order_relaxed);
+
+            link expected = to_link(pos.curr);
+            if (pos.prev->compare_exchange_strong(expected, next, std::memory_order_acq_rel))
+                epoch_reclaimer::retire(pos.curr);
+            else
+                search_aux(key);
+            return true;
+        }
+    }
+
+    /**
+     * @brief Returns whether an element equivalent to %key is present. It only
+     * reads the list: it never writes to shared memory but the guard.
+     */
+    template<typename K = T>
+    bool contains(const K& key) const
+    {
+        epoch_reclaimer::guard guard;
+        node* curr = to_node(m_head.load(std::memory_order_acquire));
+        while (curr && m_comp(curr->value, key))
+            curr = to_node(curr->next.load(std::memory_order_acquire));
+        return curr && !m_comp(key, curr->value) &&
+               !is_marked(curr->next.load(std::memory_order_acquire));
+    }
+
+    /**
+     * @brief Calls %f on every element, in order, with the thread pinned once
+     * for the whole walk.
+     */
+    template<typename F>
+    void for_each(F f) const
+    {
+        for (const T& value : *this)
+            f(value);
+    }
+};
+
+} // namespace dev
@@ -0,0 +1,433 @@
+#pragma once
+
+#include "vector/vector.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include <utility>
+
+namespace dev {
+
+/**
+ * @brief A hash map for lookup tables shared by many threads, with one
+ * reader-writer lock per stripe instead of one for the whole table.
+ *
+ * The table is split into Stripes independent stripes, selected by the high
+ * bits of the hash. Each stripe has its own bucket array and
+ * %std::shared_mutex, so threads working on different stripes never contend,
+ * and lookups only take the stripe lock in shared mode: readers never block
+ * each other. Each stripe is aligned to a cache line, so that locking one
+ * stripe does not invalidate the lock of its neighbour.
+ *
+ * A stripe grows by doubling its bucket array once it holds more entries than
+ * buckets, and the entries are migrated incrementally: every write to the
+ * stripe, from whichever thread, first moves a few buckets from the old array
+ * to the new one. No single write rehashes the whole stripe, so the worst-case
+ * time a writer holds the lock stays small. Lookups check the old array for
+ * buckets that have not been migrated yet.
+ *
+ * References to the values are never handed out, since another thread may
+ * erase the entry at any time. Lookups return a copy, and visit() and update()
+ * run a function on the value while the stripe is locked.
+ */
+template<typename Key,
+         typename T,
+         typename Hash = std::hash<Key>,
+         typename KeyEqual = std::equal_to<Key>,
+         std::size_t Stripes = 64>
+class concurrent_hash_map
+{
+    static_assert(std::has_single_bit(Stripes), "Stripes must be a power of two");
+
+  public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+  private:
+    struct node
+    {
+        value_type value;
+        std::uint64_t hash;
+        node* next;
+    };
+
+    static constexpr size_type min_buckets = 8;
+
+    // Buckets moved from the old array by every write while a stripe grows
+    static constexpr size_type migration_step = 8;
+
+    static constexpr int stripe_bits = std::countr_zero(Stripes);
+
+    struct alignas(64) stripe
+    {
+        mutable std::shared_mutex mutex;
+        vector<node*> buckets;
+
+        // The bucket array being migrated away from. Buckets [0, migrated) of
+        // it are empty, their entries are in %buckets.
+        vector<node*> old_buckets;
+        size_type migrated{ 0 };
+
+        // Written under the lock, read without it by size()
+        std::atomic<size_type> size{ 0 };
+    };
+
+    std::array<stripe, Stripes> m_stripes;
+    [[no_unique_address]] hasher m_hash;
+    [[no_unique_address]] key_equal m_equal;
+
+    /**
+     * @brief Hashes %key and mixes the bits, so that both the stripe (high bits)
+     * and the bucket (low bits) depend on the whole key.
+     */
+    std::uint64_t hash_aux(const Key& key) const
+    {
+        auto h = static_cast<std::uint64_t>(m_hash(key)) * 0x9e3779b97f4a7c15ull;
+        return h ^ (h >> 29);
+    }
+
+    stripe& stripe_for(std::uint64_t hash)
+    {
+        if constexpr (stripe_bits == 0)
+            return m_stripes[0];
+        else
+            return m_stripes[hash >> (64 - stripe_bits)];
+    }
+
+    const stripe& stripe_for(std::uint64_t hash) const
+    {
+        return const_cast<concurrent_hash_map*>(this)->stripe_for(hash);
+    }
+
+    /**
+     * @brief Returns the head of the chain that holds, or would hold, an entry
+     * with %hash: in the old array if its bucket has not been migrated yet.
+     * The stripe must be locked, and must have buckets.
+     */
+    static node*& head_aux(stripe& s, std::uint64_t hash)
+    {
+        if (!s.old_buckets.empty()) {
+            size_type j = hash & (s.old_buckets.size() - 1);
+            if (j >= s.migrated)
+                return s.old_buckets[j];
+        }
+        return s.buckets[hash & (s.buckets.size() - 1)];
+    }
+
+    node* find_aux(const stripe& s, const Key& key, std::uint64_t hash) const
+    {
+        if (s.buckets.empty())
+            return nullptr;
+        for (node* p = head_aux(const_cast<stripe&>(s), hash); p; p = p->next) {
+            if (p->hash == hash && m_equal(p->value.first, key))
+                return p;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Moves the entries of up to %count old buckets into the new array.
+     * Nodes are relinked, not copied. The stripe must be locked exclusively.
+     */
+    static void migrate_aux(stripe& s, size_type count) noexcept
+    {
+        size_type last = std::min(s.old_buckets.size(), s.migrated + count);
+        size_type mask = s.buckets.size() - 1;
+        for (; s.migrated < last; ++s.migrated) {
+            node* p = std::exchange(s.old_buckets[s.migrated], nullptr);
+            while (p) {
+                node* next = p->next;
+                node*& head = s.buckets[p->hash & mask];
+                p->next = head;
+                head = p;
+                p = next;
+            }
+        }
+        if (s.migrated == s.old_buckets.size()) {
+            vector<node*>().swap(s.old_buckets);
+            s.migrated = 0;
+        }
+    }
+
+    /**
+     * @brief Switches the stripe to a bucket array of %new_count buckets. The
+     * entries stay in the old array until they are migrated.
+     */
+    static void grow_aux(stripe& s, size_type new_count)
+    {
+        migrate_aux(s, s.old_buckets.size());
+        vector<node*> buckets(new_count, nullptr);
+        if (s.buckets.empty()) {
+            s.buckets.swap(buckets);
+            return;
+        }
+        s.old_buckets.swap(s.buckets);
+        s.buckets.swap(buckets);
+        s.migrated = 0;
+    }
+
+    /**
+     * @brief Does the share of migration work of a write to the stripe, and
+     * allocates the first buckets. The stripe must be locked exclusively.
+     */
+    static void prepare_write_aux(stripe& s)
+    {
+        if (!s.old_buckets.empty())
+            migrate_aux(s, migration_step);
+        else if (s.buckets.empty())
+            grow_aux(s, min_buckets);
+    }
+
+    /**
+     * @brief Inserts a node constructed from %key and %args at the head of its
+     * chain, and starts growing the stripe if it is full.
+     */
+    template<typename K, typename... Args>
+    void insert_node_aux(stripe& s, std::uint64_t hash, K&& key, Args&&... args)
+    {
+        node*& head = head_aux(s, hash);
+        head = new node{ value_type(std::piecewise_construct,
+                                    std::forward_as_tuple(std::forward<K>(key)),
+                                    std::forward_as_tuple(std::forward<Args>(args)...)),
+                         hash,
+                         head };
+        size_type size = s.size.load(std::memory_order_relaxed) + 1;
+        s.size.store(size, std::memory_order_relaxed);
+        if (size > s.buckets.size())
+            grow_aux(s, 2 * s.buckets.size());
+    }
+
+    static void destroy_chains_aux(vector<node*>& buckets) noexcept
+    {
+        for (node*& head : buckets) {
+            for (node* p = std::exchange(head, nullptr); p;)
+                delete std::exchange(p, p->next);
+        }
+    }
+
+  public:
+    // Constructors
+    /**
+     * @brief Creates an empty concurrent_hash_map. Buckets are allocated on the
+     * first insertion into each stripe.
+     */
+    concurrent_hash_map() = default;
+
+    concurrent_hash_map(const concurrent_hash_map&) = delete;
+    concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+
+    ~concurrent_hash_map()
+    {
+        for (auto& s : m_stripes) {
+            destroy_chains_aux(s.buckets);
+            destroy_chains_aux(s.old_buckets);
+        }
+    }
+
+    // Capacity related member functions
+    /**
+     * @brief Returns the number of entries. With concurrent writers the result
+     * is only a snapshot, and may be off by the writes in flight.
+     */
+    [[nodiscard]] size_type size() const
+    {
+        size_type total = 0;
+        for (const auto& s : m_stripes)
+            total += s.size.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    /**
+     * @brief Sizes every stripe for %n entries in total, so that inserting them
+     * does not grow the stripes. Unlike growth through insertion, this rehashes
+     * each stripe at once.
+     */
+    void reserve(size_type n)
+    {
+        size_type per_stripe = std::bit_ceil(std::max(n / Stripes, min_buckets));
+        for (auto& s : m_stripes) {
+            std::unique_lock lock(s.mutex);
+            if (s.buckets.size() >= per_stripe)
+                continue;
+            grow_aux(s, per_stripe);
+            migrate_aux(s, s.old_buckets.size());
+        }
+    }
+
+    // Lookup
+    /**
+     * @brief Returns a copy of the value mapped to %key, or std::nullopt.
+     */
+    std::optional<T> find(const Key& key) const
+    {
+        auto hash = hash_aux(key);
+        const stripe& s = stripe_for(hash);
+        std::shared_lock lock(s.mutex);
+        if (node* p = find_aux(s, key, hash))
+            return p->value.second;
+        return std::nullopt;
+    }
+
+    [[nodiscard]] bool contains(const Key& key) const
+    {
+        auto hash = hash_aux(key);
+        const stripe& s = stripe_for(hash);
+        std::shared_lock lock(s.mutex);
+        return find_aux(s, key, hash) != nullptr;
+    }
+
+    /**
+     * @brief Calls %f with the value mapped to %key, while holding the stripe lock
+     * in shared mode. %f must not call back into the map.
+     * @return Whether %key was found.
+     */
+    template<typename F>
+    bool visit(const Key& key, F&& f) const
+    {
+        auto hash = hash_aux(key);
+        const stripe& s = stripe_for(hash);
+        std::shared_lock lock(s.mutex);
+        node* p = find_aux(s, key, hash);
+        if (!p)
+            return false;
+        std::invoke(std::forward<F>(f), std::as_const(p->value.second));
+        return true;
+    }
+
+    /**
+     * @brief Calls %f with every entry, one stripe at a time. Each stripe is
+     * locked in shared mode while it is visited, so the entries of a stripe are
+     * consistent, but the map as a whole is not a snapshot.
+     */
+    template<typename F>
+    void for_each(F f) const
+    {
+        for (const auto& s : m_stripes) {
+            std::shared_lock lock(s.mutex);
+            for (const auto* buckets : { &s.old_buckets, &s.buckets }) {
+                for (node* head : *buckets) {
+                    for (node* p = head; p; p = p->next)
+                        f(std::as_const(p->value));
+                }
+            }
+        }
+    }
+
+    // Modifiers
+    /**
+     * @brief Inserts %value for %key if %key is not present.
+     * @return Whether the entry was inserted.
+     */
+    template<typename... Args>
+    bool try_emplace(const Key& key, Args&&... args)
+    {
+        auto hash = hash_aux(key);
+        stripe& s = stripe_for(hash);
+        std::unique_lock lock(s.mutex);
+        prepare_write_aux(s);
+        if (find_aux(s, key, hash))
+            return false;
+        insert_node_aux(s, hash, key, std::forward<Args>(args)...);
+        return true;
+    }
+
+    bool insert(const Key& key, const T& value) { return try_emplace(key, value); }
+    bool insert(const Key& key, T&& value) { return try_emplace(key, std::move(value)); }
+
+    /**
+     * @brief Maps %key to %value, whether or not it was present.
+     * @return Whether a new entry was inserted.
+     */
+    template<typename M>
+    bool insert_or_assign(const Key& key, M&& value)
+    {
+        auto hash = hash_aux(key);
+        stripe& s = stripe_for(hash);
+        std::unique_lock lock(s.mutex);
+        prepare_write_aux(s);
+        if (node* p = find_aux(s, key, hash)) {
+            p->value.second = std::forward<M>(value);
+            return false;
+        }
+        insert_node_aux(s, hash, key, std::forward<M>(value));
+        return true;
+    }
+
+    /**
+     * @brief Calls %f with a reference to the value mapped to %key, while holding
+     * the stripe lock exclusively, e.g. to update a position atomically. %f must
+     * not call back into the map.
+     * @return Whether %key was found.
+     */
+    template<typename F>
+    bool update(const Key& key, F&& f)
+    {
+        auto hash = hash_aux(key);
+        stripe& s = stripe_for(hash);
+        std::unique_lock lock(s.mutex);
+        prepare_write_aux(s);
+        node* p = find_aux(s, key, hash);
+        if (!p)
+            return false;
+        std::invoke(std::forward<F>(f), p->value.second);
+        return true;
+    }
+
+    /**
+     * @brief Removes the entry with key %key if present.
+     * @return Whether an entry was removed.
+     */
+    bool erase(const Key& key)
+    {
+        auto hash = hash_aux(key);
+        stripe& s = stripe_for(hash);
+        std::unique_lock lock(s.mutex);
+        prepare_write_aux(s);
+        for (node** link = &head_aux(s, hash); *link; link = &(*link)->next) {
+            node* p = *link;
+            if (p->hash == hash && m_equal(p->value.first, key)) {
+                *link = p->next;
+                delete p;
+                s.size.store(s.size.load(std::memory_order_relaxed) - 1,
+                             std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Removes all entries, one stripe at a time. The buckets are kept.
+     */
+    void clear()
+    {
+        for (auto& s : m_stripes) {
+            std::unique_lock lock(s.mutex);
+            destroy_chains_aux(s.buckets);
+            destroy_chains_aux(s.old_buckets);
+            vector<node*>().swap(s.old_buckets);
+            s.migrated = 0;
+            s.size.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    hasher hash_function() const { return m_hash; }
+    key_equal key_eq() const { return m_equal; }
+};
+
+} // namespace dev
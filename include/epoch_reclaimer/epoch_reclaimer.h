@@ -0,0 +1,303 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace dev {
+
+/**
+ * @brief Epoch-based memory reclamation for lock-free data structures.
+ *
+ * A thread that reads shared nodes pins itself with a guard for the duration
+ * of the operation. A thread that unlinks a node does not free it, but
+ * retires it: the node is freed once every thread that was pinned when it was
+ * retired has unpinned, so no reader can still hold a pointer to it.
+ *
+ * A global epoch counter advances once every pinned thread has seen its
+ * current value. A node retired during epoch e can no longer be reached by any
+ * thread once the epoch has reached e + 2. Every thread keeps its retired
+ * nodes in three bags, one per epoch modulo 3, and frees a bag when it is two
+ * epochs old.
+ *
+ *     dev::epoch_reclaimer::guard guard;
+ *     node* n = head.load(std::memory_order_acquire);
+ *     ...
+ *     dev::epoch_reclaimer::retire(unlinked);
+ *
+ * Pinning and unpinning are a couple of atomic stores to a cache line owned
+ * by the thread, and guards nest. Readers never wait for anybody, but a thread
+ * that stays pinned forever stops all reclamation, so guards should only cover
+ * a single operation. The nodes retired by an exiting thread are handed over
+ * to the threads that carry on.
+ */
+class epoch_reclaimer
+{
+  public:
+    /**
+     * @brief The number of retirements after which a thread tries to advance
+     * the epoch and free its old bags.
+     */
+    static constexpr std::size_t collect_threshold = 64;
+
+    /**
+     * @brief Keeps the calling thread pinned while it lives. A guard must be
+     * destroyed on the thread that created it.
+     * @throws std::bad_alloc if it is the first guard of the thread and its
+     * record cannot be allocated.
+     */
+    class guard
+    {
+      public:
+        guard() { enter_aux(); }
+        guard(const guard&) { enter_aux(); }
+        guard& operator=(const guard&) noexcept { return *this; }
+        ~guard() { leave_aux(); }
+    };
+
+  private:
+    struct retired
+    {
+        void* pointer;
+        void (*deleter)(void*);
+    };
+
+    struct bag
+    {
+        std::uint64_t epoch{ 0 };
+        std::vector<retired> items;
+    };
+
+    /**
+     * @brief The announcement of a thread, and the nodes it has retired.
+     * Records are never freed; the record of an exited thread is reused by
+     * the next thread that starts.
+     */
+    struct alignas(64) record
+    {
+        // 0 when unpinned, otherwise 2 * epoch + 1
+        std::atomic<std::uint64_t> state{ 0 };
+        std::atomic<bool> in_use{ false };
+        record* next{ nullptr };
+
+        // Only accessed by the owning thread
+        std::size_t depth{ 0 };
+        std::size_t retired_since_collect{ 0 };
+        bag bags[3];
+    };
+
+    struct shared_state
+    {
+        std::atomic<std::uint64_t> epoch{ 0 };
+        std::atomic<record*> records{ nullptr };
+
+        // Bags of exited threads, freed by whoever reclaims next
+        std::mutex orphans_mutex;
+        std::vector<bag> orphans;
+    };
+
+    static shared_state& shared() noexcept
+    {
+        static shared_state* state = new shared_state;
+        return *state;
+    }
+
+    static record*& local_slot() noexcept
+    {
+        thread_local record* slot = nullptr;
+        return slot;
+    }
+
+    /**
+     * @brief Hands the record of an exiting thread back, with its bags.
+     */
+    struct release_guard
+    {
+        ~release_guard()
+        {
+            record*& r = local_slot();
+            if (!r)
+                return;
+            shared_state& s = shared();
+            {
+                std::lock_guard lock(s.orphans_mutex);
+                for (bag& b : r->bags) {
+                    if (!b.items.empty())
+                        s.orphans.push_back(std::exchange(b, bag{}));
+                }
+            }
+            r->state.store(0, std::memory_order_release);
+            r->depth = 0;
+            r->retired_since_collect = 0;
+            r->in_use.store(false, std::memory_order_release);
+            r = nullptr;
+        }
+    };
+
+    static record* acquire_record_aux()
+    {
+        shared_state& s = shared();
+        for (record* r = s.records.load(std::memory_order_acquire); r; r = r->next) {
+            bool expected = false;
+            if (!r->in_use.load(std::memory_order_relaxed) &&
+                r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                return r;
+        }
+        auto* r = new record;
+        r->in_use.store(true, std::memory_order_relaxed);
+        r->next = s.records.load(std::memory_order_relaxed);
+        while (!s.records.compare_exchange_weak(
+          r->next, r, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+        return r;
+    }
+
+    static record& local()
+    {
+        record*& r = local_slot();
+        if (!r) [[unlikely]] {
+            static thread_local release_guard release;
+            (void)release;
+            r = acquire_record_aux();
+        }
+        return *r;
+    }
+
+    static void enter_aux()
+    {
+        record& r = local();
+        if (r.depth++ != 0)
+            return;
+        shared_state& s = shared();
+        std::uint64_t e = s.epoch.load(std::memory_order_relaxed);
+        while (true) {
+            r.state.store(2 * e + 1, std::memory_order_seq_cst);
+            // Announce an epoch that is still current, so that the epoch can
+            // not move two steps past it while the thread is pinned
+            std::uint64_t current = s.epoch.load(std::memory_order_seq_cst);
+            if (current == e)
+                return;
+            e = current;
+        }
+    }
+
+    static void leave_aux() noexcept
+    {
+        record& r = local();
+        if (--r.depth == 0)
+            r.state.store(0, std::memory_order_release);
+    }
+
+    static void free_bag_aux(bag& b)
+    {
+        // Deleters may retire more nodes, so run them on a detached list
+        std::vector<retired> items = std::exchange(b.items, {});
+        for (const retired& item : items)
+            item.deleter(item.pointer);
+    }
+
+    /**
+     * @brief Advances the epoch if every pinned thread has announced the
+     * current one.
+     */
+    static void try_advance_aux() noexcept
+    {
+        shared_state& s = shared();
+        std::uint64_t e = s.epoch.load(std::memory_order_seq_cst);
+        for (record* r = s.records.load(std::memory_order_acquire); r; r = r->next) {
+            if (!r->in_use.load(std::memory_order_acquire))
+                continue;
+            std::uint64_t state = r->state.load(std::memory_order_seq_cst);
+            if ((state & 1) && (state >> 1) != e)
+                return;
+        }
+        s.epoch.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+    }
+
+  public:
+    /**
+     * @brief Returns the current global epoch.
+     */
+    static std::uint64_t epoch() noexcept
+    {
+        return shared().epoch.load(std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Returns whether the calling thread is pinned.
+     */
+    static bool is_pinned() noexcept
+    {
+        record* r = local_slot();
+        return r && r->depth != 0;
+    }
+
+    /**
+     * @brief Schedules %pointer to be passed to %deleter once no thread can
+     * hold it anymore. It must already be unreachable from the shared data.
+     */
+    static void retire(void* pointer, void (*deleter)(void*))
+    {
+        record& r = local();
+        std::uint64_t e = shared().epoch.load(std::memory_order_seq_cst);
+        bag& b = r.bags[e % 3];
+        if (b.epoch != e) {
+            // The bag holds nodes retired three epochs ago or earlier
+            free_bag_aux(b);
+            b.epoch = e;
+        }
+        b.items.push_back({ pointer, deleter });
+        if (++r.retired_since_collect >= collect_threshold) {
+            r.retired_since_collect = 0;
+            try_reclaim();
+        }
+    }
+
+    /**
+     * @brief Schedules %pointer to be deleted once no thread can hold it
+     * anymore.
+     */
+    template<typename T>
+    static void retire(T* pointer)
+    {
+        retire(static_cast<void*>(pointer), [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    /**
+     * @brief Tries to advance the epoch, then frees the bags of the calling
+     * thread, and of exited threads, that have become safe to free.
+     */
+    static void try_reclaim()
+    {
+        try_advance_aux();
+        shared_state& s = shared();
+        const std::uint64_t e = s.epoch.load(std::memory_order_seq_cst);
+        for (bag& b : local().bags) {
+            if (!b.items.empty() && b.epoch + 2 <= e)
+                free_bag_aux(b);
+        }
+
+        std::vector<bag> ready;
+        {
+            std::unique_lock lock(s.orphans_mutex, std::try_to_lock);
+            if (!lock.owns_lock() || s.orphans.empty())
+                return;
+            auto it = s.orphans.begin();
+            while (it != s.orphans.end()) {
+                if (it->epoch + 2 <= e) {
+                    ready.push_back(std::move(*it));
+                    it = s.orphans.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        for (bag& b : ready)
+            free_bag_aux(b);
+    }
+};
+
+} // namespace dev
@@ -0,0 +1,313 @@
+#pragma once
+
+#include "execution/policy.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Execution policies for the parallel overloads of the dev containers,
+ * and the thread pool that runs them.
+ *
+ *     dev::vector<double> copy(dev::execution::par, prices);
+ *     copy.assign(dev::execution::par.with_threads(4), n, 0.0);
+ *
+ * Parallel overloads split the destination into page-aligned chunks, and every
+ * chunk is constructed by a single pool thread. Since a page is physically
+ * allocated on the NUMA node of the thread that first writes to it, the pages of
+ * a freshly allocated block end up spread over the nodes of the threads that
+ * will typically process them later, instead of all on the node of the calling
+ * thread.
+ */
+namespace dev::execution {
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy par{};
+
+/**
+ * @brief Inputs smaller than this are processed on the calling thread: waking up
+ * the pool costs more than it saves.
+ */
+inline constexpr std::size_t parallel_threshold_bytes = std::size_t{ 1 } << 20;
+
+/**
+ * @brief Returns the size of a virtual memory page.
+ */
+inline std::size_t page_size() noexcept
+{
+#if defined(__unix__) || defined(__APPLE__)
+    static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+#else
+    return 4096;
+#endif
+}
+
+/**
+ * @brief A fixed set of worker threads that run one batch of tasks at a time.
+ *
+ * run() hands out task indices from an atomic counter to the workers and to
+ * the calling thread, and returns once all tasks are done. Batches submitted
+ * from several threads are serialized. A batch submitted from inside a task runs
+ * on the calling thread, so nested parallel calls do not deadlock.
+ */
+class thread_pool
+{
+  private:
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_run_mutex; // serializes batches
+    std::mutex m_mutex;
+    std::condition_variable m_work_cv;
+    std::condition_variable m_done_cv;
+    bool m_stop{ false };
+    std::uint64_t m_generation{ 0 };
+
+    // The current batch
+    const std::function<void(std::size_t)>* m_task{ nullptr };
+    std::size_t m_num_tasks{ 0 };
+    unsigned m_num_helpers{ 0 };
+    unsigned m_helpers_running{ 0 };
+    std::atomic<std::size_t> m_next_task{ 0 };
+    std::atomic<bool> m_failed{ false };
+    std::exception_ptr m_exception;
+
+    static bool& in_task_aux() noexcept
+    {
+        thread_local bool in_task = false;
+        return in_task;
+    }
+
+    /**
+     * @brief Runs tasks of the current batch until there are none left. After a
+     * task has thrown, the remaining tasks are skipped.
+     */
+    void drain_aux()
+    {
+        in_task_aux() = true;
+        for (std::size_t i = m_next_task++; i < m_num_tasks; i = m_next_task++) {
+            if (m_failed.load(std::memory_order_relaxed))
+                continue;
+            try {
+                (*m_task)(i);
+            } catch (...) {
+                std::lock_guard lock(m_mutex);
+                if (!m_exception)
+                    m_exception = std::current_exception();
+                m_failed = true;
+            }
+        }
+        in_task_aux() = false;
+    }
+
+    void worker_loop_aux(unsigned index)
+    {
+        std::uint64_t seen{ 0 };
+        std::unique_lock lock(m_mutex);
+        while (true) {
+            m_work_cv.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop)
+                return;
+            seen = m_generation;
+            if (index >= m_num_helpers)
+                continue;
+
+            lock.unlock();
+            drain_aux();
+            lock.lock();
+            if (--m_helpers_running == 0)
+                m_done_cv.notify_one();
+        }
+    }
+
+  public:
+    /**
+     * @brief Starts %num_workers worker threads. The thread calling run() takes
+     * part in the work as well.
+     */
+    explicit thread_pool(unsigned num_workers)
+    {
+        m_workers.reserve(num_workers);
+        for (unsigned i = 0; i < num_workers; ++i)
+            m_workers.emplace_back([this, i] { worker_loop_aux(i); });
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    ~thread_pool()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stop = true;
+        }
+        m_work_cv.notify_all();
+        for (auto& worker : m_workers)
+            worker.join();
+    }
+
+    /**
+     * @brief The pool used by the parallel overloads: one thread per hardware
+     * thread, counting the caller.
+     */
+    static thread_pool& shared()
+    {
+        static thread_pool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+        return pool;
+    }
+
+    /**
+     * @brief Returns the number of threads that can work on a batch, including
+     * the calling thread.
+     */
+    [[nodiscard]] unsigned concurrency() const
+    {
+        return static_cast<unsigned>(m_workers.size()) + 1;
+    }
+
+    /**
+     * @brief Calls %task(i) for every i in [0, num_tasks) on at most
+     * %max_threads threads (0 means all), and waits for all of them.
+     * @throws The first exception thrown by a task, once all running tasks have
+     * finished. Tasks that had not started yet are skipped.
+     */
+    void run(std::size_t num_tasks,
+             unsigned max_threads,
+             const std::function<void(std::size_t)>& task)
+    {
+        if (num_tasks == 0)
+            return;
+        if (max_threads == 0)
+            max_threads = concurrency();
+        unsigned num_helpers = static_cast<unsigned>(
+          std::min<std::size_t>({ m_workers.size(), max_threads - 1, num_tasks - 1 }));
+        if (num_helpers == 0 || in_task_aux()) {
+            for (std::size_t i = 0; i < num_tasks; ++i)
+                task(i);
+            return;
+        }
+
+        std::lock_guard run_lock(m_run_mutex);
+        {
+            std::lock_guard lock(m_mutex);
+            m_task = &task;
+            m_num_tasks = num_tasks;
+            m_num_helpers = num_helpers;
+            m_helpers_running = num_helpers;
+            m_next_task = 0;
+            m_failed = false;
+            m_exception = nullptr;
+            ++m_generation;
+        }
+        m_work_cv.notify_all();
+
+        drain_aux();
+
+        std::unique_lock lock(m_mutex);
+        m_done_cv.wait(lock, [this] { return m_helpers_running == 0; });
+        m_task = nullptr;
+        if (m_exception)
+            std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+};
+
+/**
+ * @brief Splits the %n elements at %first into chunks whose boundaries fall on
+ * page boundaries, so that no page is written by two threads. Chunk k is the
+ * element range [begin(k), begin(k + 1)); the last chunk may be empty.
+ */
+template<typename T>
+class page_chunks
+{
+  private:
+    std::uintptr_t m_address;
+    std::size_t m_size;
+    std::size_t m_chunk_bytes;
+    std::size_t m_count;
+
+  public:
+    page_chunks(const T* first, std::size_t n, unsigned num_threads)
+      : m_address{ reinterpret_cast<std::uintptr_t>(first) }
+      , m_size{ n }
+    {
+        // A few chunks per thread balance the load; a chunk is never smaller
+        // than 16 pages.
+        std::size_t page = page_size();
+        std::size_t bytes = n * sizeof(T);
+        std::size_t chunk = bytes / (4 * std::max(num_threads, 1u));
+        m_chunk_bytes = std::max((chunk + page - 1) / page, std::size_t{ 16 }) * page;
+        m_count = bytes / m_chunk_bytes + 1;
+    }
+
+    [[nodiscard]] std::size_t count() const { return m_count; }
+
+    /**
+     * @brief Index of the first element of chunk %k: the first element that
+     * starts at or after the k-th page-aligned boundary.
+     */
+    [[nodiscard]] std::size_t begin(std::size_t k) const
+    {
+        if (k == 0)
+            return 0;
+        if (k >= m_count)
+            return m_size;
+        std::size_t page = page_size();
+        std::uintptr_t boundary = m_address + k * m_chunk_bytes;
+        boundary = (boundary + page - 1) / page * page;
+        std::size_t index = (boundary - m_address + sizeof(T) - 1) / sizeof(T);
+        return std::min(index, m_size);
+    }
+};
+
+/**
+ * @brief Calls %f(i, j) for page-aligned chunks [i, j) that together cover the %n
+ * elements at %first, in parallel on the shared thread pool. Small inputs are
+ * processed with a single call on the calling thread.
+ *
+ * If %f throws, %on_error(i, j) is called for every chunk that did complete, and
+ * the exception is rethrown. Use it to destroy the elements constructed so far.
+ */
+template<typename T, typename F, typename OnError>
+void for_each_page_chunk(parallel_policy policy,
+                         const T* first,
+                         std::size_t n,
+                         F&& f,
+                         OnError&& on_error)
+{
+    auto& pool = thread_pool::shared();
+    unsigned num_threads = policy.max_threads ? policy.max_threads : pool.concurrency();
+    if (n * sizeof(T) < parallel_threshold_bytes || num_threads == 1) {
+        f(std::size_t{ 0 }, n);
+        return;
+    }
+
+    page_chunks<T> chunks(first, n, num_threads);
+    std::vector<char> done(chunks.count(), 0);
+    try {
+        pool.run(chunks.count(), num_threads, [&](std::size_t k) {
+            f(chunks.begin(k), chunks.begin(k + 1));
+            done[k] = 1;
+        });
+    } catch (...) {
+        for (std::size_t k = 0; k < chunks.count(); ++k) {
+            if (done[k])
+                on_error(chunks.begin(k), chunks.begin(k + 1));
+        }
+        throw;
+    }
+}
+
+} // namespace dev::execution
@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * @brief The execution policy types of the dev containers, without the thread
+ * pool that runs them, so that a container can declare its parallel overloads
+ * without every one of its users paying for <thread> and <mutex>.
+ *
+ * The policy objects dev::execution::seq and dev::execution::par, and the pool
+ * that the parallel overloads run on, are in "execution/execution.h": include
+ * it to call a parallel overload.
+ */
+namespace dev::execution {
+
+/**
+ * @brief Run on the calling thread. The same as the overload without a policy.
+ */
+struct sequenced_policy
+{};
+
+/**
+ * @brief Run on the shared thread pool, using at most %max_threads threads
+ * (including the calling thread). 0 means all threads of the pool.
+ */
+struct parallel_policy
+{
+    unsigned max_threads{ 0 };
+
+    [[nodiscard]] constexpr parallel_policy with_threads(unsigned n) const
+    {
+        return parallel_policy{ n };
+    }
+};
+
+} // namespace dev::execution
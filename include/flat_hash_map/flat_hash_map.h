@@ -0,0 +1,684 @@
+#pragma once
+
+#include "hardening/hardening.h"
+#include "vector/vector.h"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DEV_FLAT_HASH_MAP_SSE2 1
+#else
+#define DEV_FLAT_HASH_MAP_SSE2 0
+#endif
+
+namespace dev {
+
+namespace detail {
+
+/**
+ * @brief A control byte: ctrl_empty for an empty slot, or the low 7 bits of the
+ * hash (H2) of the key in a full slot.
+ */
+using ctrl_t = std::int8_t;
+
+inline constexpr ctrl_t ctrl_empty = -128;
+inline constexpr std::size_t group_width = 16;
+
+/**
+ * @brief Sixteen consecutive control bytes, compared against a byte at once.
+ * Every match function returns a bit mask with bit i set if byte i matches.
+ */
+class ctrl_group
+{
+  private:
+#if DEV_FLAT_HASH_MAP_SSE2
+    __m128i m_ctrl;
+#else
+    ctrl_t m_ctrl[group_width];
+#endif
+
+  public:
+    explicit ctrl_group(const ctrl_t* ctrl)
+    {
+#if DEV_FLAT_HASH_MAP_SSE2
+        m_ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+        std::memcpy(m_ctrl, ctrl, group_width);
+#endif
+    }
+
+    std::uint32_t match(ctrl_t h2) const
+    {
+#if DEV_FLAT_HASH_MAP_SSE2
+        return static_cast<std::uint32_t>(
+          _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl)));
+#else
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < group_width; ++i)
+            mask |= static_cast<std::uint32_t>(m_ctrl[i] == h2) << i;
+        return mask;
+#endif
+    }
+
+    /**
+     * @brief Full slots hold a non-negative H2, so the empty slots are exactly the
+     * bytes with the sign bit set.
+     */
+    std::uint32_t match_empty() const
+    {
+#if DEV_FLAT_HASH_MAP_SSE2
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(m_ctrl));
+#else
+        return match(ctrl_empty);
+#endif
+    }
+};
+
+/**
+ * @brief Selects the type of a lookup argument. A plain alias to K keeps K
+ * deducible from the argument, which %std::conditional_t would not.
+ */
+template<bool Transparent>
+struct key_arg_selector
+{
+    template<typename K, typename Key>
+    using type = K;
+};
+
+template<>
+struct key_arg_selector<false>
+{
+    template<typename K, typename Key>
+    using type = Key;
+};
+
+} // namespace detail
+
+/**
+ * @brief An open-addressing hash map in the style of Swiss tables, with its
+ * slots and control bytes in contiguous dev::vectors.
+ *
+ * Every slot has a control byte holding 7 bits of the hash of its key. A lookup
+ * loads the 16 control bytes starting at the home slot of the key and compares
+ * them all at once with SSE2. Only the slots whose byte matches are compared
+ * with the key, so a lookup usually touches one cache line of control bytes and
+ * one slot, instead of chasing a heap node per entry like %std::unordered_map.
+ *
+ * Probing is linear, 16 slots at a time, which allows deletion without
+ * tombstones: erase() shifts the following entries of the probe run back into
+ * the hole, so the table never fills up with deleted slots and never needs a
+ * rehash to clean them up. Erasing moves other entries, so it invalidates
+ * iterators and references; use erase_if() to erase while scanning.
+ *
+ * The table grows by doubling once it is 7/8 full. Key and T must be nothrow
+ * move constructible, since entries are relocated by growth and erase().
+ *
+ * Heterogeneous lookup is enabled when both Hash and KeyEqual have an
+ * is_transparent member type, as for the unordered containers.
+ */
+template<typename Key,
+         typename T,
+         typename Hash = std::hash<Key>,
+         typename KeyEqual = std::equal_to<Key>>
+    requires std::is_nothrow_move_constructible_v<Key> &&
+             std::is_nothrow_move_constructible_v<T>
+class flat_hash_map
+{
+  public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+  private:
+    using ctrl_t = detail::ctrl_t;
+
+    struct slot
+    {
+        alignas(value_type) unsigned char storage[sizeof(value_type)];
+    };
+
+    static constexpr bool is_transparent = requires {
+        typename Hash::is_transparent;
+        typename KeyEqual::is_transparent;
+    };
+
+    /**
+     * @brief The type of a lookup argument: any K with transparent functors,
+     * otherwise Key itself.
+     */
+    template<typename K>
+    using key_arg = typename detail::key_arg_selector<is_transparent>::template type<K, Key>;
+
+    static constexpr size_type min_capacity = 16;
+
+    // m_ctrl holds capacity + group_width - 1 bytes: the first group_width - 1
+    // bytes are mirrored at the end, so that a group can be loaded at any slot
+    // without wrapping around.
+    vector<ctrl_t> m_ctrl;
+    vector<slot> m_slots;
+    size_type m_size{ 0 };
+    [[no_unique_address]] hasher m_hash;
+    [[no_unique_address]] key_equal m_equal;
+
+    size_type capacity_mask() const { return m_slots.size() - 1; }
+
+    value_type* slot_aux(size_type i) const
+    {
+        return std::launder(reinterpret_cast<value_type*>(
+          const_cast<unsigned char*>(m_slots[i].storage)));
+    }
+
+    bool is_full_aux(size_type i) const { return m_ctrl[i] >= 0; }
+
+    void set_ctrl_aux(size_type i, ctrl_t h)
+    {
+        m_ctrl[i] = h;
+        if (i < detail::group_width - 1)
+            m_ctrl[m_slots.size() + i] = h;
+    }
+
+    /**
+     * @brief Hashes %key and mixes the bits, so that identity hashes such as
+     * std::hash<std::uint64_t> spread over both the home slot and H2.
+     */
+    template<typename K>
+    std::uint64_t hash_aux(const K& key) const
+    {
+        auto h = static_cast<std::uint64_t>(m_hash(key)) * 0x9e3779b97f4a7c15ull;
+        return h ^ (h >> 32);
+    }
+
+    static size_type h1(std::uint64_t hash) { return static_cast<size_type>(hash >> 7); }
+    static ctrl_t h2(std::uint64_t hash) { return static_cast<ctrl_t>(hash & 0x7f); }
+
+    /**
+     * @brief Returns the slot holding %key, or capacity() if there is none.
+     */
+    template<typename K>
+    size_type find_index_aux(const K& key, std::uint64_t hash) const
+    {
+        if (m_size == 0)
+            return capacity();
+        size_type mask = capacity_mask();
+        for (size_type pos = h1(hash) & mask;; pos = (pos + detail::group_width) & mask) {
+            detail::ctrl_group group(m_ctrl.data() + pos);
+            for (auto match = group.match(h2(hash)); match; match &= match - 1) {
+                size_type i = (pos + std::countr_zero(match)) & mask;
+                if (m_equal(slot_aux(i)->first, key)) [[likely]]
+                    return i;
+            }
+            if (group.match_empty())
+                return capacity();
+        }
+    }
+
+    /**
+     * @brief Returns the first empty slot of the probe run of %hash. The table
+     * must not be full.
+     */
+    size_type find_empty_aux(std::uint64_t hash) const
+    {
+        size_type mask = capacity_mask();
+        for (size_type pos = h1(hash) & mask;; pos = (pos + detail::group_width) & mask) {
+            auto empty = detail::ctrl_group(m_ctrl.data() + pos).match_empty();
+            if (empty)
+                return (pos + std::countr_zero(empty)) & mask;
+        }
+    }
+
+    /**
+     * @brief Move-constructs the entry of slot %from into the empty slot %to,
+     * and destroys the source.
+     */
+    void relocate_aux(size_type from, size_type to)
+    {
+        value_type* src = slot_aux(from);
+        // The key is const for users of the map, but the source entry is
+        // destroyed right away, so moving from it is safe.
+        std::construct_at(
+          slot_aux(to), std::move(const_cast<Key&>(src->first)), std::move(src->second));
+        std::destroy_at(src);
+    }
+
+    static size_type capacity_for(size_type n)
+    {
+        size_type capacity = min_capacity;
+        while (capacity - capacity / 8 < n)
+            capacity *= 2;
+        return capacity;
+    }
+
+    /**
+     * @brief Moves all entries into a table of %new_capacity slots.
+     */
+    void rehash_aux(size_type new_capacity)
+    {
+        vector<ctrl_t> ctrl(new_capacity + detail::group_width - 1, detail::ctrl_empty);
+        vector<slot> slots;
+        slots.resize_for_overwrite(new_capacity);
+
+        m_ctrl.swap(ctrl);
+        m_slots.swap(slots);
+        for (size_type i = 0; i < slots.size(); ++i) {
+            if (ctrl[i] < 0)
+                continue;
+            value_type* src = std::launder(reinterpret_cast<value_type*>(slots[i].storage));
+            auto hash = hash_aux(src->first);
+            size_type j = find_empty_aux(hash);
+            set_ctrl_aux(j, h2(hash));
+            std::construct_at(
+              slot_aux(j), std::move(const_cast<Key&>(src->first)), std::move(src->second));
+            std::destroy_at(src);
+        }
+    }
+
+    /**
+     * @brief Finds %key, or inserts an entry constructed from %key and %args.
+     * @return The slot of the entry, and whether it was inserted.
+     */
+    template<typename K, typename... Args>
+    std::pair<size_type, bool> try_emplace_aux(K&& key, Args&&... args)
+    {
+        auto hash = hash_aux(key);
+        size_type i = find_index_aux(key, hash);
+        if (i != capacity())
+            return { i, false };
+
+        if (m_size + 1 > capacity() - capacity() / 8)
+            rehash_aux(capacity_for(m_size + 1));
+        i = find_empty_aux(hash);
+        std::construct_at(slot_aux(i),
+                          std::piecewise_construct,
+                          std::forward_as_tuple(std::forward<K>(key)),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+        set_ctrl_aux(i, h2(hash));
+        ++m_size;
+        return { i, true };
+    }
+
+    /**
+     * @brief Destroys the entry in slot %i and closes the hole by shifting back
+     * the following entries of the probe run that may move closer to their
+     * home slot. The run stops at the first empty slot.
+     */
+    void erase_at_aux(size_type i)
+    {
+        std::destroy_at(slot_aux(i));
+        size_type mask = capacity_mask();
+        size_type hole = i;
+        for (size_type j = (i + 1) & mask; is_full_aux(j); j = (j + 1) & mask) {
+            size_type home = h1(hash_aux(slot_aux(j)->first)) & mask;
+            // The entry may fill the hole if the hole lies in [home, j)
+            if (((j - home) & mask) >= ((j - hole) & mask)) {
+                relocate_aux(j, hole);
+                set_ctrl_aux(hole, m_ctrl[j]);
+                hole = j;
+            }
+        }
+        set_ctrl_aux(hole, detail::ctrl_empty);
+        --m_size;
+    }
+
+    void destroy_all_aux() noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_type i = 0; i < capacity() && m_size; ++i) {
+                if (is_full_aux(i)) {
+                    std::destroy_at(slot_aux(i));
+                    --m_size;
+                }
+            }
+        }
+        m_size = 0;
+    }
+
+  public:
+    /**
+     * @brief Forward iterator over the entries, in slot order. It stores the
+     * container and a slot index.
+     */
+    template<bool Const>
+    class Iterator
+    {
+      public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = flat_hash_map::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+        using container_pointer =
+          std::conditional_t<Const, const flat_hash_map*, flat_hash_map*>;
+
+        Iterator() = default;
+
+        /**
+         * @brief Points to the first full slot at or after %index.
+         */
+        Iterator(container_pointer container, size_type index)
+          : m_container{ container }
+          , m_index{ index }
+        {
+            skip_empty_aux();
+        }
+
+        /**
+         * @brief Conversion from a read/write iterator to a read-only one.
+         */
+        template<bool OtherConst>
+            requires(Const && !OtherConst)
+        Iterator(const Iterator<OtherConst>& other)
+          : m_container{ other.m_container }
+          , m_index{ other.m_index }
+        {
+        }
+
+        reference operator*() const { return *m_container->slot_aux(m_index); }
+        pointer operator->() const { return m_container->slot_aux(m_index); }
+
+        Iterator& operator++()
+        {
+            ++m_index;
+            skip_empty_aux();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs)
+        {
+            return lhs.m_index == rhs.m_index;
+        }
+
+      private:
+        friend flat_hash_map;
+        friend Iterator<true>;
+        container_pointer m_container{ nullptr };
+        size_type m_index{ 0 };
+
+        void skip_empty_aux()
+        {
+            while (m_index < m_container->capacity() && !m_container->is_full_aux(m_index))
+                ++m_index;
+        }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    // Constructors
+    /**
+     * @brief Creates an empty flat_hash_map. No memory is allocated until the
+     * first insertion.
+     */
+    flat_hash_map() = default;
+
+    explicit flat_hash_map(size_type bucket_count,
+                           const hasher& hash = hasher(),
+                           const key_equal& equal = key_equal())
+      : m_hash{ hash }
+      , m_equal{ equal }
+    {
+        reserve(bucket_count);
+    }
+
+    flat_hash_map(std::initializer_list<value_type> entries)
+      : flat_hash_map()
+    {
+        reserve(entries.size());
+        for (const auto& entry : entries)
+            insert(entry);
+    }
+
+    flat_hash_map(const flat_hash_map& other)
+      : flat_hash_map()
+    {
+        m_hash = other.m_hash;
+        m_equal = other.m_equal;
+        reserve(other.size());
+        for (const auto& entry : other)
+            insert(entry);
+    }
+
+    flat_hash_map(flat_hash_map&& other) noexcept
+      : m_ctrl{ std::move(other.m_ctrl) }
+      , m_slots{ std::move(other.m_slots) }
+      , m_size{ std::exchange(other.m_size, 0) }
+      , m_hash{ std::move(other.m_hash) }
+      , m_equal{ std::move(other.m_equal) }
+    {
+    }
+
+    flat_hash_map& operator=(const flat_hash_map& other)
+    {
+        if (this != &other)
+            flat_hash_map(other).swap(*this);
+        return *this;
+    }
+
+    flat_hash_map& operator=(flat_hash_map&& other) noexcept
+    {
+        flat_hash_map(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~flat_hash_map() { destroy_all_aux(); }
+
+    // Capacity related member functions
+    [[nodiscard]] size_type size() const { return m_size; }
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    /**
+     * @brief Returns the number of slots.
+     */
+    [[nodiscard]] size_type capacity() const { return m_slots.size(); }
+
+    [[nodiscard]] float load_factor() const
+    {
+        return capacity() ? static_cast<float>(m_size) / capacity() : 0.0f;
+    }
+
+    [[nodiscard]] static constexpr float max_load_factor() { return 0.875f; }
+
+    /**
+     * @brief Makes room for %n entries, so that inserting them does not rehash.
+     */
+    void reserve(size_type n)
+    {
+        if (n == 0)
+            return;
+        size_type new_capacity = capacity_for(n);
+        if (new_capacity > capacity())
+            rehash_aux(new_capacity);
+    }
+
+    // Iterators
+    iterator begin() { return iterator(this, 0); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return iterator(this, capacity()); }
+    const_iterator end() const { return const_iterator(this, capacity()); }
+    const_iterator cend() const { return end(); }
+
+    // Lookup
+    template<typename K = Key>
+    iterator find(const key_arg<K>& key)
+    {
+        return iterator(this, find_index_aux(key, hash_aux(key)));
+    }
+
+    template<typename K = Key>
+    const_iterator find(const key_arg<K>& key) const
+    {
+        return const_iterator(this, find_index_aux(key, hash_aux(key)));
+    }
+
+    template<typename K = Key>
+    [[nodiscard]] bool contains(const key_arg<K>& key) const
+    {
+        return find_index_aux(key, hash_aux(key)) != capacity();
+    }
+
+    template<typename K = Key>
+    [[nodiscard]] size_type count(const key_arg<K>& key) const
+    {
+        return contains<K>(key) ? 1 : 0;
+    }
+
+    /**
+     * @brief Returns the value mapped to %key.
+     * @throws std::out_of_range if %key is not present.
+     */
+    template<typename K = Key>
+    T& at(const key_arg<K>& key)
+    {
+        size_type i = find_index_aux(key, hash_aux(key));
+        if (i == capacity())
+            throw std::out_of_range("flat_hash_map: key not found");
+        return slot_aux(i)->second;
+    }
+
+    template<typename K = Key>
+    const T& at(const key_arg<K>& key) const
+    {
+        size_type i = find_index_aux(key, hash_aux(key));
+        if (i == capacity())
+            throw std::out_of_range("flat_hash_map: key not found");
+        return slot_aux(i)->second;
+    }
+
+    /**
+     * @brief Returns the value mapped to %key, inserting a value-initialized one
+     * first if %key is not present.
+     */
+    T& operator[](const Key& key) { return slot_aux(try_emplace_aux(key).first)->second; }
+    T& operator[](Key&& key) { return slot_aux(try_emplace_aux(std::move(key)).first)->second; }
+
+    // Modifiers
+    std::pair<iterator, bool> insert(const value_type& entry)
+    {
+        auto [i, inserted] = try_emplace_aux(entry.first, entry.second);
+        return { iterator(this, i), inserted };
+    }
+
+    std::pair<iterator, bool> insert(value_type&& entry)
+    {
+        auto [i, inserted] = try_emplace_aux(entry.first, std::move(entry.second));
+        return { iterator(this, i), inserted };
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+    {
+        auto [i, inserted] = try_emplace_aux(key, std::forward<Args>(args)...);
+        return { iterator(this, i), inserted };
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args)
+    {
+        auto [i, inserted] = try_emplace_aux(std::move(key), std::forward<Args>(args)...);
+        return { iterator(this, i), inserted };
+    }
+
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, M&& value)
+    {
+        auto [i, inserted] = try_emplace_aux(key, std::forward<M>(value));
+        if (!inserted)
+            slot_aux(i)->second = std::forward<M>(value);
+        return { iterator(this, i), inserted };
+    }
+
+    /**
+     * @brief Removes the entry with key %key if present. Other entries of its
+     * probe run may move, so iterators and references are invalidated.
+     * @return The number of removed entries (0 or 1).
+     */
+    template<typename K = Key>
+    size_type erase(const key_arg<K>& key)
+    {
+        size_type i = find_index_aux(key, hash_aux(key));
+        if (i == capacity())
+            return 0;
+        erase_at_aux(i);
+        return 1;
+    }
+
+    /**
+     * @brief Removes the entry at %position. Iterators and references are
+     * invalidated.
+     */
+    void erase(const_iterator position)
+    {
+        DEV_HARDENING_ASSERT(position.m_index < capacity() && is_full_aux(position.m_index),
+                             "flat_hash_map::erase() called with an invalid iterator");
+        erase_at_aux(position.m_index);
+    }
+
+    /**
+     * @brief Removes every entry for which %pred returns true.
+     * @return The number of removed entries.
+     */
+    template<typename Pred>
+    friend size_type erase_if(flat_hash_map& map, Pred pred)
+    {
+        // After an erase, slot i may hold an entry shifted back from later in
+        // its run, so it is tested again. Entries shifted back across the end
+        // of the table come from slots that were already tested.
+        size_type removed = 0;
+        for (size_type i = 0; i < map.capacity(); ++i) {
+            while (map.is_full_aux(i) && pred(std::as_const(*map.slot_aux(i)))) {
+                map.erase_at_aux(i);
+                ++removed;
+            }
+        }
+        return removed;
+    }
+
+    /**
+     * @brief Destroys all entries. The slots are kept for reuse.
+     */
+    void clear() noexcept
+    {
+        destroy_all_aux();
+        std::fill(m_ctrl.begin(), m_ctrl.end(), detail::ctrl_empty);
+    }
+
+    void swap(flat_hash_map& other) noexcept
+    {
+        m_ctrl.swap(other.m_ctrl);
+        m_slots.swap(other.m_slots);
+        std::swap(m_size, other.m_size);
+        std::swap(m_hash, other.m_hash);
+        std::swap(m_equal, other.m_equal);
+    }
+
+    hasher hash_function() const { return m_hash; }
+    key_equal key_eq() const { return m_equal; }
+};
+
+} // namespace dev
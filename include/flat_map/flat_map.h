@@ -0,0 +1,577 @@
+#pragma once
+
+#include "flat_set/flat_set.h"
+#include "vector/vector.h"
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace dev {
+
+/**
+ * @brief A sorted map stored in two contiguous dev::vectors, one for the keys and
+ * one for the mapped values, in the style of C++23 %std::flat_map.
+ *
+ * A lookup is a branchless binary search that only touches the key vector, and
+ * the value is fetched with a single indexed load once the key is found. Range
+ * scans walk both vectors linearly. Both are far more cache friendly than a
+ * node-based %std::map, at the cost of O(n) single-element insert and erase:
+ * build it with the constructors or insert_range(), which sort and merge in
+ * bulk.
+ *
+ * Like soa_vector, dereferencing an iterator yields a proxy
+ * %std::pair<const Key&, T&>:
+ *
+ *     for (auto [symbol, instrument] : instruments) ...
+ */
+template<typename Key, typename T, typename Compare = std::less<Key>>
+class flat_map
+{
+  public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using key_compare = Compare;
+    using reference = std::pair<const Key&, T&>;
+    using const_reference = std::pair<const Key&, const T&>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using key_container_type = vector<Key>;
+    using mapped_container_type = vector<T>;
+
+    /**
+     * @brief The two underlying vectors, as returned by extract().
+     */
+    struct containers
+    {
+        key_container_type keys;
+        mapped_container_type values;
+    };
+
+  private:
+    key_container_type m_keys;
+    mapped_container_type m_values;
+    [[no_unique_address]] key_compare m_compare;
+
+    bool equivalent_aux(const Key& lhs, const Key& rhs) const
+    {
+        return !m_compare(lhs, rhs) && !m_compare(rhs, lhs);
+    }
+
+    size_type lower_bound_index_aux(const Key& key) const
+    {
+        return detail::branchless_lower_bound(
+                 m_keys.begin(), m_keys.end(), key, m_compare) -
+               m_keys.begin();
+    }
+
+    size_type find_index_aux(const Key& key) const
+    {
+        size_type i = lower_bound_index_aux(key);
+        return i != size() && !m_compare(key, m_keys[i]) ? i : size();
+    }
+
+    /**
+     * @brief Sorts the entries [first, size()), drops the duplicate keys among
+     * them and merges them into the sorted entries [0, first). Where a key is
+     * already present, the existing entry is kept; among duplicates in the
+     * batch, the first one is kept.
+     *
+     * The entries are sorted through a permutation of indices, and both vectors
+     * are then rebuilt in a single pass, so every key and value is moved once.
+     */
+    void merge_tail_aux(size_type first, bool tail_sorted_unique)
+    {
+        size_type n = size();
+        if (first == n)
+            return;
+
+        auto key_less = [this](size_type a, size_type b) {
+            return m_compare(m_keys[a], m_keys[b]);
+        };
+
+        vector<size_type> batch;
+        batch.resize_for_overwrite(n - first);
+        std::iota(batch.begin(), batch.end(), first);
+        if (!tail_sorted_unique)
+            std::stable_sort(batch.begin(), batch.end(), key_less);
+
+        // A sorted, unique batch of keys that are all greater than the existing
+        // ones is already in place.
+        bool in_place = first == 0 || m_compare(m_keys[first - 1], m_keys[batch[0]]);
+        for (size_type i = 1; in_place && i < batch.size(); ++i)
+            in_place = batch[i] == batch[i - 1] + 1 && key_less(batch[i - 1], batch[i]);
+        if (in_place)
+            return;
+
+        // std::merge takes equivalent elements from the first range first, so
+        // the existing entry wins over a new one.
+        vector<size_type> order;
+        order.resize_for_overwrite(n);
+        auto existing = std::views::iota(size_type{ 0 }, first);
+        std::merge(existing.begin(),
+                   existing.end(),
+                   batch.begin(),
+                   batch.end(),
+                   order.begin(),
+                   key_less);
+
+        key_container_type keys;
+        mapped_container_type values;
+        keys.reserve(n);
+        values.reserve(n);
+        for (size_type i : order) {
+            if (!keys.empty() && equivalent_aux(keys.back(), m_keys[i]))
+                continue;
+            keys.push_back(std::move(m_keys[i]));
+            values.push_back(std::move(m_values[i]));
+        }
+        m_keys.swap(keys);
+        m_values.swap(values);
+    }
+
+    /**
+     * @brief Appends the entries of %rg and merges them in. If an entry can not
+     * be appended, the map is left as it was; if the merge throws, the map is
+     * cleared, as std::flat_map does, since entries may have been moved from.
+     */
+    template<typename R>
+    void insert_range_aux(R&& rg, bool sorted_unique)
+    {
+        size_type first = size();
+        try {
+            for (auto&& [key, value] : rg) {
+                m_keys.push_back(key);
+                m_values.push_back(value);
+            }
+        } catch (...) {
+            m_keys.erase(m_keys.begin() + first, m_keys.end());
+            m_values.erase(m_values.begin() + first, m_values.end());
+            throw;
+        }
+        try {
+            merge_tail_aux(first, sorted_unique);
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    template<typename K, typename... Args>
+    std::pair<size_type, bool> try_emplace_aux(K&& key, Args&&... args)
+    {
+        size_type i = lower_bound_index_aux(key);
+        if (i != size() && !m_compare(key, m_keys[i]))
+            return { i, false };
+
+        m_keys.insert(m_keys.begin() + i, std::forward<K>(key));
+        try {
+            m_values.insert(m_values.begin() + i, T(std::forward<Args>(args)...));
+        } catch (...) {
+            m_keys.erase(m_keys.begin() + i);
+            throw;
+        }
+        return { i, true };
+    }
+
+  public:
+    /**
+     * @brief Random-access iterator over the entries. Dereferencing yields a
+     * pair of references into the key and value vectors.
+     */
+    template<bool Const>
+    class Iterator
+    {
+      public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag; // proxy references
+        using value_type = flat_map::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const_reference, flat_map::reference>;
+        using mapped_pointer = std::conditional_t<Const, const T*, T*>;
+
+        /**
+         * @brief Returned by operator->, so that it->first and it->second work.
+         */
+        struct arrow_proxy
+        {
+            reference ref;
+            const reference* operator->() const { return &ref; }
+        };
+
+        Iterator() = default;
+
+        Iterator(const Key* key, mapped_pointer value)
+          : m_key{ key }
+          , m_value{ value }
+        {
+        }
+
+        /**
+         * @brief Conversion from a read/write iterator to a read-only one.
+         */
+        template<bool OtherConst>
+            requires(Const && !OtherConst)
+        Iterator(const Iterator<OtherConst>& other)
+          : m_key{ other.m_key }
+          , m_value{ other.m_value }
+        {
+        }
+
+        reference operator*() const { return reference(*m_key, *m_value); }
+        arrow_proxy operator->() const { return arrow_proxy{ **this }; }
+        reference operator[](difference_type n) const
+        {
+            return reference(m_key[n], m_value[n]);
+        }
+
+        Iterator& operator++()
+        {
+            ++m_key;
+            ++m_value;
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        Iterator& operator--()
+        {
+            --m_key;
+            --m_value;
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            auto temp = *this;
+            --*this;
+            return temp;
+        }
+
+        Iterator& operator+=(difference_type n)
+        {
+            m_key += n;
+            m_value += n;
+            return *this;
+        }
+
+        Iterator& operator-=(difference_type n) { return *this += -n; }
+
+        Iterator operator+(difference_type n) const
+        {
+            return Iterator(m_key + n, m_value + n);
+        }
+        friend Iterator operator+(difference_type n, Iterator it) { return it + n; }
+        Iterator operator-(difference_type n) const
+        {
+            return Iterator(m_key - n, m_value - n);
+        }
+        difference_type operator-(const Iterator& other) const
+        {
+            return m_key - other.m_key;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs)
+        {
+            return lhs.m_key == rhs.m_key;
+        }
+
+        friend auto operator<=>(const Iterator& lhs, const Iterator& rhs)
+        {
+            return lhs.m_key <=> rhs.m_key;
+        }
+
+        /**
+         * @brief Returns the key, without building the proxy pair.
+         */
+        const Key& key() const { return *m_key; }
+
+      private:
+        friend Iterator<true>;
+        const Key* m_key{ nullptr };
+        mapped_pointer m_value{ nullptr };
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    // Constructors
+    /**
+     * @brief Creates an empty flat_map.
+     */
+    flat_map() = default;
+
+    explicit flat_map(const key_compare& compare)
+      : m_compare{ compare }
+    {
+    }
+
+    /**
+     * @brief Creates a flat_map from unsorted keys and their values: the entries
+     * are sorted and deduplicated once.
+     * @throws std::invalid_argument if the vectors differ in size.
+     */
+    flat_map(key_container_type keys,
+             mapped_container_type values,
+             const key_compare& compare = key_compare())
+      : m_keys{ std::move(keys) }
+      , m_values{ std::move(values) }
+      , m_compare{ compare }
+    {
+        if (m_keys.size() != m_values.size())
+            throw std::invalid_argument("flat_map: keys and values differ in size");
+        merge_tail_aux(0, false);
+    }
+
+    /**
+     * @brief Creates a flat_map from keys that are already sorted and unique.
+     */
+    flat_map(sorted_unique_t,
+             key_container_type keys,
+             mapped_container_type values,
+             const key_compare& compare = key_compare())
+      : m_keys{ std::move(keys) }
+      , m_values{ std::move(values) }
+      , m_compare{ compare }
+    {
+        if (m_keys.size() != m_values.size())
+            throw std::invalid_argument("flat_map: keys and values differ in size");
+    }
+
+    template<std::input_iterator InputIt>
+    flat_map(InputIt first, InputIt last, const key_compare& compare = key_compare())
+      : m_compare{ compare }
+    {
+        for (; first != last; ++first) {
+            const auto& [key, value] = *first;
+            m_keys.push_back(key);
+            m_values.push_back(value);
+        }
+        merge_tail_aux(0, false);
+    }
+
+    flat_map(std::initializer_list<value_type> entries,
+             const key_compare& compare = key_compare())
+      : flat_map(entries.begin(), entries.end(), compare)
+    {
+    }
+
+    // Capacity related member functions
+    [[nodiscard]] size_type size() const { return m_keys.size(); }
+    [[nodiscard]] bool empty() const { return m_keys.empty(); }
+
+    void reserve(size_type new_capacity)
+    {
+        m_keys.reserve(new_capacity);
+        m_values.reserve(new_capacity);
+    }
+
+    // Iterators
+    iterator begin() { return iterator(m_keys.data(), m_values.data()); }
+    const_iterator begin() const
+    {
+        return const_iterator(m_keys.data(), m_values.data());
+    }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return begin() + size(); }
+    const_iterator end() const { return begin() + size(); }
+    const_iterator cend() const { return end(); }
+
+    // Element access
+    /**
+     * @brief Returns the value mapped to %key.
+     * @throws std::out_of_range if %key is not present.
+     */
+    T& at(const Key& key)
+    {
+        size_type i = find_index_aux(key);
+        if (i == size())
+            throw std::out_of_range("flat_map: key not found");
+        return m_values[i];
+    }
+
+    const T& at(const Key& key) const
+    {
+        size_type i = find_index_aux(key);
+        if (i == size())
+            throw std::out_of_range("flat_map: key not found");
+        return m_values[i];
+    }
+
+    /**
+     * @brief Returns the value mapped to %key, inserting a value-initialized one
+     * first if %key is not present.
+     */
+    T& operator[](const Key& key) { return m_values[try_emplace_aux(key).first]; }
+    T& operator[](Key&& key) { return m_values[try_emplace_aux(std::move(key)).first]; }
+
+    // Lookup
+    iterator lower_bound(const Key& key) { return begin() + lower_bound_index_aux(key); }
+    const_iterator lower_bound(const Key& key) const
+    {
+        return begin() + lower_bound_index_aux(key);
+    }
+
+    iterator upper_bound(const Key& key)
+    {
+        return begin() + (detail::branchless_upper_bound(
+                            m_keys.begin(), m_keys.end(), key, m_compare) -
+                          m_keys.begin());
+    }
+
+    const_iterator upper_bound(const Key& key) const
+    {
+        return const_cast<flat_map*>(this)->upper_bound(key);
+    }
+
+    iterator find(const Key& key) { return begin() + find_index_aux(key); }
+    const_iterator find(const Key& key) const { return begin() + find_index_aux(key); }
+
+    [[nodiscard]] bool contains(const Key& key) const
+    {
+        return find_index_aux(key) != size();
+    }
+    [[nodiscard]] size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    std::pair<iterator, iterator> equal_range(const Key& key)
+    {
+        auto it = lower_bound(key);
+        if (it != end() && !m_compare(key, it.key()))
+            return { it, std::next(it) };
+        return { it, it };
+    }
+
+    // Modifiers
+    /**
+     * @brief Inserts %entry if its key is not present yet. O(n): use
+     * insert_range() for more than a handful of entries.
+     */
+    std::pair<iterator, bool> insert(const value_type& entry)
+    {
+        auto [i, inserted] = try_emplace_aux(entry.first, entry.second);
+        return { begin() + i, inserted };
+    }
+
+    std::pair<iterator, bool> insert(value_type&& entry)
+    {
+        auto [i, inserted] =
+          try_emplace_aux(std::move(entry.first), std::move(entry.second));
+        return { begin() + i, inserted };
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+    {
+        auto [i, inserted] = try_emplace_aux(key, std::forward<Args>(args)...);
+        return { begin() + i, inserted };
+    }
+
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, M&& value)
+    {
+        auto [i, inserted] = try_emplace_aux(key, std::forward<M>(value));
+        if (!inserted)
+            m_values[i] = std::forward<M>(value);
+        return { begin() + i, inserted };
+    }
+
+    /**
+     * @brief Inserts the entries of %rg whose keys are not present yet. The batch
+     * is appended, sorted and deduplicated once, and merged with the existing
+     * entries in a single O(n + m log m) pass.
+     */
+    template<std::ranges::input_range R>
+    void insert_range(R&& rg)
+    {
+        insert_range_aux(std::forward<R>(rg), false);
+    }
+
+    /**
+     * @brief Inserts the entries of %rg, whose keys must be sorted and unique.
+     * Only the merge with the existing entries is done.
+     */
+    template<std::ranges::input_range R>
+    void insert_range(sorted_unique_t, R&& rg)
+    {
+        insert_range_aux(std::forward<R>(rg), true);
+    }
+
+    /**
+     * @brief Removes the entry with key %key if present.
+     * @return The number of removed entries (0 or 1).
+     */
+    size_type erase(const Key& key)
+    {
+        size_type i = find_index_aux(key);
+        if (i == size())
+            return 0;
+        m_keys.erase(m_keys.begin() + i);
+        m_values.erase(m_values.begin() + i);
+        return 1;
+    }
+
+    iterator erase(const_iterator position)
+    {
+        difference_type i = position - cbegin();
+        m_keys.erase(m_keys.begin() + i);
+        m_values.erase(m_values.begin() + i);
+        return begin() + i;
+    }
+
+    void clear() noexcept
+    {
+        m_keys.clear();
+        m_values.clear();
+    }
+
+    void swap(flat_map& other) noexcept
+    {
+        m_keys.swap(other.m_keys);
+        m_values.swap(other.m_values);
+        std::swap(m_compare, other.m_compare);
+    }
+
+    /**
+     * @brief Moves the underlying vectors out. The map is left empty.
+     */
+    containers extract() &&
+    {
+        containers result{ key_container_type(std::move(m_keys)),
+                           mapped_container_type(std::move(m_values)) };
+        return result;
+    }
+
+    /**
+     * @brief Read-only access to the sorted keys, e.g. to scan them directly.
+     */
+    const key_container_type& keys() const noexcept { return m_keys; }
+
+    /**
+     * @brief Read-only access to the values, in key order.
+     */
+    const mapped_container_type& values() const noexcept { return m_values; }
+
+    key_compare key_comp() const { return m_compare; }
+
+    friend bool operator==(const flat_map& lhs, const flat_map& rhs)
+    {
+        return std::ranges::equal(lhs.m_keys, rhs.m_keys) &&
+               std::ranges::equal(lhs.m_values, rhs.m_values);
+    }
+};
+
+} // namespace dev
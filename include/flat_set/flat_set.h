@@ -0,0 +1,341 @@
+#pragma once
+
+#include "vector/vector.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
+#include <utility>
+
+namespace dev {
+
+/**
+ * @brief Tag for constructors and insert_range() overloads whose input is
+ * already sorted and free of duplicates, so that the sort is skipped.
+ */
+struct sorted_unique_t
+{
+    explicit sorted_unique_t() = default;
+};
+
+inline constexpr sorted_unique_t sorted_unique{};
+
+namespace detail {
+
+/**
+ * @brief lower_bound over a random-access range without a data-dependent branch.
+ *
+ * Every step halves the range with a conditional move instead of a branch, so
+ * the loop runs exactly ceil(log2(n)) times and the branch predictor never
+ * mispredicts on the comparison. For lookups that miss the cache that is
+ * cheaper than std::lower_bound, which mispredicts half of the time.
+ */
+template<std::random_access_iterator It, typename T, typename Compare>
+It branchless_lower_bound(It first, It last, const T& value, Compare comp)
+{
+    auto length = last - first;
+    if (length == 0)
+        return first;
+    while (length > 1) {
+        auto half = length / 2;
+        first = comp(first[half], value) ? first + half : first;
+        length -= half;
+    }
+    return first + static_cast<std::iter_difference_t<It>>(comp(*first, value));
+}
+
+/**
+ * @brief upper_bound counterpart of branchless_lower_bound().
+ */
+template<std::random_access_iterator It, typename T, typename Compare>
+It branchless_upper_bound(It first, It last, const T& value, Compare comp)
+{
+    auto length = last - first;
+    if (length == 0)
+        return first;
+    while (length > 1) {
+        auto half = length / 2;
+        first = comp(value, first[half]) ? first : first + half;
+        length -= half;
+    }
+    return first + static_cast<std::iter_difference_t<It>>(!comp(value, *first));
+}
+
+} // namespace detail
+
+/**
+ * @brief A sorted set stored in a single contiguous dev::vector, in the style of
+ * C++23 %std::flat_set.
+ *
+ * Lookups are a branchless binary search over contiguous keys, and iteration
+ * is a linear scan, so both are far more cache friendly than a node-based
+ * %std::set. Inserting or erasing a single key is O(n), since later keys have
+ * to be shifted: insert in bulk with the constructors or insert_range().
+ */
+template<typename Key, typename Compare = std::less<Key>>
+class flat_set
+{
+  public:
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = const Key&;
+    using const_reference = const Key&;
+    using container_type = vector<Key>;
+    using iterator = typename container_type::const_iterator;
+    using const_iterator = typename container_type::const_iterator;
+
+  private:
+    container_type m_keys;
+    [[no_unique_address]] key_compare m_compare;
+
+    /**
+     * @brief Returns a predicate telling whether two keys are equivalent.
+     */
+    auto equivalent() const
+    {
+        return [this](const Key& lhs, const Key& rhs) {
+            return !m_compare(lhs, rhs) && !m_compare(rhs, lhs);
+        };
+    }
+
+    /**
+     * @brief Sorts the keys [first, size()), removes duplicates among them and
+     * merges them into the sorted keys [0, first). Where a key is already
+     * present, the existing key is kept.
+     */
+    void merge_tail_aux(size_type first, bool tail_sorted_unique)
+    {
+        auto middle = m_keys.begin() + first;
+        if (middle == m_keys.end())
+            return;
+        if (!tail_sorted_unique) {
+            std::stable_sort(middle, m_keys.end(), m_compare);
+            m_keys.erase(std::unique(middle, m_keys.end(), equivalent()), m_keys.end());
+            middle = m_keys.begin() + first;
+        }
+
+        // Appending keys that are all greater than the existing ones is common
+        // (e.g. a new day of instruments) and needs no merge.
+        if (first == 0 || m_compare(*std::prev(middle), *middle))
+            return;
+
+        std::inplace_merge(m_keys.begin(), middle, m_keys.end(), m_compare);
+        auto unique_end = std::unique(m_keys.begin(), m_keys.end(), equivalent());
+        m_keys.erase(unique_end, m_keys.end());
+    }
+
+    /**
+     * @brief Appends the keys of %rg and merges them in. If a key can not be
+     * appended, the set is left as it was; if the merge throws, the set is
+     * cleared, as std::flat_set does, since keys may have been moved from.
+     */
+    template<typename R>
+    void insert_range_aux(R&& rg, bool sorted_unique)
+    {
+        size_type first = size();
+        try {
+            m_keys.append_range(std::forward<R>(rg));
+        } catch (...) {
+            m_keys.erase(m_keys.begin() + first, m_keys.end());
+            throw;
+        }
+        try {
+            merge_tail_aux(first, sorted_unique);
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+  public:
+    // Constructors
+    /**
+     * @brief Creates an empty flat_set.
+     */
+    flat_set() = default;
+
+    explicit flat_set(const key_compare& compare)
+      : m_compare{ compare }
+    {
+    }
+
+    /**
+     * @brief Creates a flat_set from unsorted keys: they are sorted and
+     * deduplicated once.
+     */
+    explicit flat_set(container_type keys, const key_compare& compare = key_compare())
+      : m_keys{ std::move(keys) }
+      , m_compare{ compare }
+    {
+        merge_tail_aux(0, false);
+    }
+
+    /**
+     * @brief Creates a flat_set from keys that are already sorted and unique.
+     */
+    flat_set(sorted_unique_t,
+             container_type keys,
+             const key_compare& compare = key_compare())
+      : m_keys{ std::move(keys) }
+      , m_compare{ compare }
+    {
+    }
+
+    template<std::input_iterator InputIt>
+    flat_set(InputIt first, InputIt last, const key_compare& compare = key_compare())
+      : m_compare{ compare }
+    {
+        for (; first != last; ++first)
+            m_keys.push_back(*first);
+        merge_tail_aux(0, false);
+    }
+
+    flat_set(std::initializer_list<Key> keys, const key_compare& compare = key_compare())
+      : flat_set(keys.begin(), keys.end(), compare)
+    {
+    }
+
+    // Capacity related member functions
+    [[nodiscard]] size_type size() const { return m_keys.size(); }
+    [[nodiscard]] bool empty() const { return m_keys.empty(); }
+    void reserve(size_type new_capacity) { m_keys.reserve(new_capacity); }
+
+    // Iterators
+    const_iterator begin() const { return m_keys.begin(); }
+    const_iterator cbegin() const { return m_keys.cbegin(); }
+    const_iterator end() const { return m_keys.end(); }
+    const_iterator cend() const { return m_keys.cend(); }
+
+    // Lookup
+    const_iterator lower_bound(const Key& key) const
+    {
+        return detail::branchless_lower_bound(
+          m_keys.begin(), m_keys.end(), key, m_compare);
+    }
+
+    const_iterator upper_bound(const Key& key) const
+    {
+        return detail::branchless_upper_bound(
+          m_keys.begin(), m_keys.end(), key, m_compare);
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const Key& key) const
+    {
+        auto it = lower_bound(key);
+        if (it != end() && !m_compare(key, *it))
+            return { it, std::next(it) };
+        return { it, it };
+    }
+
+    const_iterator find(const Key& key) const
+    {
+        auto it = lower_bound(key);
+        return it != end() && !m_compare(key, *it) ? it : end();
+    }
+
+    [[nodiscard]] bool contains(const Key& key) const { return find(key) != end(); }
+    [[nodiscard]] size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    // Modifiers
+    /**
+     * @brief Inserts %key if it is not present yet. O(n): use insert_range() for
+     * more than a handful of keys.
+     * @return An iterator to the key, and whether it was inserted.
+     */
+    template<typename K>
+        requires std::is_convertible_v<K, Key>
+    std::pair<iterator, bool> insert(K&& key)
+    {
+        auto it = lower_bound(key);
+        if (it != end() && !m_compare(key, *it))
+            return { it, false };
+        return { m_keys.insert(it, std::forward<K>(key)), true };
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        return insert(Key(std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief Inserts the keys of %rg that are not present yet. The batch is
+     * appended, sorted and deduplicated once, and merged with the existing keys
+     * in a single O(n + m log m) pass.
+     */
+    template<std::ranges::input_range R>
+        requires std::is_convertible_v<std::ranges::range_reference_t<R>, Key>
+    void insert_range(R&& rg)
+    {
+        insert_range_aux(std::forward<R>(rg), false);
+    }
+
+    /**
+     * @brief Inserts the keys of %rg, which must be sorted and unique. Only the
+     * merge with the existing keys is done.
+     */
+    template<std::ranges::input_range R>
+        requires std::is_convertible_v<std::ranges::range_reference_t<R>, Key>
+    void insert_range(sorted_unique_t, R&& rg)
+    {
+        insert_range_aux(std::forward<R>(rg), true);
+    }
+
+    /**
+     * @brief Removes %key if present.
+     * @return The number of removed keys (0 or 1).
+     */
+    size_type erase(const Key& key)
+    {
+        auto it = find(key);
+        if (it == end())
+            return 0;
+        m_keys.erase(it);
+        return 1;
+    }
+
+    iterator erase(const_iterator position) { return m_keys.erase(position); }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        return m_keys.erase(first, last);
+    }
+
+    void clear() noexcept { m_keys.clear(); }
+
+    void swap(flat_set& other) noexcept
+    {
+        m_keys.swap(other.m_keys);
+        std::swap(m_compare, other.m_compare);
+    }
+
+    /**
+     * @brief Moves the underlying sorted vector out. The set is left empty.
+     */
+    container_type extract() &&
+    {
+        container_type keys(std::move(m_keys));
+        return keys;
+    }
+
+    /**
+     * @brief Read-only access to the underlying sorted vector.
+     */
+    const container_type& keys() const noexcept { return m_keys; }
+
+    key_compare key_comp() const { return m_compare; }
+    value_compare value_comp() const { return m_compare; }
+
+    friend bool operator==(const flat_set& lhs, const flat_set& rhs)
+    {
+        return std::ranges::equal(lhs, rhs);
+    }
+};
+
+} // namespace dev
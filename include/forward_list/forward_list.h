@@ -1,14 +1,25 @@
+#pragma once
+
+#include "node_pool/node_pool.h"
 #include <algorithm>
 #include <concepts>
 #include <cstddef>
+#include <functional>
 #include <initializer_list>
 #include <iterator>
+#include <memory>
+#include <type_traits>
 #include <utility>
 
 namespace dev {
-template <typename T> class forward_list {
+// With TrackTail, the list also keeps a pointer to its last node, for O(1)
+// push_back, emplace_back, back and append, at the cost of one more pointer
+// and of keeping it up to date in every modifier.
+template <typename T, typename Allocator = std::allocator<T>, bool TrackTail = false>
+class forward_list {
   public:
     using value_type = T;
+    using allocator_type = Allocator;
     using size_type = std::size_t;
     using pointer = T*;
     using const_pointer = const T*;
@@ -17,33 +28,105 @@ template <typename T> class forward_list {
     using difference_type = std::ptrdiff_t;
 
   private:
-    struct ListNode {
-        value_type m_value;
-        ListNode* next{nullptr};
+    // The links live in a base class, so that before_begin() can point to the
+    // head link of the list itself, which holds no value.
+    struct NodeBase {
+        NodeBase* next{nullptr};
+    };
 
-        ListNode(const_reference value) : m_value{value} {}
+    struct ListNode : NodeBase {
+        value_type m_value;
 
-        ListNode(T&& value) : m_value{std::move(value)} {}
+        template <typename... Args>
+        ListNode(Args&&... args) : m_value(std::forward<Args>(args)...) {}
     };
 
-    ListNode* m_head{nullptr};
+    // Nodes are allocated through the allocator rebound to ListNode, so that a
+    // pool allocator hands out blocks of exactly the node size.
+    using node_allocator =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<ListNode>;
+    using node_traits = std::allocator_traits<node_allocator>;
+
+    struct NoTail {};
+
+    NodeBase m_before_head;
     size_type m_size{0};
+    [[no_unique_address]] node_allocator m_alloc;
+    // The last node, or &m_before_head when the list is empty
+    [[no_unique_address]] std::conditional_t<TrackTail, NodeBase*, NoTail> m_tail{
+        initial_tail()};
+
+    auto initial_tail() noexcept {
+        if constexpr (TrackTail)
+            return &m_before_head;
+        else
+            return NoTail{};
+    }
+
+    bool is_tail(const NodeBase* node) const noexcept {
+        if constexpr (TrackTail)
+            return m_tail == node;
+        else
+            return false;
+    }
+
+    void set_tail(NodeBase* node) noexcept {
+        if constexpr (TrackTail)
+            m_tail = node;
+    }
+
+    // Walks to the last node, after an operation that reorders the whole list
+    void find_tail() noexcept {
+        if constexpr (TrackTail) {
+            m_tail = &m_before_head;
+            while (m_tail->next)
+                m_tail = m_tail->next;
+        }
+    }
+
+    static ListNode* as_node(NodeBase* node) {
+        return static_cast<ListNode*>(node);
+    }
+
+    template <typename... Args> ListNode* create_node(Args&&... args) {
+        ListNode* node = node_traits::allocate(m_alloc, 1);
+        try {
+            std::construct_at(node, std::forward<Args>(args)...);
+        } catch (...) {
+            node_traits::deallocate(m_alloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void destroy_node(NodeBase* node) noexcept {
+        std::destroy_at(as_node(node));
+        node_traits::deallocate(m_alloc, as_node(node), 1);
+    }
 
   public:
     template <typename U> class Iterator {
       public:
+        using iterator_category = std::forward_iterator_tag;
         using value_type = forward_list::value_type;
-        using pointer = forward_list::pointer;
-        using reference = forward_list::reference;
+        using pointer = U*;
+        using reference = U&;
         using difference_type = forward_list::difference_type;
-        friend class forward_list<T>;
+        friend class forward_list;
+        friend class Iterator<const T>;
 
       private:
-        ListNode* m_current_node_ptr;
+        NodeBase* m_current_node_ptr{nullptr};
 
       public:
         Iterator() = default;
-        Iterator(ListNode* ptr) : m_current_node_ptr{ptr} {}
+        Iterator(NodeBase* ptr) : m_current_node_ptr{ptr} {}
+
+        // Conversion from a read/write iterator to a read-only one
+        template <typename V>
+            requires(std::is_const_v<U> && std::is_same_v<V, T>)
+        Iterator(const Iterator<V>& other)
+            : m_current_node_ptr{other.m_current_node_ptr} {}
 
         // Pre-increment
         Iterator& operator++() {
@@ -58,29 +141,17 @@ template <typename T> class forward_list {
             return temp;
         }
 
-        bool operator==(const Iterator& other) const {
-            return (m_current_node_ptr == other.m_current_node_ptr);
-        }
-
-        bool operator!=(const Iterator& other) const {
-            return !(*this == other);
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+            return lhs.m_current_node_ptr == rhs.m_current_node_ptr;
         }
 
         // Pointer-like operations
-        U& operator*() {
-            return m_current_node_ptr->m_value;
-        }
-
-        const U& operator*() const {
-            return m_current_node_ptr->m_value;
-        }
-
-        U* operator->() {
-            return m_current_node_ptr;
+        U& operator*() const {
+            return as_node(m_current_node_ptr)->m_value;
         }
 
-        const U* operator->() const {
-            return m_current_node_ptr;
+        U* operator->() const {
+            return &as_node(m_current_node_ptr)->m_value;
         }
     };
 
@@ -92,19 +163,23 @@ template <typename T> class forward_list {
     }
 
     bool empty() const {
-        return (!m_head);
+        return (!m_before_head.next);
+    }
+
+    allocator_type get_allocator() const {
+        return allocator_type(m_alloc);
     }
 
     iterator begin() {
-        return iterator(m_head);
+        return iterator(m_before_head.next);
     }
 
     const_iterator begin() const {
-        return const_iterator(m_head);
+        return const_iterator(m_before_head.next);
     }
 
     const_iterator cbegin() const {
-        return const_iterator(m_head);
+        return const_iterator(m_before_head.next);
     }
 
     iterator end() {
@@ -121,12 +196,14 @@ template <typename T> class forward_list {
 
     /* Destroy the containers content */
     void clear() noexcept {
-        for (auto p{m_head}; p != nullptr;) {
+        for (auto p{m_before_head.next}; p != nullptr;) {
             auto q = p->next;
-            delete p;
+            destroy_node(p);
             p = q;
         }
+        m_before_head.next = nullptr;
         m_size = 0;
+        set_tail(&m_before_head);
     }
 
     ~forward_list() {
@@ -136,40 +213,55 @@ template <typename T> class forward_list {
     /* Constructors */
     forward_list() = default;
 
-    template <std::input_iterator It> forward_list(It b, It e) {
-        if (b == e)
-            return;
-        ListNode* m_curr{nullptr};
+    explicit forward_list(const Allocator& alloc) : m_alloc(alloc) {}
+
+    template <std::input_iterator It>
+    forward_list(It b, It e, const Allocator& alloc = Allocator()) : m_alloc(alloc) {
+        NodeBase* m_curr{&m_before_head};
 
         try {
             for (auto it{b}; it != e; ++it) {
-                if (empty()) {
-                    m_head = new ListNode(*it);
-                    ++m_size;
-                    m_curr = m_head;
-                } else {
-                    m_curr->next = new ListNode(*it);
-                    ++m_size;
-                    m_curr = m_curr->next;
-                }
+                m_curr->next = create_node(*it);
+                ++m_size;
+                m_curr = m_curr->next;
             }
+            set_tail(m_curr);
         } catch (...) {
             clear();
             throw;
         }
     }
 
-    forward_list(const forward_list& other) : forward_list(other.begin(), other.end()) {}
+    forward_list(const forward_list& other)
+        : forward_list(
+              other.begin(), other.end(),
+              node_traits::select_on_container_copy_construction(other.m_alloc)) {}
 
-    forward_list(std::initializer_list<T> other) : forward_list(other.begin(), other.end()) {}
+    forward_list(std::initializer_list<T> other, const Allocator& alloc = Allocator())
+        : forward_list(other.begin(), other.end(), alloc) {}
 
-    forward_list(forward_list&& other)
-        : m_head{std::exchange(other.m_head, nullptr)}, m_size{std::exchange(other.m_size, 0)} {}
+    forward_list(forward_list&& other) noexcept
+        : m_before_head{std::exchange(other.m_before_head.next, nullptr)},
+          m_size{std::exchange(other.m_size, 0)}, m_alloc{std::move(other.m_alloc)} {
+        if constexpr (TrackTail) {
+            if (m_before_head.next)
+                m_tail = std::exchange(other.m_tail, &other.m_before_head);
+        }
+    }
 
-    void swap(forward_list& other) {
+    void swap(forward_list& other) noexcept {
         using std::swap;
-        swap(m_head, other.m_head);
+        swap(m_before_head.next, other.m_before_head.next);
         swap(m_size, other.m_size);
+        swap(m_alloc, other.m_alloc);
+        if constexpr (TrackTail) {
+            swap(m_tail, other.m_tail);
+            // An empty list points to its own head link
+            if (!m_before_head.next)
+                m_tail = &m_before_head;
+            if (!other.m_before_head.next)
+                other.m_tail = &other.m_before_head;
+        }
     }
 
     forward_list& operator=(const forward_list& other) {
@@ -177,16 +269,24 @@ template <typename T> class forward_list {
         return *this;
     }
 
-    forward_list& operator=(forward_list&& other) {
+    forward_list& operator=(forward_list&& other) noexcept {
         forward_list(std::move(other)).swap(*this);
+        return *this;
     }
 
+    // before_begin - Returns an iterator to the element before the first
+    // element, for use with insert_after, emplace_after and erase_after.
+    // It must not be dereferenced.
     iterator before_begin() noexcept {
-        return (m_head - 1);
+        return iterator(&m_before_head);
+    }
+
+    const_iterator before_begin() const noexcept {
+        return const_iterator(const_cast<NodeBase*>(&m_before_head));
     }
 
-    const_iterator cbefore_begin() noexcept {
-        return (m_head - 1);
+    const_iterator cbefore_begin() const noexcept {
+        return before_begin();
     }
 
     /* Modifiers */
@@ -196,52 +296,48 @@ template <typename T> class forward_list {
     // If pos is not in the range [before_begin(), end()) then
     // the behavior is UB.
   private:
-    void insert_after_helper(auto pos, ListNode* newNode) {
-        if (std::next(pos) == begin()) {
-            newNode->next = m_head;
-            m_head = newNode;
-        } else {
-            newNode->next = pos->next;
-        }
-        pos->next = newNode;
+    iterator insert_after_helper(const_iterator pos, ListNode* newNode) {
+        newNode->next = pos.m_current_node_ptr->next;
+        pos.m_current_node_ptr->next = newNode;
+        if (is_tail(pos.m_current_node_ptr))
+            set_tail(newNode);
         ++m_size;
+        return iterator(newNode);
     }
 
   public:
     iterator insert_after(const_iterator pos, const T& value) {
-        ListNode* node = new ListNode(value);
-        insert_after_helper(pos, node);
-        return node;
+        return insert_after_helper(pos, create_node(value));
     }
 
     iterator insert_after(const_iterator pos, T&& value) {
-        ListNode* node = new ListNode(std::move(value));
-        insert_after_helper(pos, node);
-        return node;
+        return insert_after_helper(pos, create_node(std::move(value)));
     }
 
     // emplace_after - Inserts a new element into a position after the
     // specified position in the container. The element is
     // constructed in-place.
-    template <typename... Args> iterator emplace_after(const_iterator pos, Args&&... args) {
-        ListNode* node = new ListNode(T(std::forward<Args>(args)...));
-        insert_after_helper(pos, node);
-        return node;
+    template <typename... Args>
+    iterator emplace_after(const_iterator pos, Args&&... args) {
+        return insert_after_helper(pos, create_node(std::forward<Args>(args)...));
     }
 
     // erase_after - removes the element following pos
     // It returns iterator to the element following pos
     // or end(), if no such element exists
     iterator erase_after(const_iterator pos) {
-        if (pos == end() || std::next(pos) == end())
+        NodeBase* prev = pos.m_current_node_ptr;
+        if (prev == nullptr || prev->next == nullptr)
             return end();
 
-        auto p = pos->next;
+        auto p = prev->next;
         auto q = p->next;
-        pos->next = q;
-        delete p;
+        prev->next = q;
+        if (is_tail(p))
+            set_tail(prev);
+        destroy_node(p);
         --m_size;
-        return q;
+        return iterator(q);
     }
 
     template <typename U> iterator push_front(U&& value) {
@@ -254,53 +350,320 @@ template <typename T> class forward_list {
 
     // pop_front - Removes the first element in the container
     void pop_front() {
-        if (m_head) {
-            auto p = m_head;
-            m_head = m_head->next;
-            delete p;
-            --m_size;
+        erase_after(before_begin());
+    }
+
+    // back, push_back, emplace_back and append - O(1) access and insertion at
+    // the end of the list. Only available with TrackTail.
+    T& back()
+        requires TrackTail
+    {
+        return as_node(m_tail)->m_value;
+    }
+
+    const T& back() const
+        requires TrackTail
+    {
+        return as_node(m_tail)->m_value;
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+        requires TrackTail
+    {
+        return *insert_after_helper(iterator(m_tail),
+                                    create_node(std::forward<Args>(args)...));
+    }
+
+    void push_back(const T& value)
+        requires TrackTail
+    {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value)
+        requires TrackTail
+    {
+        emplace_back(std::move(value));
+    }
+
+    // Moves all elements of other to the end of the list, in O(1). The
+    // allocators of both lists must compare equal.
+    void append(forward_list&& other) noexcept
+        requires TrackTail
+    {
+        if (&other == this || !other.m_before_head.next)
+            return;
+        m_tail->next = std::exchange(other.m_before_head.next, nullptr);
+        m_tail = std::exchange(other.m_tail, &other.m_before_head);
+        m_size += std::exchange(other.m_size, 0);
+    }
+
+  private:
+    // Appends the null-terminated list chain after tail, and returns its last
+    // node.
+    static NodeBase* link_aux(NodeBase* tail, NodeBase* chain) noexcept {
+        tail->next = chain;
+        while (tail->next)
+            tail = tail->next;
+        return tail;
+    }
+
+    // Merges the sorted, null-terminated lists a and b into out. On ties the
+    // node of a goes first, which keeps sort stable. If comp throws, out
+    // still holds every node of a and b, in no particular order.
+    template <typename Compare>
+    static void merge_aux(NodeBase*& out, NodeBase* a, NodeBase* b, Compare& comp) {
+        NodeBase head;
+        NodeBase* tail = &head;
+        try {
+            while (a && b) {
+                if (comp(as_node(b)->m_value, as_node(a)->m_value)) {
+                    tail->next = b;
+                    b = b->next;
+                } else {
+                    tail->next = a;
+                    a = a->next;
+                }
+                tail = tail->next;
+            }
+        } catch (...) {
+            link_aux(link_aux(tail, a), b);
+            out = head.next;
+            throw;
         }
+        tail->next = a ? a : b;
+        out = head.next;
     }
-    // resize() - Resizes the container to contain count elements
-    // - if the count is equal to the current size, does nothing.
-    // - if the current size > count, then the container is reduced to its
-    //   first count elements.
-    // - if the current size is less than count, then additional default-inserted
-    //   elements/copies of value are appended.
-    void resize(size_type count) {
-        if (count == m_size)
+
+  public:
+    // splice_after - Moves elements from another list to after pos, by
+    // relinking their nodes: no element is copied and nothing is allocated.
+    // The allocators of both lists must compare equal.
+
+    // Moves the element after it in other. O(1).
+    void splice_after(const_iterator pos, forward_list& other,
+                      const_iterator it) noexcept {
+        NodeBase* prev = it.m_current_node_ptr;
+        NodeBase* node = prev->next;
+        if (pos.m_current_node_ptr == prev || pos.m_current_node_ptr == node)
             return;
+        prev->next = node->next;
+        node->next = pos.m_current_node_ptr->next;
+        pos.m_current_node_ptr->next = node;
+        if (other.is_tail(node))
+            other.set_tail(prev);
+        if (is_tail(pos.m_current_node_ptr))
+            set_tail(node);
+        --other.m_size;
+        ++m_size;
+    }
 
-        if (count < m_size) {
-            if (count == 0) {
-                clear();
-                return;
+    void splice_after(const_iterator pos, forward_list&& other,
+                      const_iterator it) noexcept {
+        splice_after(pos, other, it);
+    }
+
+    // Moves the elements in (first, last) of other. Linear in their number,
+    // since they are counted to keep size() O(1).
+    void splice_after(const_iterator pos, forward_list& other, const_iterator first,
+                      const_iterator last) noexcept {
+        NodeBase* head = first.m_current_node_ptr->next;
+        if (head == last.m_current_node_ptr)
+            return;
+        NodeBase* tail = head;
+        size_type count = 1;
+        for (; tail->next != last.m_current_node_ptr; tail = tail->next)
+            ++count;
+        first.m_current_node_ptr->next = last.m_current_node_ptr;
+        tail->next = pos.m_current_node_ptr->next;
+        pos.m_current_node_ptr->next = head;
+        if (other.is_tail(tail))
+            other.set_tail(first.m_current_node_ptr);
+        if (is_tail(pos.m_current_node_ptr))
+            set_tail(tail);
+        other.m_size -= count;
+        m_size += count;
+    }
+
+    void splice_after(const_iterator pos, forward_list&& other, const_iterator first,
+                      const_iterator last) noexcept {
+        splice_after(pos, other, first, last);
+    }
+
+    // Moves all elements of other. Linear in the size of other.
+    void splice_after(const_iterator pos, forward_list& other) noexcept {
+        splice_after(pos, other, other.before_begin(), other.end());
+    }
+
+    void splice_after(const_iterator pos, forward_list&& other) noexcept {
+        splice_after(pos, other);
+    }
+
+    // merge - Merges the sorted list other into this sorted list, leaving
+    // other empty. Equal elements of this list stay before those of other.
+    // If comp throws, every element of both lists is left in this one, in no
+    // particular order.
+    template <typename Compare> void merge(forward_list& other, Compare comp) {
+        if (&other == this)
+            return;
+        // On ties the elements of other go last
+        NodeBase* last = nullptr;
+        if constexpr (TrackTail) {
+            if (other.m_before_head.next &&
+                (!m_before_head.next ||
+                 !comp(as_node(other.m_tail)->m_value, as_node(m_tail)->m_value)))
+                last = other.m_tail;
+        }
+        const size_type count = std::exchange(other.m_size, 0);
+        NodeBase* theirs = std::exchange(other.m_before_head.next, nullptr);
+        other.set_tail(&other.m_before_head);
+        try {
+            merge_aux(m_before_head.next, m_before_head.next, theirs, comp);
+        } catch (...) {
+            m_size += count;
+            find_tail();
+            throw;
+        }
+        m_size += count;
+        if (last)
+            set_tail(last);
+    }
+
+    template <typename Compare> void merge(forward_list&& other, Compare comp) {
+        merge(other, comp);
+    }
+
+    void merge(forward_list& other) {
+        merge(other, std::less<>());
+    }
+
+    void merge(forward_list&& other) {
+        merge(other, std::less<>());
+    }
+
+    // sort - Sorts the elements, stably, with a merge sort that relinks the
+    // nodes. Runs of 2^i nodes are kept in bin i and merged as soon as two of
+    // the same length exist, so that most merges work on nodes that were just
+    // touched and are still in cache. It takes O(n log n) comparisons and a
+    // fixed array of 64 pointers, and neither copies nor allocates. If comp
+    // throws, the elements are left in no particular order.
+    template <typename Compare> void sort(Compare comp) {
+        NodeBase* bins[64] = {};
+        size_type used = 0;
+        NodeBase* rest = m_before_head.next;
+        NodeBase* carry = nullptr;
+        NodeBase* sorted = nullptr;
+        try {
+            while (rest) {
+                carry = rest;
+                rest = std::exchange(carry->next, nullptr);
+                size_type i = 0;
+                for (; bins[i]; ++i)
+                    merge_aux(carry, std::exchange(bins[i], nullptr), carry, comp);
+                bins[i] = std::exchange(carry, nullptr);
+                used = std::max(used, i + 1);
             }
 
-            int running_count{0};
-            for (auto p{m_head}; p != nullptr;) {
-                auto q = p->next;
-                if (running_count == count) {
-                    delete p;
-                }
-                ++running_count;
-                p = q;
+            // The lower bins hold the later elements
+            for (size_type i = 0; i < used; ++i) {
+                if (bins[i])
+                    merge_aux(sorted, std::exchange(bins[i], nullptr), sorted, comp);
             }
+        } catch (...) {
+            // Every node is in one of the partial lists
+            NodeBase* tail = link_aux(&m_before_head, sorted);
+            for (NodeBase* bin : bins)
+                tail = link_aux(tail, bin);
+            link_aux(link_aux(tail, carry), rest);
+            find_tail();
+            throw;
         }
+        m_before_head.next = sorted;
+        find_tail();
+    }
 
-        if (count > m_size) {
-            if (empty())
-                push_front(T());
+    void sort() {
+        sort(std::less<>());
+    }
+
+    // reverse - Reverses the order of the elements
+    void reverse() noexcept {
+        if (m_before_head.next)
+            set_tail(m_before_head.next);
+        NodeBase* reversed = nullptr;
+        for (NodeBase* p = m_before_head.next; p;) {
+            NodeBase* next = p->next;
+            p->next = reversed;
+            reversed = p;
+            p = next;
+        }
+        m_before_head.next = reversed;
+    }
 
-            auto p{m_head};
-            int size{m_size};
+    // remove_if - Erases the elements for which pred is true, and returns
+    // how many were erased. They are destroyed only once the whole list has
+    // been walked, so that remove(value) works with an element of the list.
+    template <typename Predicate> size_type remove_if(Predicate pred) {
+        forward_list removed(get_allocator());
+        for (NodeBase* prev = &m_before_head; prev->next;) {
+            if (pred(as_node(prev->next)->m_value))
+                removed.splice_after(removed.before_begin(), *this, iterator(prev));
+            else
+                prev = prev->next;
+        }
+        return removed.size();
+    }
+
+    size_type remove(const T& value) {
+        return remove_if([&value](const T& element) { return element == value; });
+    }
 
-            for (auto running_count{1}; running_count <= count; ++running_count) {
-                if (running_count > size)
-                    insert_after(p, T{});
-                p = p->next;
+    // unique - Erases all but the first element of every run of consecutive
+    // elements for which pred is true, and returns how many were erased
+    template <typename BinaryPredicate> size_type unique(BinaryPredicate pred) {
+        size_type removed = 0;
+        if (!m_before_head.next)
+            return removed;
+        for (NodeBase* first = m_before_head.next; first->next;) {
+            if (pred(as_node(first)->m_value, as_node(first->next)->m_value)) {
+                erase_after(iterator(first));
+                ++removed;
+            } else {
+                first = first->next;
             }
         }
+        return removed;
+    }
+
+    size_type unique() {
+        return unique(std::equal_to<>());
+    }
+
+    // resize() - Resizes the container to contain count elements
+    // - if the count is equal to the current size, does nothing.
+    // - if the current size > count, then the container is reduced to its
+    //   first count elements.
+    // - if the current size is less than count, then additional default-inserted
+    //   elements/copies of value are appended.
+    void resize(size_type count) {
+        NodeBase* last = &m_before_head;
+        for (size_type i = 0; i < std::min(count, m_size); ++i)
+            last = last->next;
+
+        if (count < m_size) {
+            while (last->next)
+                erase_after(iterator(last));
+            return;
+        }
+
+        while (m_size < count)
+            last = insert_after_helper(iterator(last), create_node()).m_current_node_ptr;
     }
 };
+
+// A forward_list whose nodes come from the thread-local node pool, so that
+// steady-state insert and erase never call malloc.
+template <typename T, bool TrackTail = false>
+using pooled_forward_list = forward_list<T, pool_allocator<T>, TrackTail>;
 } // namespace dev
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * @brief Compile-time hardening switch for the dev containers.
+ *
+ * Build with -DDEV_HARDENED=1 (or configure CMake with -DDEV_HARDENED=ON) to turn
+ * on precondition checks in unchecked accessors such as vector::operator[],
+ * front(), back() and pop_back(). A violated precondition prints the failed
+ * check and aborts; it never throws, so noexcept functions stay noexcept.
+ *
+ * When the switch is off (the default), DEV_HARDENING_ASSERT expands to nothing
+ * and the generated code is identical to a build without the checks.
+ */
+#ifndef DEV_HARDENED
+#define DEV_HARDENED 0
+#endif
+
+namespace dev::detail {
+
+[[noreturn, gnu::cold, gnu::noinline]] inline void hardening_failure(const char* file,
+                                                                   int line,
+                                                                   const char* check,
+                                                                   const char* message)
+{
+    std::fprintf(
+      stderr, "%s:%d: hardening check '%s' failed: %s\n", file, line, check, message);
+    std::abort();
+}
+
+} // namespace dev::detail
+
+#if DEV_HARDENED
+#define DEV_HARDENING_ASSERT(check, message)                                             \
+    do {                                                                                 \
+        if (!(check)) [[unlikely]]                                                       \
+            ::dev::detail::hardening_failure(__FILE__, __LINE__, #check, message);       \
+    } while (false)
+#else
+#define DEV_HARDENING_ASSERT(check, message) ((void)0)
+#endif
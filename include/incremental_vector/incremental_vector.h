@@ -0,0 +1,445 @@
+#pragma once
+
+#include "vector/vector.h"
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace dev {
+
+/**
+ * @brief A vector that spreads the cost of growing over the following
+ * push_backs, in the style of incremental hash-table resizing.
+ *
+ * When dev::vector is full, push_back relocates every element into the new
+ * block before it returns: with 10M elements that single call stalls for
+ * milliseconds. When incremental_vector is full, it allocates a block of twice
+ * the capacity and keeps the old block alive. New elements go straight into the
+ * new block, and every push_back then relocates at most MigrationStep of the old
+ * elements, starting from the back. Since the new block has room for as many
+ * push_backs as there are old elements, the migration is always finished before
+ * the next growth, and no single push_back is O(n).
+ *
+ * While a migration is pending, the elements [0, pending) live in the old block
+ * and the rest in the new one. Element access therefore costs one extra,
+ * well-predicted branch, and the elements are only contiguous once the migration
+ * is done: data() completes it first.
+ *
+ * T must be nothrow move constructible, since elements are relocated one at a
+ * time as a side effect of other operations.
+ */
+template<typename T, std::size_t MigrationStep = 4>
+    requires std::is_nothrow_move_constructible_v<T>
+class incremental_vector
+{
+    static_assert(MigrationStep > 0, "MigrationStep must be positive");
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+
+  private:
+    pointer m_elements{ nullptr };
+    size_type m_size{ 0 };
+    size_type m_capacity{ 0 };
+
+    // The block being migrated away from, and the number of elements still in it
+    pointer m_old_elements{ nullptr };
+    size_type m_pending{ 0 };
+
+    static pointer allocate_aux(size_type capacity)
+    {
+        return static_cast<pointer>(::operator new(sizeof(value_type) * capacity));
+    }
+
+    pointer address_aux(size_type n) const
+    {
+        return n < m_pending ? m_old_elements + n : m_elements + n;
+    }
+
+    /**
+     * @brief Relocates up to %count elements from the back of the old block into
+     * the new block, and frees the old block once it is empty.
+     */
+    void migrate_aux(size_type count) noexcept
+    {
+        size_type last = m_pending;
+        size_type first = m_pending > count ? m_pending - count : 0;
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (first != last)
+                std::memcpy(
+                  m_elements + first, m_old_elements + first, (last - first) * sizeof(T));
+        } else {
+            for (size_type i = first; i < last; ++i) {
+                std::construct_at(m_elements + i, std::move(m_old_elements[i]));
+                std::destroy_at(m_old_elements + i);
+            }
+        }
+        m_pending = first;
+
+        if (m_pending == 0 && m_old_elements) {
+            ::operator delete(m_old_elements);
+            m_old_elements = nullptr;
+        }
+    }
+
+    /**
+     * @brief Switches to a block of twice the capacity. The elements stay in the
+     * old block until they are migrated.
+     */
+    void grow_aux()
+    {
+        finish_growth();
+        size_type new_capacity = m_capacity ? 2 * m_capacity : 16;
+        pointer p = allocate_aux(new_capacity);
+        if (m_size == 0) {
+            // Nothing to migrate
+            ::operator delete(m_elements);
+        } else {
+            m_old_elements = m_elements;
+            m_pending = m_size;
+        }
+        m_elements = p;
+        m_capacity = new_capacity;
+    }
+
+    void destroy_all_aux() noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            std::destroy(m_old_elements, m_old_elements + m_pending);
+            std::destroy(m_elements + m_pending, m_elements + m_size);
+        }
+        ::operator delete(m_old_elements);
+        m_old_elements = nullptr;
+        m_pending = 0;
+        m_size = 0;
+    }
+
+  public:
+    /**
+     * @brief Random-access iterator over the elements. It stores the container
+     * and an index, so it is not invalidated by growth or migration.
+     */
+    template<bool Const>
+    class Iterator
+    {
+      public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const T&, T&>;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using container_pointer =
+          std::conditional_t<Const, const incremental_vector*, incremental_vector*>;
+
+        Iterator() = default;
+
+        Iterator(container_pointer container, size_type index)
+          : m_container{ container }
+          , m_index{ index }
+        {
+        }
+
+        /**
+         * @brief Conversion from a read/write iterator to a read-only one.
+         */
+        template<bool OtherConst>
+            requires(Const && !OtherConst)
+        Iterator(const Iterator<OtherConst>& other)
+          : m_container{ other.m_container }
+          , m_index{ other.m_index }
+        {
+        }
+
+        reference operator*() const { return (*m_container)[m_index]; }
+        pointer operator->() const { return &(*m_container)[m_index]; }
+        reference operator[](difference_type n) const { return (*m_container)[m_index + n]; }
+
+        Iterator& operator++()
+        {
+            ++m_index;
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto temp = *this;
+            ++m_index;
+            return temp;
+        }
+
+        Iterator& operator--()
+        {
+            --m_index;
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            auto temp = *this;
+            --m_index;
+            return temp;
+        }
+
+        Iterator& operator+=(difference_type n)
+        {
+            m_index += n;
+            return *this;
+        }
+
+        Iterator& operator-=(difference_type n)
+        {
+            m_index -= n;
+            return *this;
+        }
+
+        Iterator operator+(difference_type n) const { return Iterator(m_container, m_index + n); }
+        friend Iterator operator+(difference_type n, Iterator it) { return it + n; }
+        Iterator operator-(difference_type n) const { return Iterator(m_container, m_index - n); }
+
+        difference_type operator-(const Iterator& other) const
+        {
+            return static_cast<difference_type>(m_index) -
+                   static_cast<difference_type>(other.m_index);
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs)
+        {
+            return lhs.m_index == rhs.m_index;
+        }
+
+        friend auto operator<=>(const Iterator& lhs, const Iterator& rhs)
+        {
+            return lhs.m_index <=> rhs.m_index;
+        }
+
+      private:
+        friend Iterator<true>;
+        container_pointer m_container{ nullptr };
+        size_type m_index{ 0 };
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    // Constructors
+    /**
+     * @brief Creates an incremental_vector with no elements.
+     */
+    incremental_vector() = default;
+
+    /**
+     * @brief Creates an incremental_vector holding copies of the elements of the
+     * initializer list.
+     */
+    incremental_vector(std::initializer_list<T> values)
+      : incremental_vector()
+    {
+        reserve(values.size());
+        for (const auto& value : values)
+            push_back(value);
+    }
+
+    /**
+     * @brief Copy constructor. The copy is contiguous, with no pending migration.
+     */
+    incremental_vector(const incremental_vector& other)
+      : incremental_vector()
+    {
+        reserve(other.size());
+        for (const auto& value : other)
+            push_back(value);
+    }
+
+    incremental_vector(incremental_vector&& other) noexcept
+      : m_elements{ std::exchange(other.m_elements, nullptr) }
+      , m_size{ std::exchange(other.m_size, 0) }
+      , m_capacity{ std::exchange(other.m_capacity, 0) }
+      , m_old_elements{ std::exchange(other.m_old_elements, nullptr) }
+      , m_pending{ std::exchange(other.m_pending, 0) }
+    {
+    }
+
+    incremental_vector& operator=(const incremental_vector& other)
+    {
+        if (this != &other)
+            incremental_vector(other).swap(*this);
+        return *this;
+    }
+
+    incremental_vector& operator=(incremental_vector&& other) noexcept
+    {
+        incremental_vector(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~incremental_vector()
+    {
+        destroy_all_aux();
+        ::operator delete(m_elements);
+    }
+
+    // Capacity related member functions
+    [[nodiscard]] size_type size() const { return m_size; }
+    [[nodiscard]] size_type capacity() const { return m_capacity; }
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    /**
+     * @brief Returns the number of elements still waiting in the old block.
+     */
+    [[nodiscard]] size_type pending_migration() const { return m_pending; }
+
+    /**
+     * @brief Relocates all elements that are still in the old block. Call it at a
+     * quiet moment to get a contiguous vector without waiting for further
+     * push_backs.
+     */
+    void finish_growth() noexcept { migrate_aux(m_pending); }
+
+    /**
+     * @brief Reserves room for at least %new_capacity elements. Unlike growth
+     * through push_back, this relocates all elements at once.
+     */
+    void reserve(size_type new_capacity)
+    {
+        if (new_capacity <= m_capacity)
+            return;
+        finish_growth();
+        pointer p = allocate_aux(new_capacity);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (m_size)
+                std::memcpy(p, m_elements, m_size * sizeof(T));
+        } else {
+            std::uninitialized_move(m_elements, m_elements + m_size, p);
+            std::destroy(m_elements, m_elements + m_size);
+        }
+        ::operator delete(m_elements);
+        m_elements = p;
+        m_capacity = new_capacity;
+    }
+
+    // Element access
+    reference operator[](size_type n)
+    {
+        DEV_HARDENING_ASSERT(n < m_size, "incremental_vector index out of bounds");
+        return *address_aux(n);
+    }
+
+    const_reference operator[](size_type n) const
+    {
+        DEV_HARDENING_ASSERT(n < m_size, "incremental_vector index out of bounds");
+        return *address_aux(n);
+    }
+
+    reference at(size_type n)
+    {
+        if (n < m_size)
+            return (*this)[n];
+        throw std::out_of_range("Index out of bounds!");
+    }
+
+    const_reference at(size_type n) const
+    {
+        if (n < m_size)
+            return (*this)[n];
+        throw std::out_of_range("Index out of bounds!");
+    }
+
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[m_size - 1]; }
+    const_reference back() const { return (*this)[m_size - 1]; }
+
+    /**
+     * @brief Returns a pointer to the contiguous elements, finishing any pending
+     * migration first.
+     */
+    pointer data() noexcept
+    {
+        finish_growth();
+        return m_elements;
+    }
+
+    // Iterators
+    iterator begin() { return iterator(this, 0); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return iterator(this, m_size); }
+    const_iterator end() const { return const_iterator(this, m_size); }
+    const_iterator cend() const { return end(); }
+
+    // Modifiers
+    /**
+     * @brief Constructs an element in place at the end, then migrates up to
+     * MigrationStep old elements.
+     */
+    template<typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (m_size == m_capacity)
+            grow_aux();
+
+        // The arguments may refer to an element still in the old block, so the
+        // migration step only runs once the new element is constructed.
+        pointer p = std::construct_at(m_elements + m_size, std::forward<Args>(args)...);
+        ++m_size;
+        if (m_pending)
+            migrate_aux(MigrationStep);
+        return *p;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back()
+    {
+        DEV_HARDENING_ASSERT(m_size != 0,
+                             "pop_back() called on an empty incremental_vector");
+        --m_size;
+        std::destroy_at(address_aux(m_size));
+        m_pending = std::min(m_pending, m_size);
+        if (m_pending == 0)
+            migrate_aux(0);
+    }
+
+    /**
+     * @brief Destroys all elements. The capacity is left unchanged.
+     */
+    void clear() noexcept { destroy_all_aux(); }
+
+    void swap(incremental_vector& other) noexcept
+    {
+        std::swap(m_elements, other.m_elements);
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_old_elements, other.m_old_elements);
+        std::swap(m_pending, other.m_pending);
+    }
+
+    /**
+     * @brief Copies the elements into a dev::vector.
+     */
+    vector<T> to_vector() const
+    {
+        vector<T> result;
+        result.reserve(m_size);
+        for (const auto& value : *this)
+            result.push_back(value);
+        return result;
+    }
+};
+
+} // namespace dev
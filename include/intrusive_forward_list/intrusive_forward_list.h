@@ -0,0 +1,316 @@
+#pragma once
+
+#include "hardening/hardening.h"
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace dev {
+
+/**
+ * @brief The link that an element embeds to be put in an intrusive_forward_list.
+ *
+ * An element can be in as many lists at a time as it has hooks. Copying an
+ * element does not copy its links.
+ */
+struct intrusive_forward_list_hook
+{
+    intrusive_forward_list_hook* next{ nullptr };
+
+    intrusive_forward_list_hook() = default;
+    intrusive_forward_list_hook(const intrusive_forward_list_hook&) noexcept {}
+    intrusive_forward_list_hook& operator=(const intrusive_forward_list_hook&) noexcept
+    {
+        return *this;
+    }
+};
+
+/**
+ * @brief A singly-linked list of elements that it does not own.
+ *
+ * The links are embedded in the elements through the %Hook member, so
+ * inserting, erasing and splicing never allocate nor copy:
+ *
+ *     struct order {
+ *         std::uint64_t id;
+ *         dev::intrusive_forward_list_hook level_hook;
+ *     };
+ *     dev::intrusive_forward_list<order, &order::level_hook> level;
+ *
+ * The elements must outlive their membership in the list, and an element must
+ * be in at most one list per hook. Destroying or clearing the list leaves the
+ * elements untouched.
+ */
+template<typename T, intrusive_forward_list_hook T::*Hook>
+class intrusive_forward_list
+{
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+
+  private:
+    using hook = intrusive_forward_list_hook;
+
+    hook m_before_head;
+    size_type m_size{ 0 };
+
+    /**
+     * @brief Returns the offset of the hook within T, so that an element can be
+     * found from its hook. It folds to a constant.
+     */
+    static std::ptrdiff_t hook_offset_aux() noexcept
+    {
+        union probe
+        {
+            probe() {}
+            ~probe() {}
+            T object;
+        } p;
+        return reinterpret_cast<const std::byte*>(&(p.object.*Hook)) -
+               reinterpret_cast<const std::byte*>(&p.object);
+    }
+
+    static T* element_aux(hook* link) noexcept
+    {
+        return reinterpret_cast<T*>(reinterpret_cast<std::byte*>(link) - hook_offset_aux());
+    }
+
+  public:
+    template<bool Const>
+    class Iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+      private:
+        friend class intrusive_forward_list;
+        friend Iterator<true>;
+
+        hook* m_link{ nullptr };
+
+        explicit Iterator(hook* link) noexcept
+          : m_link(link)
+        {
+        }
+
+      public:
+        Iterator() = default;
+
+        template<bool OtherConst>
+            requires(Const && !OtherConst)
+        Iterator(const Iterator<OtherConst>& other) noexcept
+          : m_link(other.m_link)
+        {
+        }
+
+        reference operator*() const noexcept { return *element_aux(m_link); }
+        pointer operator->() const noexcept { return element_aux(m_link); }
+
+        Iterator& operator++() noexcept
+        {
+            m_link = m_link->next;
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            auto temp = *this;
+            m_link = m_link->next;
+            return temp;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept
+        {
+            return lhs.m_link == rhs.m_link;
+        }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    intrusive_forward_list() = default;
+
+    intrusive_forward_list(const intrusive_forward_list&) = delete;
+    intrusive_forward_list& operator=(const intrusive_forward_list&) = delete;
+
+    intrusive_forward_list(intrusive_forward_list&& other) noexcept { swap(other); }
+
+    intrusive_forward_list& operator=(intrusive_forward_list&& other) noexcept
+    {
+        clear();
+        swap(other);
+        return *this;
+    }
+
+    void swap(intrusive_forward_list& other) noexcept
+    {
+        std::swap(m_before_head.next, other.m_before_head.next);
+        std::swap(m_size, other.m_size);
+    }
+
+    friend void swap(intrusive_forward_list& lhs, intrusive_forward_list& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    size_type size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_before_head.next == nullptr; }
+
+    /**
+     * @brief Returns an iterator that points before the first element, for use
+     * with insert_after, erase_after and splice_after. It must not be
+     * dereferenced.
+     */
+    iterator before_begin() noexcept { return iterator(&m_before_head); }
+    const_iterator before_begin() const noexcept
+    {
+        return const_iterator(const_cast<hook*>(&m_before_head));
+    }
+    const_iterator cbefore_begin() const noexcept { return before_begin(); }
+
+    iterator begin() noexcept { return iterator(m_before_head.next); }
+    const_iterator begin() const noexcept { return const_iterator(m_before_head.next); }
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    iterator end() noexcept { return iterator(nullptr); }
+    const_iterator end() const noexcept { return const_iterator(nullptr); }
+    const_iterator cend() const noexcept { return end(); }
+
+    /**
+     * @brief Returns an iterator to %value, which must be in this list.
+     */
+    iterator iterator_to(T& value) noexcept { return iterator(&(value.*Hook)); }
+    const_iterator iterator_to(const T& value) const noexcept
+    {
+        return const_iterator(const_cast<hook*>(&(value.*Hook)));
+    }
+
+    reference front() noexcept
+    {
+        DEV_HARDENING_ASSERT(!empty(), "front() called on an empty intrusive_forward_list");
+        return *begin();
+    }
+
+    const_reference front() const noexcept
+    {
+        DEV_HARDENING_ASSERT(!empty(), "front() called on an empty intrusive_forward_list");
+        return *begin();
+    }
+
+    /**
+     * @brief Links %value after %position. O(1).
+     */
+    iterator insert_after(const_iterator position, T& value) noexcept
+    {
+        hook* link = &(value.*Hook);
+        link->next = position.m_link->next;
+        position.m_link->next = link;
+        ++m_size;
+        return iterator(link);
+    }
+
+    void push_front(T& value) noexcept { insert_after(before_begin(), value); }
+
+    /**
+     * @brief Unlinks the element after %position, without destroying it. O(1).
+     * @return An iterator to the element that followed the unlinked one.
+     */
+    iterator erase_after(const_iterator position) noexcept
+    {
+        DEV_HARDENING_ASSERT(position.m_link && position.m_link->next,
+                             "intrusive_forward_list::erase_after() has nothing to erase");
+        hook* link = position.m_link->next;
+        position.m_link->next = std::exchange(link->next, nullptr);
+        --m_size;
+        return iterator(position.m_link->next);
+    }
+
+    /**
+     * @brief Unlinks the elements in (%first, %last). O(distance).
+     */
+    iterator erase_after(const_iterator first, const_iterator last) noexcept
+    {
+        while (first.m_link->next != last.m_link)
+            erase_after(first);
+        return iterator(last.m_link);
+    }
+
+    void pop_front() noexcept
+    {
+        DEV_HARDENING_ASSERT(!empty(), "pop_front() called on an empty intrusive_forward_list");
+        erase_after(before_begin());
+    }
+
+    /**
+     * @brief Unlinks all elements. O(1): the links left in the elements are
+     * overwritten when they are inserted again.
+     */
+    void clear() noexcept
+    {
+        m_before_head.next = nullptr;
+        m_size = 0;
+    }
+
+    /**
+     * @brief Moves the element after %before_it in %other to after %position.
+     * O(1). %other may be this list.
+     */
+    void splice_after(const_iterator position,
+                      intrusive_forward_list& other,
+                      const_iterator before_it) noexcept
+    {
+        hook* link = before_it.m_link->next;
+        if (position.m_link == before_it.m_link || position.m_link == link)
+            return;
+        before_it.m_link->next = link->next;
+        link->next = position.m_link->next;
+        position.m_link->next = link;
+        --other.m_size;
+        ++m_size;
+    }
+
+    /**
+     * @brief Moves the elements in (%first, %last) of %other to after
+     * %position. Linear in the number of moved elements, which have to be
+     * counted and walked to find the last one.
+     */
+    void splice_after(const_iterator position,
+                      intrusive_forward_list& other,
+                      const_iterator first,
+                      const_iterator last) noexcept
+    {
+        if (first.m_link->next == last.m_link)
+            return;
+        hook* head = first.m_link->next;
+        hook* tail = head;
+        size_type count = 1;
+        for (; tail->next != last.m_link; tail = tail->next)
+            ++count;
+        first.m_link->next = last.m_link;
+        tail->next = position.m_link->next;
+        position.m_link->next = head;
+        other.m_size -= count;
+        m_size += count;
+    }
+
+    /**
+     * @brief Moves all elements of %other to after %position. Linear in the
+     * size of %other.
+     */
+    void splice_after(const_iterator position, intrusive_forward_list& other) noexcept
+    {
+        splice_after(position, other, other.before_begin(), other.end());
+    }
+};
+
+} // namespace dev
@@ -0,0 +1,444 @@
+#pragma once
+
+#include "vector/vector.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <ranges>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dev {
+
+/**
+ * @brief A vector whose elements live in a memory-mapped file.
+ *
+ * Opening an existing file maps it in place: no element is read or copied until
+ * it is first touched, so a multi-GB array of ticks is available immediately.
+ * The element-access and iterator API mirrors dev::vector, and the iterators are
+ * the same contiguous dev::Iterator<T>.
+ *
+ * The file is a raw array of T with no header, so it must only hold trivially
+ * copyable types. While a writable mmap_vector is open, the file is grown ahead
+ * of size() (ftruncate + mremap, doubling the capacity). It is trimmed back to
+ * size() * sizeof(T) bytes by shrink_to_fit() and on destruction.
+ */
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+class mmap_vector
+{
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = Iterator<T>;
+    using const_iterator = Iterator<const T>;
+
+    /**
+     * @brief How the file is opened. A read_write file is created if it does not
+     * exist.
+     */
+    enum class open_mode
+    {
+        read_only,
+        read_write
+    };
+
+    /**
+     * @brief The expected access pattern, passed on to madvise().
+     */
+    enum class access_advice
+    {
+        normal,
+        sequential,
+        random,
+        will_need
+    };
+
+    /**
+     * @brief Options for opening the file.
+     * %populate pre-faults the whole mapping (MAP_POPULATE on Linux), which trades
+     * a slower open for no page faults afterwards.
+     */
+    struct options
+    {
+        open_mode mode{ open_mode::read_write };
+        access_advice advice{ access_advice::normal };
+        bool populate{ false };
+    };
+
+  private:
+    int m_fd{ -1 };
+    pointer m_elements{ nullptr };
+    size_type m_size{ 0 };
+    size_type m_capacity{ 0 };
+    options m_options;
+
+    // Start with one page worth of elements
+    static constexpr size_type initial_capacity =
+      sizeof(value_type) < 4096 ? 4096 / sizeof(value_type) : 1;
+
+    [[noreturn]] static void throw_errno_aux(const char* what)
+    {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    [[nodiscard]] bool writable() const { return m_options.mode == open_mode::read_write; }
+
+    void check_writable_aux() const
+    {
+        if (!writable())
+            throw std::logic_error("mmap_vector is read-only");
+    }
+
+    /**
+     * @brief Maps the first %capacity elements of the file.
+     */
+    void map_aux(size_type capacity)
+    {
+        int prot = PROT_READ | (writable() ? PROT_WRITE : 0);
+        int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+        if (m_options.populate)
+            flags |= MAP_POPULATE;
+#endif
+        void* p = ::mmap(nullptr, capacity * sizeof(value_type), prot, flags, m_fd, 0);
+        if (p == MAP_FAILED)
+            throw_errno_aux("mmap");
+
+        m_elements = static_cast<pointer>(p);
+        m_capacity = capacity;
+        advise_aux();
+    }
+
+    void unmap_aux() noexcept
+    {
+        if (m_elements)
+            ::munmap(m_elements, m_capacity * sizeof(value_type));
+        m_elements = nullptr;
+        m_capacity = 0;
+    }
+
+    /**
+     * @brief Resizes the file and the mapping to exactly %new_capacity elements.
+     */
+    void remap_aux(size_type new_capacity)
+    {
+        if (::ftruncate(m_fd, new_capacity * sizeof(value_type)) != 0)
+            throw_errno_aux("ftruncate");
+
+        if (!m_elements) {
+            if (new_capacity)
+                map_aux(new_capacity);
+            return;
+        }
+        if (!new_capacity) {
+            unmap_aux();
+            return;
+        }
+
+#ifdef __linux__
+        void* p = ::mremap(m_elements,
+                           m_capacity * sizeof(value_type),
+                           new_capacity * sizeof(value_type),
+                           MREMAP_MAYMOVE);
+        if (p == MAP_FAILED)
+            throw_errno_aux("mremap");
+        m_elements = static_cast<pointer>(p);
+        m_capacity = new_capacity;
+        advise_aux();
+#else
+        unmap_aux();
+        map_aux(new_capacity);
+#endif
+    }
+
+    void advise_aux() noexcept
+    {
+        int advice = MADV_NORMAL;
+        switch (m_options.advice) {
+            case access_advice::sequential:
+                advice = MADV_SEQUENTIAL;
+                break;
+            case access_advice::random:
+                advice = MADV_RANDOM;
+                break;
+            case access_advice::will_need:
+                advice = MADV_WILLNEED;
+                break;
+            default:
+                break;
+        }
+        // Only a hint: failure is not an error.
+        ::madvise(m_elements, m_capacity * sizeof(value_type), advice);
+    }
+
+    void close_aux() noexcept
+    {
+        if (m_fd < 0)
+            return;
+        unmap_aux();
+        if (writable()) {
+            // Nothing sensible to do on failure in a destructor
+            [[maybe_unused]] int rc = ::ftruncate(m_fd, m_size * sizeof(value_type));
+        }
+        ::close(m_fd);
+        m_fd = -1;
+        m_size = 0;
+    }
+
+  public:
+    // Constructors
+    /**
+     * @brief Creates an mmap_vector that is not backed by a file.
+     */
+    mmap_vector() = default;
+
+    /**
+     * @brief Maps the file at %path. Its length must be a multiple of sizeof(T).
+     * @throws std::system_error if the file cannot be opened or mapped.
+     * @throws std::invalid_argument if the file length is not a multiple of
+     * sizeof(T).
+     */
+    explicit mmap_vector(const std::filesystem::path& path, options opts = {})
+      : m_options{ opts }
+    {
+        int flags = writable() ? (O_RDWR | O_CREAT) : O_RDONLY;
+        m_fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+        if (m_fd < 0)
+            throw_errno_aux("open");
+
+        try {
+            struct stat st;
+            if (::fstat(m_fd, &st) != 0)
+                throw_errno_aux("fstat");
+
+            size_type bytes = static_cast<size_type>(st.st_size);
+            if (bytes % sizeof(value_type) != 0)
+                throw std::invalid_argument(
+                  "mmap_vector: file length is not a multiple of the element size");
+
+            m_size = bytes / sizeof(value_type);
+            if (m_size)
+                map_aux(m_size);
+        } catch (...) {
+            ::close(m_fd);
+            m_fd = -1;
+            throw;
+        }
+    }
+
+    // Memory mappings are unique resources.
+    mmap_vector(const mmap_vector&) = delete;
+    mmap_vector& operator=(const mmap_vector&) = delete;
+
+    /**
+     * @brief Move constructor. Transfers the mapping and the file descriptor.
+     */
+    mmap_vector(mmap_vector&& other) noexcept
+      : m_fd{ std::exchange(other.m_fd, -1) }
+      , m_elements{ std::exchange(other.m_elements, nullptr) }
+      , m_size{ std::exchange(other.m_size, 0) }
+      , m_capacity{ std::exchange(other.m_capacity, 0) }
+      , m_options{ other.m_options }
+    {
+    }
+
+    mmap_vector& operator=(mmap_vector&& other) noexcept
+    {
+        mmap_vector(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    void swap(mmap_vector& other) noexcept
+    {
+        using std::swap;
+        swap(m_fd, other.m_fd);
+        swap(m_elements, other.m_elements);
+        swap(m_size, other.m_size);
+        swap(m_capacity, other.m_capacity);
+        swap(m_options, other.m_options);
+    }
+
+    /**
+     * @brief Unmaps the file and trims it to size() elements.
+     */
+    ~mmap_vector() { close_aux(); }
+
+    // Capacity related member functions
+    [[nodiscard]] size_type size() const { return m_size; }
+    [[nodiscard]] size_type capacity() const { return m_capacity; }
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+    [[nodiscard]] bool is_open() const { return m_fd >= 0; }
+
+    /**
+     * @brief Grows the file and the mapping to hold at least %new_capacity
+     * elements.
+     * @throws std::logic_error if the file was opened read-only.
+     */
+    void reserve(size_type new_capacity)
+    {
+        check_writable_aux();
+        if (new_capacity > capacity())
+            remap_aux(new_capacity);
+    }
+
+    /**
+     * @brief Trims the file and the mapping to size() elements, so that the file
+     * can be read as-is by another process.
+     */
+    void shrink_to_fit()
+    {
+        check_writable_aux();
+        if (m_capacity != m_size)
+            remap_aux(m_size);
+    }
+
+    /**
+     * @brief Flushes the elements to the file (msync + fsync).
+     * @note The file is longer than size() elements while spare capacity
+     * exists. Call shrink_to_fit() first for a file of exactly size() elements.
+     */
+    void sync()
+    {
+        if (m_elements && writable() &&
+            ::msync(m_elements, m_capacity * sizeof(value_type), MS_SYNC) != 0)
+            throw_errno_aux("msync");
+        if (m_fd >= 0 && writable() && ::fsync(m_fd) != 0)
+            throw_errno_aux("fsync");
+    }
+
+    // Element access
+    pointer data() noexcept { return m_elements; }
+    const_pointer data() const noexcept { return m_elements; }
+
+    reference operator[](size_type n)
+    {
+        DEV_HARDENING_ASSERT(n < m_size, "mmap_vector index out of bounds");
+        return m_elements[n];
+    }
+
+    const_reference operator[](size_type n) const
+    {
+        DEV_HARDENING_ASSERT(n < m_size, "mmap_vector index out of bounds");
+        return m_elements[n];
+    }
+
+    reference at(size_type n)
+    {
+        if (n < m_size)
+            return m_elements[n];
+        throw std::out_of_range("Index out of bounds!");
+    }
+
+    const_reference at(size_type n) const
+    {
+        if (n < m_size)
+            return m_elements[n];
+        throw std::out_of_range("Index out of bounds!");
+    }
+
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[m_size - 1]; }
+    const_reference back() const { return (*this)[m_size - 1]; }
+
+    // Iterators
+    iterator begin() { return iterator(m_elements); }
+    const_iterator begin() const { return const_iterator(m_elements); }
+    const_iterator cbegin() const noexcept { return const_iterator(m_elements); }
+    iterator end() { return iterator(m_elements + m_size); }
+    const_iterator end() const { return const_iterator(m_elements + m_size); }
+    const_iterator cend() const noexcept { return const_iterator(m_elements + m_size); }
+
+    // Modifiers
+    /**
+     * @brief Appends a copy of %value, doubling the capacity when full.
+     */
+    void push_back(const_reference value)
+    {
+        check_writable_aux();
+        if (m_size == m_capacity) {
+            // %value may live in the mapping that is about to move
+            value_type copy = value;
+            remap_aux(m_capacity ? 2 * m_capacity : initial_capacity);
+            m_elements[m_size++] = copy;
+            return;
+        }
+        m_elements[m_size++] = value;
+    }
+
+    template<typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        push_back(value_type(std::forward<Args>(args)...));
+        return back();
+    }
+
+    /**
+     * @brief Appends the elements of %rg with a single grow and, for contiguous
+     * ranges, a single memcpy.
+     */
+    template<std::ranges::sized_range R>
+        requires std::is_convertible_v<std::ranges::range_reference_t<R>, T>
+    void append_range(R&& rg)
+    {
+        check_writable_aux();
+        size_type n = std::ranges::size(rg);
+        if (m_size + n > m_capacity)
+            remap_aux(std::max(m_size + n, 2 * m_capacity));
+
+        if constexpr (std::ranges::contiguous_range<R> &&
+                      std::is_same_v<std::ranges::range_value_t<R>, T>) {
+            if (n)
+                std::memcpy(m_elements + m_size, std::ranges::data(rg), n * sizeof(value_type));
+        } else {
+            std::ranges::copy(rg, m_elements + m_size);
+        }
+        m_size += n;
+    }
+
+    void pop_back()
+    {
+        DEV_HARDENING_ASSERT(m_size != 0, "pop_back() called on an empty mmap_vector");
+        check_writable_aux();
+        --m_size;
+    }
+
+    /**
+     * @brief Resizes the container to %new_size elements. New elements are
+     * zero-filled.
+     */
+    void resize(size_type new_size)
+    {
+        check_writable_aux();
+        if (new_size > m_capacity)
+            remap_aux(new_size);
+        if (new_size > m_size)
+            std::memset(m_elements + m_size, 0, (new_size - m_size) * sizeof(value_type));
+        m_size = new_size;
+    }
+
+    /**
+     * @brief Copies the elements into a dev::vector.
+     */
+    vector<T> to_vector() const
+    {
+        vector<T> result;
+        result.append_range(*this);
+        return result;
+    }
+};
+
+} // namespace dev
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace dev {
+
+/**
+ * @brief A pool of fixed-size memory blocks for node-based containers.
+ *
+ * Blocks are carved out of slabs of contiguous memory and recycled through an
+ * intrusive free list, so once the pool has warmed up, allocating and freeing
+ * a block is a couple of pointer moves and never calls malloc.
+ *
+ * Every thread has its own free list, so the fast path takes no lock. A block
+ * freed on another thread than the one that allocated it simply joins the free
+ * list of the freeing thread. A thread whose free list grows past
+ * max_local_blocks hands half of it back to a shared free list, from which
+ * other threads refill before they allocate a new slab, so producer/consumer
+ * patterns do not grow the pool without bound. The free list of an exiting
+ * thread is handed back in the same way.
+ *
+ * Slabs are never returned to the system: a block may outlive the thread that
+ * allocated it, and the pool has no way of telling when a slab is unused.
+ */
+template<std::size_t BlockSize, std::size_t BlockAlign>
+class node_pool
+{
+  private:
+    struct free_block
+    {
+        free_block* next;
+    };
+
+  public:
+    static constexpr std::size_t block_align = std::max(BlockAlign, alignof(free_block));
+    static constexpr std::size_t block_size =
+      (std::max(BlockSize, sizeof(free_block)) + block_align - 1) / block_align * block_align;
+
+    static constexpr std::size_t min_slab_blocks = 64;
+    static constexpr std::size_t max_slab_blocks = 4096;
+    static constexpr std::size_t max_local_blocks = 2 * max_slab_blocks;
+
+  private:
+    /**
+     * @brief The free list shared by all threads, and every slab ever allocated.
+     * It is never destroyed, so that blocks can be freed during static
+     * destruction.
+     */
+    struct shared_state
+    {
+        std::mutex mutex;
+        free_block* free{ nullptr };
+        std::size_t free_count{ 0 };
+        std::vector<void*> slabs;
+    };
+
+    /**
+     * @brief The free list of a thread. It is trivially destructible, so it
+     * stays usable until the thread is gone, even after retire_guard has run.
+     */
+    struct local_state
+    {
+        free_block* free;
+        std::size_t free_count;
+        std::size_t next_slab_blocks;
+        bool retired;
+    };
+
+    static shared_state& shared() noexcept
+    {
+        static shared_state* state = new shared_state;
+        return *state;
+    }
+
+    static local_state& local() noexcept
+    {
+        thread_local local_state state{ nullptr, 0, min_slab_blocks, false };
+        return state;
+    }
+
+    /**
+     * @brief Hands the free list of an exiting thread over to the shared list.
+     * Blocks freed by the thread afterwards go straight to the shared list.
+     */
+    struct retire_guard
+    {
+        ~retire_guard()
+        {
+            local_state& l = local();
+            give_back_aux(l, l.free_count);
+            l.retired = true;
+        }
+    };
+
+    /**
+     * @brief Makes sure that the free list of the calling thread is handed back
+     * when the thread exits.
+     */
+    static void register_thread_aux() noexcept
+    {
+        static thread_local retire_guard guard;
+        (void)guard;
+    }
+
+    /**
+     * @brief Moves %count blocks from the front of the local free list to the
+     * shared one.
+     */
+    static void give_back_aux(local_state& l, std::size_t count) noexcept
+    {
+        if (count == 0)
+            return;
+        free_block* first = l.free;
+        free_block* last = first;
+        for (std::size_t i = 1; i < count; ++i)
+            last = last->next;
+        l.free = last->next;
+        l.free_count -= count;
+
+        shared_state& s = shared();
+        std::lock_guard lock(s.mutex);
+        last->next = s.free;
+        s.free = first;
+        s.free_count += count;
+    }
+
+    /**
+     * @brief Refills an empty local free list, from the shared list if it has
+     * blocks, otherwise from a new slab.
+     */
+    static void refill_aux(local_state& l)
+    {
+        register_thread_aux();
+        shared_state& s = shared();
+        std::lock_guard lock(s.mutex);
+        if (s.free) {
+            // Take at most a slab worth of blocks, so that the other threads
+            // get their share as well
+            std::size_t count = std::min(s.free_count, l.next_slab_blocks);
+            free_block* last = s.free;
+            for (std::size_t i = 1; i < count; ++i)
+                last = last->next;
+            l.free = std::exchange(s.free, last->next);
+            last->next = nullptr;
+            l.free_count = count;
+            s.free_count -= count;
+            return;
+        }
+
+        std::size_t count = l.next_slab_blocks;
+        s.slabs.reserve(s.slabs.size() + 1);
+        auto* slab = static_cast<std::byte*>(
+          ::operator new(count * block_size, std::align_val_t{ block_align }));
+        s.slabs.push_back(slab);
+        for (std::size_t i = count; i > 0; --i) {
+            auto* block = reinterpret_cast<free_block*>(slab + (i - 1) * block_size);
+            block->next = l.free;
+            l.free = block;
+        }
+        l.free_count = count;
+        l.next_slab_blocks = std::min(2 * count, max_slab_blocks);
+    }
+
+  public:
+    /**
+     * @brief Returns a block of block_size bytes, aligned to block_align.
+     * @throws std::bad_alloc if a new slab is needed and cannot be allocated.
+     */
+    static void* allocate()
+    {
+        local_state& l = local();
+        if (!l.free) [[unlikely]] {
+            if (l.retired) {
+                // Called from a thread-local destructor, after the handover
+                shared_state& s = shared();
+                std::lock_guard lock(s.mutex);
+                if (s.free) {
+                    --s.free_count;
+                    return std::exchange(s.free, s.free->next);
+                }
+                return ::operator new(block_size, std::align_val_t{ block_align });
+            }
+            refill_aux(l);
+        }
+        --l.free_count;
+        return std::exchange(l.free, l.free->next);
+    }
+
+    /**
+     * @brief Returns %p, obtained from allocate() on any thread, to the pool.
+     */
+    static void deallocate(void* p) noexcept
+    {
+        local_state& l = local();
+        auto* block = static_cast<free_block*>(p);
+        if (l.retired) [[unlikely]] {
+            shared_state& s = shared();
+            std::lock_guard lock(s.mutex);
+            block->next = s.free;
+            s.free = block;
+            ++s.free_count;
+            return;
+        }
+        if (l.free_count == 0) [[unlikely]]
+            register_thread_aux();
+        block->next = l.free;
+        l.free = block;
+        if (++l.free_count > max_local_blocks) [[unlikely]]
+            give_back_aux(l, l.free_count / 2);
+    }
+
+    /**
+     * @brief Returns the number of blocks in the free list of the calling
+     * thread.
+     */
+    static std::size_t local_free_count() noexcept { return local().free_count; }
+};
+
+/**
+ * @brief A stateless allocator that takes single objects from the thread-local
+ * node_pool for their size and alignment. Arrays (n > 1) are forwarded to
+ * %std::allocator.
+ *
+ *     dev::forward_list<Order, dev::pool_allocator<Order>> level;
+ *
+ * Containers rebind it to their node type, so the pool is sized for the nodes.
+ */
+template<typename T>
+class pool_allocator
+{
+  public:
+    using value_type = T;
+    using pool = node_pool<sizeof(T), alignof(T)>;
+
+    pool_allocator() = default;
+
+    template<typename U>
+    pool_allocator(const pool_allocator<U>&) noexcept
+    {
+    }
+
+    [[nodiscard]] T* allocate(std::size_t n)
+    {
+        if (n == 1) [[likely]]
+            return static_cast<T*>(pool::allocate());
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        if (n == 1) [[likely]]
+            pool::deallocate(p);
+        else
+            std::allocator<T>().deallocate(p, n);
+    }
+
+    friend bool operator==(const pool_allocator&, const pool_allocator&) { return true; }
+};
+
+} // namespace dev
@@ -0,0 +1,451 @@
+#pragma once
+
+#include "flat_hash_map/flat_hash_map.h"
+#include "hardening/hardening.h"
+#include "intrusive_forward_list/intrusive_forward_list.h"
+#include "node_pool/node_pool.h"
+#include "vector/vector.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+namespace dev {
+
+/**
+ * @brief A limit order book for one instrument, with price-time priority.
+ *
+ * Prices are integer ticks within a range fixed at construction, so that each
+ * side is a dev::vector of price levels indexed by tick, and finding a level
+ * is an array access. Every level keeps its orders in arrival order in a
+ * dev::intrusive_forward_list, appending through a pointer to its last order.
+ * Orders are looked up by id in a dev::flat_hash_map, and come from a
+ * dev::node_pool.
+ *
+ * A singly-linked list cannot unlink an order in O(1) without its
+ * predecessor, so cancel() only marks the order dead, by zeroing its quantity.
+ * Dead orders are dropped when they reach the front of their level during
+ * matching, when the level has no live order left, or when they outnumber the
+ * live orders of the level, which keeps cancellation O(1) amortized.
+ *
+ * An incoming order matches the resting orders of the other side from the
+ * best price, and within a price from the oldest order, as long as its limit
+ * price allows. Every fill is reported to the %on_trade callback of the call
+ * that caused it.
+ */
+class order_book
+{
+  public:
+    using id_type = std::uint64_t;
+    using price_type = std::int64_t;
+    using quantity_type = std::uint64_t;
+    using size_type = std::size_t;
+
+    enum class side : std::uint8_t
+    {
+        buy,
+        sell
+    };
+
+    /**
+     * @brief A fill between a resting order (the maker) and an incoming one
+     * (the taker), at the price of the resting order.
+     */
+    struct trade
+    {
+        id_type maker_id;
+        id_type taker_id;
+        price_type price;
+        quantity_type quantity;
+
+        friend bool operator==(const trade&, const trade&) = default;
+    };
+
+  private:
+    struct order
+    {
+        intrusive_forward_list_hook hook;
+        id_type id;
+        price_type price;
+        // 0 once the order is cancelled or filled
+        quantity_type quantity;
+        side order_side;
+    };
+
+    using order_list = intrusive_forward_list<order, &order::hook>;
+
+    struct level
+    {
+        order_list orders;
+        order* tail{ nullptr };
+        quantity_type quantity{ 0 };
+        std::uint32_t live{ 0 };
+        std::uint32_t dead{ 0 };
+    };
+
+    struct no_trade_listener
+    {
+        void operator()(const trade&) const noexcept {}
+    };
+
+    price_type m_min_price;
+    dev::vector<level> m_bids;
+    dev::vector<level> m_asks;
+    // Indices of the best levels: the highest live bid, or -1, and the lowest
+    // live ask, or the number of levels
+    std::ptrdiff_t m_best_bid{ -1 };
+    std::ptrdiff_t m_best_ask;
+    dev::flat_hash_map<id_type, order*> m_orders;
+    [[no_unique_address]] pool_allocator<order> m_alloc;
+
+    std::ptrdiff_t num_levels() const noexcept
+    {
+        return static_cast<std::ptrdiff_t>(m_bids.size());
+    }
+
+    std::ptrdiff_t index_of(price_type price) const noexcept
+    {
+        return static_cast<std::ptrdiff_t>(price - m_min_price);
+    }
+
+    price_type price_of(std::ptrdiff_t index) const noexcept
+    {
+        return m_min_price + index;
+    }
+
+    dev::vector<level>& levels(side s) noexcept
+    {
+        return s == side::buy ? m_bids : m_asks;
+    }
+    const dev::vector<level>& levels(side s) const noexcept
+    {
+        return s == side::buy ? m_bids : m_asks;
+    }
+
+    order* create_order_aux(id_type id, side s, price_type price, quantity_type quantity)
+    {
+        order* o = m_alloc.allocate(1);
+        return std::construct_at(o, order{ {}, id, price, quantity, s });
+    }
+
+    void destroy_order_aux(order* o) noexcept
+    {
+        std::destroy_at(o);
+        m_alloc.deallocate(o, 1);
+    }
+
+    /**
+     * @brief Frees the dead orders at the front of %l.
+     */
+    void drop_dead_front_aux(level& l) noexcept
+    {
+        while (!l.orders.empty() && l.orders.front().quantity == 0) {
+            order* o = &l.orders.front();
+            l.orders.pop_front();
+            if (o == l.tail)
+                l.tail = nullptr;
+            destroy_order_aux(o);
+            --l.dead;
+        }
+    }
+
+    /**
+     * @brief Frees all dead orders of %l, and recomputes its tail.
+     */
+    void compact_aux(level& l) noexcept
+    {
+        auto prev = l.orders.before_begin();
+        l.tail = nullptr;
+        for (auto it = l.orders.begin(); it != l.orders.end();) {
+            if (it->quantity == 0) {
+                order* o = &*it;
+                it = l.orders.erase_after(prev);
+                destroy_order_aux(o);
+            } else {
+                l.tail = &*it;
+                prev = it++;
+            }
+        }
+        l.dead = 0;
+    }
+
+    /**
+     * @brief Moves the best price of side %s away from the spread, past the
+     * levels without live orders.
+     */
+    void update_best_aux(side s) noexcept
+    {
+        if (s == side::buy) {
+            while (m_best_bid >= 0 && m_bids[m_best_bid].live == 0)
+                --m_best_bid;
+        } else {
+            while (m_best_ask < num_levels() && m_asks[m_best_ask].live == 0)
+                ++m_best_ask;
+        }
+    }
+
+    void link_order_aux(order* o)
+    {
+        const std::ptrdiff_t index = index_of(o->price);
+        level& l = levels(o->order_side)[index];
+        auto position = l.tail ? l.orders.iterator_to(*l.tail) : l.orders.before_begin();
+        l.orders.insert_after(position, *o);
+        l.tail = o;
+        l.quantity += o->quantity;
+        ++l.live;
+        if (o->order_side == side::buy)
+            m_best_bid = std::max(m_best_bid, index);
+        else
+            m_best_ask = std::min(m_best_ask, index);
+    }
+
+    /**
+     * @brief Marks the live order %o dead and forgets its id.
+     */
+    void kill_order_aux(order* o) noexcept
+    {
+        const side s = o->order_side;
+        level& l = levels(s)[index_of(o->price)];
+        l.quantity -= o->quantity;
+        o->quantity = 0;
+        --l.live;
+        ++l.dead;
+        m_orders.erase(o->id);
+        if (l.live == 0) {
+            compact_aux(l);
+            update_best_aux(s);
+        } else if (l.dead > l.live) {
+            compact_aux(l);
+        }
+    }
+
+    void check_price_aux(price_type price) const
+    {
+        if (price < m_min_price || index_of(price) >= num_levels())
+            throw std::out_of_range("Price outside of the order book range!");
+    }
+
+    /**
+     * @brief Matches up to %quantity against the side opposite to %taker_side,
+     * at prices no worse than %limit.
+     * @return The quantity left.
+     */
+    template<typename OnTrade>
+    quantity_type match_aux(id_type taker_id,
+                            side taker_side,
+                            price_type limit,
+                            quantity_type quantity,
+                            OnTrade& on_trade)
+    {
+        const side maker_side = taker_side == side::buy ? side::sell : side::buy;
+        dev::vector<level>& book = levels(maker_side);
+        while (quantity != 0) {
+            const std::ptrdiff_t best =
+              maker_side == side::sell ? m_best_ask : m_best_bid;
+            if (best < 0 || best >= num_levels())
+                break;
+            const price_type price = price_of(best);
+            if (taker_side == side::buy ? price > limit : price < limit)
+                break;
+
+            level& l = book[best];
+            while (quantity != 0 && l.live != 0) {
+                drop_dead_front_aux(l);
+                order& maker = l.orders.front();
+                const quantity_type fill = std::min(quantity, maker.quantity);
+                maker.quantity -= fill;
+                l.quantity -= fill;
+                quantity -= fill;
+                on_trade(trade{ maker.id, taker_id, price, fill });
+                if (maker.quantity == 0) {
+                    m_orders.erase(maker.id);
+                    --l.live;
+                    ++l.dead;
+                    drop_dead_front_aux(l);
+                }
+            }
+            if (l.live == 0) {
+                compact_aux(l);
+                update_best_aux(maker_side);
+            }
+        }
+        return quantity;
+    }
+
+  public:
+    /**
+     * @brief Creates an empty book for the prices [%min_price, %max_price], in
+     * ticks.
+     */
+    order_book(price_type min_price, price_type max_price)
+      : m_min_price(min_price)
+    {
+        if (max_price < min_price)
+            throw std::invalid_argument("order_book needs min_price <= max_price!");
+        const auto n = static_cast<size_type>(max_price - min_price + 1);
+        m_bids.resize(n);
+        m_asks.resize(n);
+        m_best_ask = num_levels();
+    }
+
+    order_book(const order_book&) = delete;
+    order_book& operator=(const order_book&) = delete;
+
+    ~order_book() { clear(); }
+
+    /**
+     * @brief Removes all orders.
+     */
+    void clear() noexcept
+    {
+        for (dev::vector<level>* book : { &m_bids, &m_asks }) {
+            for (level& l : *book) {
+                while (!l.orders.empty()) {
+                    order* o = &l.orders.front();
+                    l.orders.pop_front();
+                    destroy_order_aux(o);
+                }
+                l = level{};
+            }
+        }
+        m_orders.clear();
+        m_best_bid = -1;
+        m_best_ask = num_levels();
+    }
+
+    price_type min_price() const noexcept { return m_min_price; }
+    price_type max_price() const noexcept { return price_of(num_levels() - 1); }
+
+    /**
+     * @brief Returns the number of resting orders.
+     */
+    size_type order_count() const noexcept { return m_orders.size(); }
+
+    bool contains(id_type id) const { return m_orders.find(id) != m_orders.end(); }
+
+    std::optional<price_type> best_bid() const noexcept
+    {
+        if (m_best_bid < 0)
+            return std::nullopt;
+        return price_of(m_best_bid);
+    }
+
+    std::optional<price_type> best_ask() const noexcept
+    {
+        if (m_best_ask >= num_levels())
+            return std::nullopt;
+        return price_of(m_best_ask);
+    }
+
+    /**
+     * @brief Returns the total resting quantity of side %s at %price.
+     */
+    quantity_type volume_at(side s, price_type price) const
+    {
+        check_price_aux(price);
+        return levels(s)[index_of(price)].quantity;
+    }
+
+    /**
+     * @brief Returns the resting quantity of order %id, or 0 if there is no
+     * such order.
+     */
+    quantity_type quantity_of(id_type id) const
+    {
+        auto it = m_orders.find(id);
+        return it == m_orders.end() ? 0 : it->second->quantity;
+    }
+
+    /**
+     * @brief Adds a limit order. The part that crosses the book is matched at
+     * once, and the rest rests at %price behind the orders already there.
+     * @return false, doing nothing, if an order with id %id is resting.
+     * @throws std::out_of_range if %price is outside of the range of the book.
+     */
+    template<typename OnTrade = no_trade_listener>
+    bool add(id_type id,
+             side s,
+             price_type price,
+             quantity_type quantity,
+             OnTrade on_trade = {})
+    {
+        DEV_HARDENING_ASSERT(quantity != 0, "order_book::add() with a zero quantity");
+        check_price_aux(price);
+        if (contains(id))
+            return false;
+        quantity = match_aux(id, s, price, quantity, on_trade);
+        if (quantity != 0) {
+            order* o = create_order_aux(id, s, price, quantity);
+            try {
+                m_orders.try_emplace(id, o);
+            } catch (...) {
+                destroy_order_aux(o);
+                throw;
+            }
+            link_order_aux(o);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Matches a market order of %quantity on side %s against the book,
+     * without resting what is left.
+     * @return The quantity executed.
+     */
+    template<typename OnTrade = no_trade_listener>
+    quantity_type match(id_type id, side s, quantity_type quantity, OnTrade on_trade = {})
+    {
+        const price_type limit = s == side::buy ? max_price() : min_price();
+        return quantity - match_aux(id, s, limit, quantity, on_trade);
+    }
+
+    /**
+     * @brief Cancels order %id.
+     * @return Whether the order was resting.
+     */
+    bool cancel(id_type id)
+    {
+        auto it = m_orders.find(id);
+        if (it == m_orders.end())
+            return false;
+        kill_order_aux(it->second);
+        return true;
+    }
+
+    /**
+     * @brief Changes the price and quantity of order %id. Reducing the quantity
+     * at the same price keeps the time priority of the order, and reducing it
+     * to 0 cancels it. Any other change moves the order to the back of its new
+     * level, as a cancel followed by an add, and may match.
+     * @return Whether the order was resting.
+     * @throws std::out_of_range if %price is outside of the range of the book.
+     */
+    template<typename OnTrade = no_trade_listener>
+    bool modify(id_type id,
+                price_type price,
+                quantity_type quantity,
+                OnTrade on_trade = {})
+    {
+        check_price_aux(price);
+        auto it = m_orders.find(id);
+        if (it == m_orders.end())
+            return false;
+        order* o = it->second;
+        if (quantity == 0) {
+            kill_order_aux(o);
+        } else if (price == o->price && quantity <= o->quantity) {
+            levels(o->order_side)[index_of(price)].quantity -= o->quantity - quantity;
+            o->quantity = quantity;
+        } else {
+            const side s = o->order_side;
+            kill_order_aux(o);
+            add(id, s, price, quantity, on_trade);
+        }
+        return true;
+    }
+};
+
+} // namespace dev
@@ -0,0 +1,417 @@
+#pragma once
+
+#include "hardening/hardening.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace dev {
+
+/**
+ * @brief A sequence container that grows by appending segments instead of
+ * reallocating, so elements never move once constructed.
+ *
+ * Segment k holds FirstSegmentSize << k elements, so the capacity doubles with
+ * every new segment just like dev::vector, but the existing segments are left
+ * where they are: push_back never copies or moves elements, and pointers and
+ * references to elements stay valid until the element is erased. The worst-case
+ * cost of push_back is one allocation, not an O(n) copy.
+ *
+ * Element %i lives in segment k = bit_width(i + F) - 1 - log2(F) at offset
+ * i + F - (F << k), where F = FirstSegmentSize. Indexing is therefore O(1): a
+ * single bit scan plus two loads.
+ *
+ * The elements are not contiguous, so the iterators are random access but not
+ * contiguous iterators.
+ */
+template<typename T, std::size_t FirstSegmentSize = 16>
+class segmented_vector
+{
+    static_assert(std::has_single_bit(FirstSegmentSize),
+                  "FirstSegmentSize must be a power of two");
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+
+  private:
+    static constexpr size_type first_segment_shift = std::countr_zero(FirstSegmentSize);
+
+    // Enough segments to address every size_type index
+    static constexpr size_type max_segments =
+      std::numeric_limits<size_type>::digits - first_segment_shift;
+
+    std::array<pointer, max_segments> m_segments{};
+    size_type m_num_segments{ 0 };
+    size_type m_size{ 0 };
+
+    static constexpr size_type segment_size(size_type k) { return FirstSegmentSize << k; }
+
+    /**
+     * @brief Total number of elements held by segments [0, k).
+     */
+    static constexpr size_type capacity_of(size_type k)
+    {
+        return FirstSegmentSize * ((size_type{ 1 } << k) - 1);
+    }
+
+    static constexpr size_type segment_of(size_type n)
+    {
+        return std::bit_width(n + FirstSegmentSize) - 1 - first_segment_shift;
+    }
+
+    static constexpr size_type offset_of(size_type n, size_type k)
+    {
+        return n + FirstSegmentSize - segment_size(k);
+    }
+
+    pointer address_aux(size_type n) const
+    {
+        size_type k = segment_of(n);
+        return m_segments[k] + offset_of(n, k);
+    }
+
+    /**
+     * @brief Allocates one more segment. Existing segments are untouched.
+     */
+    void add_segment_aux()
+    {
+        if (m_num_segments == max_segments)
+            throw std::length_error("segmented_vector is full");
+        m_segments[m_num_segments] =
+          static_cast<pointer>(::operator new(sizeof(value_type) * segment_size(m_num_segments)));
+        ++m_num_segments;
+    }
+
+    /**
+     * @brief Destroys the elements [new_size, size()).
+     */
+    void destroy_tail_aux(size_type new_size) noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_type n = m_size; n > new_size; --n)
+                std::destroy_at(address_aux(n - 1));
+        }
+        m_size = std::min(m_size, new_size);
+    }
+
+    /**
+     * @brief Frees the segments [k, num_segments). They must hold no elements.
+     */
+    void free_segments_aux(size_type k) noexcept
+    {
+        while (m_num_segments > k) {
+            --m_num_segments;
+            ::operator delete(m_segments[m_num_segments]);
+            m_segments[m_num_segments] = nullptr;
+        }
+    }
+
+  public:
+    /**
+     * @brief Random-access iterator over the elements. It stores the container
+     * and an index, and it stays valid as the container grows.
+     */
+    template<bool Const>
+    class Iterator
+    {
+      public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const T&, T&>;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using container_pointer =
+          std::conditional_t<Const, const segmented_vector*, segmented_vector*>;
+
+        Iterator() = default;
+
+        Iterator(container_pointer container, size_type index)
+          : m_container{ container }
+          , m_index{ index }
+        {
+        }
+
+        /**
+         * @brief Conversion from a read/write iterator to a read-only one.
+         */
+        template<bool OtherConst>
+            requires(Const && !OtherConst)
+        Iterator(const Iterator<OtherConst>& other)
+          : m_container{ other.m_container }
+          , m_index{ other.m_index }
+        {
+        }
+
+        reference operator*() const { return (*m_container)[m_index]; }
+        pointer operator->() const { return &(*m_container)[m_index]; }
+        reference operator[](difference_type n) const { return (*m_container)[m_index + n]; }
+
+        Iterator& operator++()
+        {
+            ++m_index;
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto temp = *this;
+            ++m_index;
+            return temp;
+        }
+
+        Iterator& operator--()
+        {
+            --m_index;
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            auto temp = *this;
+            --m_index;
+            return temp;
+        }
+
+        Iterator& operator+=(difference_type n)
+        {
+            m_index += n;
+            return *this;
+        }
+
+        Iterator& operator-=(difference_type n)
+        {
+            m_index -= n;
+            return *this;
+        }
+
+        Iterator operator+(difference_type n) const { return Iterator(m_container, m_index + n); }
+        friend Iterator operator+(difference_type n, Iterator it) { return it + n; }
+        Iterator operator-(difference_type n) const { return Iterator(m_container, m_index - n); }
+
+        difference_type operator-(const Iterator& other) const
+        {
+            return static_cast<difference_type>(m_index) -
+                   static_cast<difference_type>(other.m_index);
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs)
+        {
+            return lhs.m_index == rhs.m_index;
+        }
+
+        friend auto operator<=>(const Iterator& lhs, const Iterator& rhs)
+        {
+            return lhs.m_index <=> rhs.m_index;
+        }
+
+      private:
+        friend Iterator<true>;
+        container_pointer m_container{ nullptr };
+        size_type m_index{ 0 };
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    // Constructors
+    /**
+     * @brief Creates a segmented_vector with no elements and no segments.
+     */
+    segmented_vector() = default;
+
+    /**
+     * @brief Creates a segmented_vector holding copies of the elements of the
+     * initializer list.
+     */
+    segmented_vector(std::initializer_list<T> values)
+      : segmented_vector()
+    {
+        reserve(values.size());
+        for (const auto& value : values)
+            push_back(value);
+    }
+
+    /**
+     * @brief Copy constructor. The copy has just enough segments for the
+     * elements of %other.
+     */
+    segmented_vector(const segmented_vector& other)
+      : segmented_vector()
+    {
+        reserve(other.size());
+        for (const auto& value : other)
+            push_back(value);
+    }
+
+    /**
+     * @brief Move constructor. Takes over the segments of %other, so no element
+     * is moved.
+     */
+    segmented_vector(segmented_vector&& other) noexcept
+      : m_segments{ std::exchange(other.m_segments, {}) }
+      , m_num_segments{ std::exchange(other.m_num_segments, 0) }
+      , m_size{ std::exchange(other.m_size, 0) }
+    {
+    }
+
+    segmented_vector& operator=(const segmented_vector& other)
+    {
+        if (this != &other)
+            segmented_vector(other).swap(*this);
+        return *this;
+    }
+
+    segmented_vector& operator=(segmented_vector&& other) noexcept
+    {
+        segmented_vector(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~segmented_vector()
+    {
+        destroy_tail_aux(0);
+        free_segments_aux(0);
+    }
+
+    // Capacity related member functions
+    [[nodiscard]] size_type size() const { return m_size; }
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    /**
+     * @brief Returns the number of elements that fit in the allocated segments.
+     */
+    [[nodiscard]] size_type capacity() const { return capacity_of(m_num_segments); }
+
+    /**
+     * @brief Returns the number of allocated segments.
+     */
+    [[nodiscard]] size_type segment_count() const { return m_num_segments; }
+
+    /**
+     * @brief Allocates segments until at least %new_capacity elements fit.
+     * Unlike dev::vector::reserve, existing elements are not moved.
+     */
+    void reserve(size_type new_capacity)
+    {
+        while (capacity() < new_capacity)
+            add_segment_aux();
+    }
+
+    /**
+     * @brief Frees the segments that hold no elements.
+     */
+    void shrink_to_fit()
+    {
+        free_segments_aux(m_size ? segment_of(m_size - 1) + 1 : 0);
+    }
+
+    // Element access
+    reference operator[](size_type n)
+    {
+        DEV_HARDENING_ASSERT(n < m_size, "segmented_vector index out of bounds");
+        return *address_aux(n);
+    }
+
+    const_reference operator[](size_type n) const
+    {
+        DEV_HARDENING_ASSERT(n < m_size, "segmented_vector index out of bounds");
+        return *address_aux(n);
+    }
+
+    reference at(size_type n)
+    {
+        if (n < m_size)
+            return (*this)[n];
+        throw std::out_of_range("Index out of bounds!");
+    }
+
+    const_reference at(size_type n) const
+    {
+        if (n < m_size)
+            return (*this)[n];
+        throw std::out_of_range("Index out of bounds!");
+    }
+
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[m_size - 1]; }
+    const_reference back() const { return (*this)[m_size - 1]; }
+
+    // Iterators
+    iterator begin() { return iterator(this, 0); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return iterator(this, m_size); }
+    const_iterator end() const { return const_iterator(this, m_size); }
+    const_iterator cend() const { return end(); }
+
+    // Modifiers
+    /**
+     * @brief Constructs an element in place at the end. When the last segment
+     * is full a new one is allocated; no existing element is moved.
+     */
+    template<typename... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (m_size == capacity())
+            add_segment_aux();
+        pointer p = std::construct_at(address_aux(m_size), std::forward<Args>(args)...);
+        ++m_size;
+        return *p;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back()
+    {
+        DEV_HARDENING_ASSERT(m_size != 0, "pop_back() called on an empty segmented_vector");
+        --m_size;
+        std::destroy_at(address_aux(m_size));
+    }
+
+    /**
+     * @brief Destroys all elements. The segments are kept for reuse.
+     */
+    void clear() { destroy_tail_aux(0); }
+
+    /**
+     * @brief Resizes the container to %new_size elements. New elements are
+     * value-initialized.
+     */
+    void resize(size_type new_size)
+    {
+        if (new_size <= m_size) {
+            destroy_tail_aux(new_size);
+            return;
+        }
+        reserve(new_size);
+        while (m_size < new_size)
+            emplace_back();
+    }
+
+    void swap(segmented_vector& other) noexcept
+    {
+        std::swap(m_segments, other.m_segments);
+        std::swap(m_num_segments, other.m_num_segments);
+        std::swap(m_size, other.m_size);
+    }
+};
+
+} // namespace dev
@@ -1,105 +1,188 @@
+#pragma once
+
 #include <atomic>
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <format>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 namespace dev {
 
-template<typename T>
-class shared_ptr_base
+/**
+ * @brief The reference count of a dev::shared_ptr, which copies on any thread
+ * update concurrently.
+ *
+ * Taking a new reference needs no ordering: the owner copying the pointer
+ * already holds one, so the object can not go away meanwhile, and the
+ * increment is relaxed. Dropping a reference releases the writes of its owner
+ * to the managed object, and the owner that drops the last one acquires them
+ * all before it destroys the object, so the decrement is acq_rel.
+ */
+class atomic_ref_count
 {
+  private:
+    std::atomic<unsigned long long> m_count;
+
   public:
-    using value_type = T;
-    using pointer = T*;
-    using const_pointer = const T*;
-    using reference = T&;
-    using const_reference = const T&;
+    explicit atomic_ref_count(unsigned long long count) noexcept
+      : m_count{ count }
+    {
+    }
 
-  protected:
-    struct destroy_wrapper // RAII class
+    void increment() noexcept { m_count.fetch_add(1u, std::memory_order_relaxed); }
+
+    /**
+     * @brief Takes a reference unless the count is already zero, in a
+     * compare-and-swap loop, and returns whether it did. This is how a weak
+     * pointer is locked: once the count has dropped to zero it never goes
+     * up again.
+     */
+    bool increment_if_nonzero() noexcept
     {
-        template<typename Deleter>
-        explicit destroy_wrapper(Deleter&& deleter)
-          : m_destroyer_ptr{ std::make_unique<destroyer<Deleter>>(
-              std::forward<Deleter>(deleter)) }
-        {
-        }
-        // destroy_wrapper is a wrapper over a unique_ptr<destroyer_base>.
-        // It is intended to be move-constructible ONLY.
-        destroy_wrapper(destroy_wrapper&& other) noexcept
-          : m_destroyer_ptr{ std::exchange(other.m_destroyer_ptr, nullptr) }
-        {
+        unsigned long long count = m_count.load(std::memory_order_relaxed);
+        while (count != 0) {
+            if (m_count.compare_exchange_weak(
+                  count, count + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+                return true;
         }
+        return false;
+    }
 
-        void operator()(pointer ptr)
-        {
-            (*m_destroyer_ptr)(ptr); // Virtual polymorphism
-        }
+    /**
+     * @brief Drops a reference, and returns whether it was the last one.
+     */
+    bool decrement() noexcept
+    {
+        return m_count.fetch_sub(1u, std::memory_order_acq_rel) == 1u;
+    }
 
-        struct destroyer_base
-        {
-            virtual void operator()(pointer ptr) = 0;
-            virtual ~destroyer_base() = default;
-        };
+    void store(unsigned long long count) noexcept
+    {
+        m_count.store(count, std::memory_order_relaxed);
+    }
 
-        template<typename Deleter>
-        struct destroyer : public destroyer_base
-        {
-            explicit destroyer(Deleter deleter)
-              : destroyer_base()
-              , m_deleter{ deleter }
-            {
-            }
+    /**
+     * @brief Returns the count. Under concurrent copies it is only a
+     * snapshot.
+     */
+    [[nodiscard]] unsigned long long load() const noexcept
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+};
 
-            void operator()(pointer ptr) override { m_deleter(ptr); }
+/**
+ * @brief A plain reference count, for pointers whose copies all stay on one
+ * thread: see dev::local_shared_ptr.
+ */
+class local_ref_count
+{
+  private:
+    unsigned long long m_count;
 
-            Deleter m_deleter;
-        };
+  public:
+    explicit local_ref_count(unsigned long long count) noexcept
+      : m_count{ count }
+    {
+    }
 
-        ~destroy_wrapper() {}
-        std::unique_ptr<destroyer_base> m_destroyer_ptr;
-    };
+    void increment() noexcept { ++m_count; }
 
-    struct control_block_base
+    bool increment_if_nonzero() noexcept
     {
-        std::atomic<unsigned long long> m_ref_count;
-        destroy_wrapper m_destroy_wrapper;
+        if (m_count == 0)
+            return false;
+        ++m_count;
+        return true;
+    }
 
-        /**
-         * @brief Default constructor
-         */
-        control_block_base()
-          : control_block_base(0u, destroy_wrapper(std::default_delete<T>()))
-        {
-        }
+    bool decrement() noexcept { return --m_count == 0; }
+    void store(unsigned long long count) noexcept { m_count = count; }
+    [[nodiscard]] unsigned long long load() const noexcept { return m_count; }
+};
 
-        explicit control_block_base(destroy_wrapper&& wrapper)
-          : control_block_base(0u, std::move(wrapper))
-        {
-        }
+/**
+ * @brief Tags the constructors that leave the managed object, or array
+ * elements, default-initialized rather than value-initialized, as
+ * make_shared_for_overwrite() does.
+ */
+struct for_overwrite_t
+{
+    explicit for_overwrite_t() = default;
+};
+
+inline constexpr for_overwrite_t for_overwrite{};
 
-        explicit control_block_base(unsigned long long ref_count,
-                                    destroy_wrapper&& wrapper)
-          : m_destroy_wrapper{ std::move(wrapper) }
+template<typename T, typename RefCount>
+class weak_ptr;
+
+template<typename T, typename RefCount>
+class enable_shared_from_this;
+
+template<typename T>
+class atomic_shared_ptr;
+
+template<typename T, typename RefCount = atomic_ref_count>
+class shared_ptr_base
+{
+    template<typename, typename>
+    friend class weak_ptr;
+
+    template<typename>
+    friend class atomic_shared_ptr;
+
+  public:
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+
+  protected:
+    /**
+     * @brief The reference counts of a managed object, and the type-erased way
+     * of disposing of it. Every kind of control block is a single allocation
+     * that holds whatever it needs to dispose of the object.
+     *
+     * The strong count is the number of shared_ptr owners; the object is
+     * disposed of when it drops to zero. The weak count is the number of
+     * weak_ptr observers, plus one held by all owners together; the block is
+     * freed when it drops to zero.
+     */
+    struct control_block_base
+    {
+        RefCount m_ref_count;
+        RefCount m_weak_count;
+
+        explicit control_block_base(unsigned long long ref_count) noexcept
+          : m_ref_count{ ref_count }
+          , m_weak_count{ 1u }
         {
-            m_ref_count.store(ref_count);
         }
 
         /**
          * @brief helper function to increment the object reference count
          */
-        void increment() { m_ref_count.fetch_add(1u); }
+        void increment() noexcept { m_ref_count.increment(); }
 
         /**
-         * @brief helper function to decrement the object reference count
+         * @brief helper function to decrement the object reference count.
+         * Returns whether the last reference was dropped.
          */
-        auto decrement()
-        {
-            auto result = m_ref_count.fetch_sub(1u);
-            return result;
-        }
+        bool decrement() noexcept { return m_ref_count.decrement(); }
+
+        /**
+         * @brief Takes a strong reference unless the object is gone.
+         */
+        bool increment_if_nonzero() noexcept { return m_ref_count.increment_if_nonzero(); }
+
+        void increment_weak() noexcept { m_weak_count.increment(); }
 
         // There is no use-case for copying control blocks of a shared_ptr<T>
         // instance. For safety, I delete these functions.
@@ -116,47 +199,80 @@ class shared_ptr_base
             return m_ref_count.load();
         }
 
-        virtual void release_shared(T*) = 0;
-        virtual ~control_block_base() {}
-    };
-
-    struct control_block : public control_block_base
-    {
-        // pointer m_object_ptr;
-
-        control_block()
-          : control_block_base()
+        /**
+         * @brief Drops a strong reference. The last one disposes of the
+         * object, and drops the weak reference of the owners.
+         */
+        void release_shared() noexcept
         {
+            if (decrement()) {
+                dispose();
+                release_weak();
+            }
         }
 
-        explicit control_block(unsigned long long ref_count, destroy_wrapper&& wrapper)
-          : control_block_base(ref_count, std::move(wrapper))
+        /**
+         * @brief Drops a weak reference. The last one frees the block.
+         */
+        void release_weak() noexcept
         {
+            if (m_weak_count.decrement())
+                destroy();
         }
 
-        explicit control_block(destroy_wrapper&& wrapper)
-          : control_block_base(std::move(wrapper))
-        {
-        }
+        /**
+         * @brief Destroys the managed object.
+         */
+        virtual void dispose() noexcept = 0;
 
-        void release_shared(T* raw_underlying_ptr) override
+        /**
+         * @brief Frees the control block.
+         */
+        virtual void destroy() noexcept = 0;
+
+        /**
+         * @brief Returns the managed object.
+         */
+        virtual T* get() noexcept = 0;
+
+        virtual ~control_block_base() {}
+    };
+
+    /**
+     * @brief A control block for an object allocated by the user, which keeps
+     * the pointer and the deleter of the object as members. An empty deleter,
+     * such as std::default_delete, takes no space.
+     */
+    template<typename Deleter>
+    struct control_block final : public control_block_base
+    {
+        T* m_object_ptr;
+        [[no_unique_address]] Deleter m_deleter;
+
+        control_block(T* ptr, Deleter&& deleter) noexcept
+          : control_block_base(1u)
+          , m_object_ptr{ ptr }
+          , m_deleter{ std::move(deleter) }
         {
-            if (--this->m_ref_count == 0) {
-                control_block_base::m_destroy_wrapper(raw_underlying_ptr);
-                delete this;
-            }
         }
 
-        ~control_block() {}
+        void dispose() noexcept override { m_deleter(m_object_ptr); }
+        void destroy() noexcept override { delete this; }
+        T* get() noexcept override { return m_object_ptr; }
     };
 
     /**
      * @brief This is a specialized version of %control_block_base, where the managed
-     * object resides within the control block itself.
+     * object resides within the control block itself. The object is destroyed
+     * as soon as the last owner goes, releasing everything it holds, while the
+     * bytes it occupied go with the block, once no weak_ptr is left either.
      */
-    struct control_block_with_storage : public control_block_base
+    struct control_block_with_storage final : public control_block_base
     {
-        T m_object;
+        union
+        {
+            T m_object;
+        };
 
         /**
          * @brief Instantiates the managed object by perfectly forwarding
@@ -164,83 +280,164 @@ class shared_ptr_base
          */
         template<typename... Args>
         explicit control_block_with_storage(Args&&... args)
-          : control_block_base{ 1u, destroy_wrapper(std::default_delete<T>()) }
-          , m_object(std::forward<Args>(args)...)
+          : control_block_base{ 1u }
         {
+            std::construct_at(&m_object, std::forward<Args>(args)...);
         }
 
         /**
-         * @brief C'tor that accepts a destroyer object and perfectly
-         * forwards the constructor args
+         * @brief Default-initializes the managed object.
          */
-        template<typename... Args>
-        explicit control_block_with_storage(destroy_wrapper&& wrapper, Args&&... args)
-          : control_block_base{ 1u, std::move(wrapper) }
-          , m_object(std::forward<Args>(args)...)
+        explicit control_block_with_storage(for_overwrite_t)
+          : control_block_base{ 1u }
+        {
+            ::new (static_cast<void*>(&m_object)) T;
+        }
+
+        // The object is destroyed by dispose()
+        ~control_block_with_storage() {}
+
+        void dispose() noexcept override { std::destroy_at(&m_object); }
+        void destroy() noexcept override { delete this; }
+
+        T* get() noexcept override { return &m_object; }
+    };
+
+    /**
+     * @brief A control block followed by an array of %m_size elements, in the
+     * same allocation, as made by make_shared<T[]>(). The elements are
+     * destroyed as soon as the last owner goes, and their bytes are freed
+     * along with the block.
+     */
+    struct control_block_with_array final : public control_block_base
+    {
+        std::size_t m_size;
+
+        explicit control_block_with_array(std::size_t size) noexcept
+          : control_block_base{ 1u }
+          , m_size{ size }
+        {
+        }
+
+        static constexpr std::size_t alignment_aux() noexcept
+        {
+            return std::max(alignof(control_block_with_array), alignof(T));
+        }
+
+        // The elements start at the first suitably aligned byte after the block
+        static constexpr std::size_t offset_aux() noexcept
+        {
+            return (sizeof(control_block_with_array) + alignof(T) - 1) / alignof(T) * alignof(T);
+        }
+
+        static void* allocate_aux(std::size_t bytes)
+        {
+            if constexpr (alignment_aux() > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                return ::operator new(bytes, std::align_val_t{ alignment_aux() });
+            else
+                return ::operator new(bytes);
+        }
+
+        static void deallocate_aux(void* memory, std::size_t bytes) noexcept
         {
+            if constexpr (alignment_aux() > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                ::operator delete(memory, bytes, std::align_val_t{ alignment_aux() });
+            else
+                ::operator delete(memory, bytes);
         }
 
-        void release_shared(T*) override
+        /**
+         * @brief Allocates a block with room for %count elements, and
+         * constructs them: value-initialized, or only default-initialized
+         * when %overwrite is set, which leaves trivial elements indeterminate.
+         * If an element throws, the ones already constructed are destroyed
+         * and the memory is freed before the exception propagates.
+         */
+        static control_block_with_array* create(std::size_t count, bool overwrite)
         {
-            if (--control_block_base::m_ref_count == 0) {
-                delete this;
+            if (count > (std::numeric_limits<std::size_t>::max() - offset_aux()) / sizeof(T))
+                throw std::bad_array_new_length();
+            const std::size_t bytes = offset_aux() + count * sizeof(T);
+            void* memory = allocate_aux(bytes);
+            auto* cb = ::new (memory) control_block_with_array(count);
+            try {
+                if (overwrite)
+                    std::uninitialized_default_construct_n(cb->get(), count);
+                else
+                    std::uninitialized_value_construct_n(cb->get(), count);
+            } catch (...) {
+                cb->~control_block_with_array();
+                deallocate_aux(memory, bytes);
+                throw;
             }
+            return cb;
         }
 
-        T* get() { return &m_object; }
+        void dispose() noexcept override { std::destroy_n(get(), m_size); }
+
+        void destroy() noexcept override
+        {
+            const std::size_t bytes = offset_aux() + m_size * sizeof(T);
+            this->~control_block_with_array();
+            deallocate_aux(this, bytes);
+        }
+
+        T* get() noexcept override
+        {
+            return reinterpret_cast<T*>(reinterpret_cast<std::byte*>(this) + offset_aux());
+        }
     };
 
-  public:
     /**
-     * @brief Default constructor - an empty shared_ptr
+     * @brief Allocates the control block of %ptr. If that fails, %ptr is
+     * passed to %deleter before the exception propagates.
      */
-    shared_ptr_base()
-      : shared_ptr_base(nullptr)
+    template<typename Deleter>
+    static control_block_base* create_control_block_aux(T* ptr, Deleter deleter)
     {
+        static_assert(std::is_nothrow_move_constructible_v<Deleter>,
+                      "shared_ptr deleters must be nothrow move constructible");
+        try {
+            return new control_block<Deleter>(ptr, Deleter(deleter));
+        } catch (...) {
+            deleter(ptr);
+            throw;
+        }
     }
 
+  public:
     /**
-     * @brief shared_ptr
+     * @brief Default constructor - an empty shared_ptr. It owns nothing, so
+     * it needs no control block.
      */
-    shared_ptr_base(std::nullptr_t)
-      : m_raw_underlying_ptr{ nullptr }
-      , m_control_block_ptr{ new control_block() }
+    shared_ptr_base() noexcept
+      : shared_ptr_base(nullptr)
     {
     }
 
     /**
-     * @brief Constructor that takes a raw pointer. Takes
-     * ownership of the pointee.
+     * @brief An empty shared_ptr, without a control block.
      */
-    explicit shared_ptr_base(pointer ptr)
-      : m_raw_underlying_ptr{ ptr }
+    shared_ptr_base(std::nullptr_t) noexcept
+      : m_raw_underlying_ptr{ nullptr }
       , m_control_block_ptr{ nullptr }
     {
-        // The child-classes will allocate the control_block
     }
 
     /**
-     * @brief Constructor that takes a raw pointer and a custom deleter. Takes
-     * ownership of the pointee.
+     * @brief Constructor that takes a raw pointer and a deleter. Takes
+     * ownership of the pointee, with a single allocation for the control
+     * block.
      */
-    explicit shared_ptr_base(T* ptr, destroy_wrapper&& destroyer)
+    template<typename Deleter>
+    shared_ptr_base(T* ptr, Deleter deleter)
       : m_raw_underlying_ptr{ ptr }
-      , m_control_block_ptr{ nullptr }
+      , m_control_block_ptr{ create_control_block_aux(ptr, std::move(deleter)) }
     {
-        try {
-            if (ptr) {
-                m_control_block_ptr = new control_block(1u, std::move(destroyer));
-            } else {
-                m_control_block_ptr = new control_block(std::move(destroyer));
-            }
-
-        } catch (std::exception& ex) {
-            destroyer(ptr);
-            throw ex;
-        }
+        enable_shared_from_this_aux();
     }
 
-    explicit shared_ptr_base(T* ptr, control_block_base* cb)
+    explicit shared_ptr_base(T* ptr, control_block_base* cb) noexcept
       : m_raw_underlying_ptr{ ptr }
       , m_control_block_ptr{ cb }
     {
@@ -250,12 +447,12 @@ class shared_ptr_base
      * @brief Copy constructor. Models shared co-ownership of the resource
      * semantics.
      */
-    shared_ptr_base(const shared_ptr_base& other)
+    shared_ptr_base(const shared_ptr_base& other) noexcept
       : m_raw_underlying_ptr{ other.m_raw_underlying_ptr }
       , m_control_block_ptr{ other.m_control_block_ptr }
     {
         if (m_control_block_ptr)
-            m_control_block_ptr->increment(); // Atomic pre-increment
+            m_control_block_ptr->increment();
     }
 
     /**
@@ -286,7 +483,7 @@ class shared_ptr_base
      * and become a shared co-owner of the resource specified by user-supplied
      * argument @a other.
      */
-    shared_ptr_base& operator=(const shared_ptr_base& other)
+    shared_ptr_base& operator=(const shared_ptr_base& other) noexcept
     {
         shared_ptr_base{ other }.swap(*this);
         return *this;
@@ -296,7 +493,7 @@ class shared_ptr_base
      * @brief Move assignment operator. Release the currently held resource.
      * Transfer ownership of the resource.
      */
-    shared_ptr_base& operator=(shared_ptr_base&& other)
+    shared_ptr_base& operator=(shared_ptr_base&& other) noexcept
     {
         shared_ptr_base{ std::move(other) }.swap(*this);
         return *this;
@@ -307,10 +504,8 @@ class shared_ptr_base
      */
     ~shared_ptr_base()
     {
-        if (m_raw_underlying_ptr) {
-            m_control_block_ptr->release_shared(m_raw_underlying_ptr);
-            m_raw_underlying_ptr = nullptr;
-        }
+        if (m_control_block_ptr)
+            m_control_block_ptr->release_shared();
     }
 
     // Pointer-like functions
@@ -382,27 +577,54 @@ class shared_ptr_base
             return 0;
     }
 
+    /**
+     * @brief Constructs the managed object from %args inside its control
+     * block, with a single heap memory allocation.
+     */
     template<typename... Args>
-    shared_ptr_base(Args&&... args)
+    explicit shared_ptr_base(std::in_place_t, Args&&... args)
     {
-        /* Perform a single heap memory allocation */
-        control_block_with_storage* cb = new control_block_with_storage(
-          destroy_wrapper(std::default_delete<T>()), (std::forward<Args>(args))...);
+        control_block_with_storage* cb =
+          new control_block_with_storage(std::forward<Args>(args)...);
         m_raw_underlying_ptr = cb->get();
         m_control_block_ptr = cb;
+        enable_shared_from_this_aux();
     }
 
-    void reset_base(T* ptr, destroy_wrapper&& wrapper)
+    /**
+     * @brief Default-initializes the managed object inside its control block.
+     */
+    explicit shared_ptr_base(for_overwrite_t tag)
     {
-        if (m_raw_underlying_ptr != ptr) {
-            if (--m_control_block_ptr->m_ref_count == 0) {
-                m_control_block_ptr->m_destroy_wrapper(m_raw_underlying_ptr);
-                m_control_block_ptr->m_ref_count.store(1u);
-            } else {
-                // Multiple ownership
-                m_control_block_ptr = new control_block(1u, std::move(wrapper));
+        control_block_with_storage* cb = new control_block_with_storage(tag);
+        m_raw_underlying_ptr = cb->get();
+        m_control_block_ptr = cb;
+        enable_shared_from_this_aux();
+    }
+
+    /**
+     * @brief Constructs an array of %count elements inside its control block,
+     * with a single heap memory allocation.
+     */
+    shared_ptr_base(std::size_t count, bool overwrite)
+    {
+        control_block_with_array* cb = control_block_with_array::create(count, overwrite);
+        m_raw_underlying_ptr = cb->get();
+        m_control_block_ptr = cb;
+    }
+
+    /**
+     * @brief If T derives from dev::enable_shared_from_this, points its weak
+     * pointer at this new owner, unless it already observes an owner.
+     */
+    void enable_shared_from_this_aux() noexcept
+    {
+        if constexpr (std::is_base_of_v<enable_shared_from_this<T, RefCount>, T>) {
+            if (m_raw_underlying_ptr) {
+                const enable_shared_from_this<T, RefCount>* object = m_raw_underlying_ptr;
+                if (object->m_weak_this.expired())
+                    object->m_weak_this.assign_aux(m_raw_underlying_ptr, m_control_block_ptr);
             }
-            shared_ptr_base<T>::m_raw_underlying_ptr = ptr;
         }
     }
 
@@ -411,107 +633,301 @@ class shared_ptr_base
     control_block_base* m_control_block_ptr;
 };
 
-template<typename T>
-class shared_ptr : public shared_ptr_base<T>
+template<typename T, typename RefCount = atomic_ref_count>
+class shared_ptr : public shared_ptr_base<T, RefCount>
 {
   public:
-    using control_block = shared_ptr_base<T>::control_block;
-    using destroy_wrapper = typename shared_ptr_base<T>::destroy_wrapper;
-    shared_ptr()
-      : shared_ptr_base<T>()
+    shared_ptr() noexcept
+      : shared_ptr_base<T, RefCount>()
     {
     }
 
-    shared_ptr(std::nullptr_t)
-      : shared_ptr_base<T>(nullptr)
+    shared_ptr(std::nullptr_t) noexcept
+      : shared_ptr_base<T, RefCount>(nullptr)
     {
     }
 
     explicit shared_ptr(T* ptr)
-      : shared_ptr_base<T>(ptr)
+      : shared_ptr_base<T, RefCount>(ptr, std::default_delete<T>())
     {
-
-        try {
-            shared_ptr_base<T>::m_control_block_ptr =
-              new control_block(1u, destroy_wrapper(std::default_delete<T>()));
-        } catch (std::exception& ex) {
-            delete ptr;
-            // We may want to log the exception here
-            throw ex;
-        }
     }
 
     template<typename Deleter>
     explicit shared_ptr(T* ptr, Deleter deleter)
-      : shared_ptr_base<T>(ptr, destroy_wrapper(deleter))
+      : shared_ptr_base<T, RefCount>(ptr, std::move(deleter))
     {
     }
 
     template<typename... Args>
     explicit shared_ptr(Args... args)
-      : shared_ptr_base<T>(std::forward<Args>(args)...)
+      : shared_ptr_base<T, RefCount>(std::in_place, std::forward<Args>(args)...)
     {
     }
 
+    /**
+     * @brief Makes a default-initialized object inside the control block.
+     */
+    explicit shared_ptr(for_overwrite_t tag)
+      : shared_ptr_base<T, RefCount>(tag)
+    {
+    }
+
+    /**
+     * @brief Shares the ownership of the object that %weak observes.
+     * @throws std::bad_weak_ptr if %weak has expired.
+     */
+    explicit shared_ptr(const weak_ptr<T, RefCount>& weak)
+      : shared_ptr(weak.lock())
+    {
+        if (!this->m_control_block_ptr)
+            throw std::bad_weak_ptr();
+    }
+
+    /**
+     * @brief Releases the managed object.
+     */
+    void reset() noexcept { shared_ptr().swap(*this); }
+
     /**
      * @brief Replaces the managed object.
      */
-    void reset(T* ptr)
+    void reset(T* ptr) { shared_ptr(ptr).swap(*this); }
+
+    template<typename Deleter>
+    void reset(T* ptr, Deleter deleter)
     {
-        shared_ptr_base<T>::reset_base(ptr, destroy_wrapper(std::default_delete<T>()));
+        shared_ptr(ptr, std::move(deleter)).swap(*this);
     }
 };
 
-template<typename T>
-class shared_ptr<T[]> : public shared_ptr_base<T>
+template<typename T, typename RefCount>
+class shared_ptr<T[], RefCount> : public shared_ptr_base<T, RefCount>
 {
   public:
-    using control_block = shared_ptr_base<T>::control_block;
-    using destroy_wrapper = typename shared_ptr_base<T>::destroy_wrapper;
-
-    shared_ptr()
+    shared_ptr() noexcept
       : shared_ptr(nullptr)
     {
     }
-    shared_ptr(std::nullptr_t)
-      : shared_ptr_base<T>{ nullptr, destroy_wrapper(std::default_delete<T[]>()) }
+    shared_ptr(std::nullptr_t) noexcept
+      : shared_ptr_base<T, RefCount>(nullptr)
     {
     }
 
     explicit shared_ptr(T* ptr)
-      : shared_ptr_base<T>(ptr)
+      : shared_ptr_base<T, RefCount>(ptr, std::default_delete<T[]>())
     {
-        try {
-            shared_ptr_base<T>::m_control_block_ptr =
-              new control_block(1u, destroy_wrapper(std::default_delete<T[]>()));
-        } catch (std::exception& ex) {
-            delete[] ptr;
-            // We may want to log the exception here
-            throw ex;
-        }
     }
 
     template<typename Deleter = std::default_delete<T[]>>
     explicit shared_ptr(T* ptr, Deleter deleter)
-      : shared_ptr_base<T>(ptr, destroy_wrapper(deleter))
+      : shared_ptr_base<T, RefCount>(ptr, std::move(deleter))
     {
     }
 
-    template<typename... Args>
-    explicit shared_ptr(Args... args)
-      : shared_ptr_base<T[]>(std::forward<Args>(args)...)
+    /**
+     * @brief Makes %count value-initialized elements after the control block,
+     * with a single heap memory allocation.
+     */
+    shared_ptr(std::in_place_t, std::size_t count)
+      : shared_ptr_base<T, RefCount>(count, false)
+    {
+    }
+
+    /**
+     * @brief Makes %count default-initialized elements after the control
+     * block, with a single heap memory allocation.
+     */
+    shared_ptr(for_overwrite_t, std::size_t count)
+      : shared_ptr_base<T, RefCount>(count, true)
     {
     }
 
+    /**
+     * @brief Releases the managed array.
+     */
+    void reset() noexcept { shared_ptr().swap(*this); }
+
     /**
      * @brief Replaces the managed object.
      */
-    void reset(T* ptr)
+    void reset(T* ptr) { shared_ptr(ptr).swap(*this); }
+
+    template<typename Deleter>
+    void reset(T* ptr, Deleter deleter)
     {
-        shared_ptr_base<T>::reset_base(ptr, destroy_wrapper(std::default_delete<T[]>()));
+        shared_ptr(ptr, std::move(deleter)).swap(*this);
     }
 
-    T& operator[](int n) { return shared_ptr_base<T>::m_raw_underlying_ptr[n]; }
+    T& operator[](int n) { return shared_ptr_base<T, RefCount>::m_raw_underlying_ptr[n]; }
+};
+
+/**
+ * @brief A %shared_ptr to an array whose size is part of its type, as made by
+ * make_shared<T[N]>(). It behaves as the unbounded version.
+ */
+template<typename T, std::size_t N, typename RefCount>
+class shared_ptr<T[N], RefCount> : public shared_ptr<T[], RefCount>
+{
+  public:
+    using shared_ptr<T[], RefCount>::shared_ptr;
+
+    shared_ptr() noexcept = default;
+};
+
+/**
+ * @brief A non-owning observer of an object managed by dev::shared_ptr.
+ *
+ * It counts in the weak count of the control block, so the block outlives it,
+ * but the object does not: once the last shared_ptr goes, the object is
+ * destroyed, and lock() returns an empty pointer. Observers therefore break
+ * reference cycles, such as a child pointing back to its parent, and let a
+ * cache watch objects without keeping them alive.
+ */
+template<typename T, typename RefCount = atomic_ref_count>
+class weak_ptr
+{
+    template<typename, typename>
+    friend class shared_ptr_base;
+
+  public:
+    using element_type = std::remove_extent_t<T>;
+
+  private:
+    using base = shared_ptr_base<element_type, RefCount>;
+    using control_block_base = typename base::control_block_base;
+
+    element_type* m_raw_underlying_ptr{ nullptr };
+    control_block_base* m_control_block_ptr{ nullptr };
+
+    void assign_aux(element_type* ptr, control_block_base* cb) noexcept
+    {
+        if (cb)
+            cb->increment_weak();
+        if (m_control_block_ptr)
+            m_control_block_ptr->release_weak();
+        m_raw_underlying_ptr = ptr;
+        m_control_block_ptr = cb;
+    }
+
+  public:
+    weak_ptr() noexcept = default;
+
+    /**
+     * @brief Observes the object owned by %owner.
+     */
+    weak_ptr(const shared_ptr<T, RefCount>& owner) noexcept
+    {
+        const base& b = owner;
+        assign_aux(b.m_raw_underlying_ptr, b.m_control_block_ptr);
+    }
+
+    weak_ptr(const weak_ptr& other) noexcept
+    {
+        assign_aux(other.m_raw_underlying_ptr, other.m_control_block_ptr);
+    }
+
+    weak_ptr(weak_ptr&& other) noexcept
+      : m_raw_underlying_ptr{ std::exchange(other.m_raw_underlying_ptr, nullptr) }
+      , m_control_block_ptr{ std::exchange(other.m_control_block_ptr, nullptr) }
+    {
+    }
+
+    weak_ptr& operator=(const weak_ptr& other) noexcept
+    {
+        weak_ptr{ other }.swap(*this);
+        return *this;
+    }
+
+    weak_ptr& operator=(weak_ptr&& other) noexcept
+    {
+        weak_ptr{ std::move(other) }.swap(*this);
+        return *this;
+    }
+
+    weak_ptr& operator=(const shared_ptr<T, RefCount>& owner) noexcept
+    {
+        weak_ptr{ owner }.swap(*this);
+        return *this;
+    }
+
+    ~weak_ptr()
+    {
+        if (m_control_block_ptr)
+            m_control_block_ptr->release_weak();
+    }
+
+    void swap(weak_ptr& other) noexcept
+    {
+        std::swap(m_raw_underlying_ptr, other.m_raw_underlying_ptr);
+        std::swap(m_control_block_ptr, other.m_control_block_ptr);
+    }
+
+    friend void swap(weak_ptr& lhs, weak_ptr& rhs) noexcept { lhs.swap(rhs); }
+
+    void reset() noexcept { weak_ptr().swap(*this); }
+
+    /**
+     * @brief Returns the number of owners of the object. Under concurrent
+     * updates it is only a snapshot.
+     */
+    [[nodiscard]] unsigned long long use_count() const noexcept
+    {
+        return m_control_block_ptr ? m_control_block_ptr->use_count() : 0;
+    }
+
+    [[nodiscard]] bool expired() const noexcept { return use_count() == 0; }
+
+    /**
+     * @brief Returns an owner of the object, or an empty pointer if it is
+     * gone. It never blocks: the strong count is incremented by a
+     * compare-and-swap loop that fails once the count has dropped to zero.
+     */
+    [[nodiscard]] shared_ptr<T, RefCount> lock() const noexcept
+    {
+        shared_ptr<T, RefCount> result;
+        if (m_control_block_ptr && m_control_block_ptr->increment_if_nonzero()) {
+            base& b = result;
+            b.m_raw_underlying_ptr = m_raw_underlying_ptr;
+            b.m_control_block_ptr = m_control_block_ptr;
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief Lets an object managed by dev::shared_ptr hand out owners of itself.
+ *
+ * When a shared_ptr<T, RefCount> takes ownership of a T that derives from
+ * enable_shared_from_this<T, RefCount>, it points the weak pointer inside the
+ * object at itself, so shared_from_this() can share the ownership later. T
+ * must be the very type that the shared_ptr owns, with the same RefCount.
+ */
+template<typename T, typename RefCount = atomic_ref_count>
+class enable_shared_from_this
+{
+    template<typename, typename>
+    friend class shared_ptr_base;
+
+  private:
+    mutable weak_ptr<T, RefCount> m_weak_this;
+
+  protected:
+    enable_shared_from_this() noexcept = default;
+
+    // A copy is a new object, with no owner yet
+    enable_shared_from_this(const enable_shared_from_this&) noexcept {}
+    enable_shared_from_this& operator=(const enable_shared_from_this&) noexcept { return *this; }
+
+    ~enable_shared_from_this() = default;
+
+  public:
+    /**
+     * @brief Returns a new owner of this object.
+     * @throws std::bad_weak_ptr if no shared_ptr owns it.
+     */
+    shared_ptr<T, RefCount> shared_from_this() { return shared_ptr<T, RefCount>(m_weak_this); }
+
+    weak_ptr<T, RefCount> weak_from_this() noexcept { return m_weak_this; }
 };
 
 /**
@@ -520,12 +936,79 @@ class shared_ptr<T[]> : public shared_ptr_base<T>
  * and the control block.
  */
 template<typename T, typename... Args>
+    requires(!std::is_array_v<T>)
 shared_ptr<T> // Single-object version
 make_shared(Args&&... args)
 {
     return shared_ptr<T>(std::forward<Args>(args)...);
 }
 
-// TODO: Implement the array-version of make_shared<T[]>() available since C++20
+/**
+ * @brief Makes an array of %count value-initialized elements, in the same
+ * heap memory allocation as its control block.
+ */
+template<typename T>
+    requires std::is_unbounded_array_v<T>
+shared_ptr<T> // Array version
+make_shared(std::size_t count)
+{
+    return shared_ptr<T>(std::in_place, count);
+}
+
+template<typename T>
+    requires std::is_bounded_array_v<T>
+shared_ptr<T> // Fixed-size array version
+make_shared()
+{
+    return shared_ptr<T>(std::in_place, std::extent_v<T>);
+}
+
+/**
+ * @brief The versions of %make_shared that default-initialize the object or
+ * the elements: a buffer of a trivial type, about to be filled anyway, is
+ * left as it is instead of being zeroed first.
+ */
+template<typename T>
+    requires(!std::is_array_v<T>)
+shared_ptr<T>
+make_shared_for_overwrite()
+{
+    return shared_ptr<T>(for_overwrite);
+}
+
+template<typename T>
+    requires std::is_unbounded_array_v<T>
+shared_ptr<T>
+make_shared_for_overwrite(std::size_t count)
+{
+    return shared_ptr<T>(for_overwrite, count);
+}
+
+template<typename T>
+    requires std::is_bounded_array_v<T>
+shared_ptr<T>
+make_shared_for_overwrite()
+{
+    return shared_ptr<T>(for_overwrite, std::extent_v<T>);
+}
+
+/**
+ * @brief A %shared_ptr with a plain, non-atomic reference count, for objects
+ * shared within a single thread. Copying and destroying one is an ordinary
+ * increment and decrement, without any locked instruction. Its copies must
+ * never be used, or destroyed, concurrently from several threads.
+ */
+template<typename T>
+using local_shared_ptr = shared_ptr<T, local_ref_count>;
+
+/**
+ * @brief The %make_shared of %local_shared_ptr.
+ */
+template<typename T, typename... Args>
+local_shared_ptr<T>
+make_local_shared(Args&&... args)
+{
+    return local_shared_ptr<T>(std::forward<Args>(args)...);
+}
 
 } // namespace dev
\ No newline at end of file
@@ -0,0 +1,573 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define DEV_SIMD_X86 1
+#include <immintrin.h>
+// Compile a single function for a given instruction set, independently of the
+// -m flags the translation unit is built with. The caller is responsible for
+// checking that the CPU supports it.
+#define DEV_SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define DEV_SIMD_X86 0
+#endif
+
+/**
+ * @brief Vectorized linear scans and reductions (find, count, min, max, sum) over
+ * contiguous buffers of %double and %std::int64_t, e.g. a dev::vector<double>.
+ *
+ * Every algorithm has an AVX2 kernel, an SSE4.2 kernel and a scalar fallback. The
+ * widest kernel the CPU supports is picked at runtime, so the binary does not need
+ * to be compiled with -mavx2.
+ *
+ * @note sum() over doubles adds the elements in a different order than
+ * %std::accumulate, so the result may differ in the last bits. The result of
+ * min()/max() is unspecified if the input contains NaNs.
+ */
+namespace dev::simd {
+
+/**
+ * @brief The instruction sets for which kernels are available.
+ */
+enum class isa
+{
+    scalar,
+    sse42,
+    avx2
+};
+
+namespace detail {
+
+/**
+ * @brief Returns the widest instruction set supported by the CPU.
+ */
+inline isa detect_isa() noexcept
+{
+#if DEV_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return isa::avx2;
+    if (__builtin_cpu_supports("sse4.2"))
+        return isa::sse42;
+#endif
+    return isa::scalar;
+}
+
+inline std::atomic<isa>& active_isa_storage() noexcept
+{
+    static std::atomic<isa> level{ detect_isa() };
+    return level;
+}
+
+// Scalar kernels. They also handle the tails the vector kernels leave over.
+template<typename T>
+std::size_t find_scalar(const T* p, std::size_t n, T value) noexcept
+{
+    for (std::size_t i = 0; i < n; ++i)
+        if (p[i] == value)
+            return i;
+    return n;
+}
+
+template<typename T>
+std::size_t count_scalar(const T* p, std::size_t n, T value) noexcept
+{
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        result += (p[i] == value);
+    return result;
+}
+
+template<typename T>
+T min_scalar(const T* p, std::size_t n, T init) noexcept
+{
+    for (std::size_t i = 0; i < n; ++i)
+        init = p[i] < init ? p[i] : init;
+    return init;
+}
+
+template<typename T>
+T max_scalar(const T* p, std::size_t n, T init) noexcept
+{
+    for (std::size_t i = 0; i < n; ++i)
+        init = init < p[i] ? p[i] : init;
+    return init;
+}
+
+inline double sum_scalar(const double* p, std::size_t n) noexcept
+{
+    double result = 0.0;
+    for (std::size_t i = 0; i < n; ++i)
+        result += p[i];
+    return result;
+}
+
+inline std::int64_t sum_scalar(const std::int64_t* p, std::size_t n) noexcept
+{
+    // Wrap around on overflow, like the vector kernels do.
+    std::uint64_t result = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        result += static_cast<std::uint64_t>(p[i]);
+    return static_cast<std::int64_t>(result);
+}
+
+#if DEV_SIMD_X86
+
+// AVX2 kernels: 4 lanes of 64 bits.
+
+DEV_SIMD_TARGET("avx2")
+inline std::size_t find_avx2(const double* p, std::size_t n, double value) noexcept
+{
+    const __m256d v = _mm256_set1_pd(value);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d a = _mm256_cmp_pd(_mm256_loadu_pd(p + i), v, _CMP_EQ_OQ);
+        __m256d b = _mm256_cmp_pd(_mm256_loadu_pd(p + i + 4), v, _CMP_EQ_OQ);
+        unsigned mask = _mm256_movemask_pd(a) | (_mm256_movemask_pd(b) << 4);
+        if (mask)
+            return i + std::countr_zero(mask);
+    }
+    return i + find_scalar(p + i, n - i, value);
+}
+
+DEV_SIMD_TARGET("avx2")
+inline std::size_t find_avx2(const std::int64_t* p,
+                             std::size_t n,
+                             std::int64_t value) noexcept
+{
+    const __m256i v = _mm256_set1_epi64x(value);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i a = _mm256_cmpeq_epi64(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), v);
+        __m256i b = _mm256_cmpeq_epi64(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + 4)), v);
+        unsigned mask = _mm256_movemask_pd(_mm256_castsi256_pd(a)) |
+                        (_mm256_movemask_pd(_mm256_castsi256_pd(b)) << 4);
+        if (mask)
+            return i + std::countr_zero(mask);
+    }
+    return i + find_scalar(p + i, n - i, value);
+}
+
+DEV_SIMD_TARGET("avx2")
+inline std::size_t count_avx2(const double* p, std::size_t n, double value) noexcept
+{
+    // Each matching lane compares to all ones, i.e. -1, so subtracting the
+    // comparison result counts the matches per lane.
+    const __m256d v = _mm256_set1_pd(value);
+    __m256i acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d eq = _mm256_cmp_pd(_mm256_loadu_pd(p + i), v, _CMP_EQ_OQ);
+        acc = _mm256_sub_epi64(acc, _mm256_castpd_si256(eq));
+    }
+    alignas(32) std::int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + count_scalar(p + i, n - i, value);
+}
+
+DEV_SIMD_TARGET("avx2")
+inline std::size_t count_avx2(const std::int64_t* p,
+                              std::size_t n,
+                              std::int64_t value) noexcept
+{
+    const __m256i v = _mm256_set1_epi64x(value);
+    __m256i acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i eq = _mm256_cmpeq_epi64(
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)), v);
+        acc = _mm256_sub_epi64(acc, eq);
+    }
+    alignas(32) std::int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + count_scalar(p + i, n - i, value);
+}
+
+DEV_SIMD_TARGET("avx2")
+inline double min_avx2(const double* p, std::size_t n) noexcept
+{
+    if (n < 4)
+        return min_scalar(p + 1, n - 1, p[0]);
+
+    __m256d acc = _mm256_loadu_pd(p);
+    std::size_t i = 4;
+    for (; i + 4 <= n; i += 4)
+        acc = _mm256_min_pd(acc, _mm256_loadu_pd(p + i));
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, acc);
+    return min_scalar(p + i, n - i, min_scalar(lanes + 1, 3, lanes[0]));
+}
+
+DEV_SIMD_TARGET("avx2")
+inline double max_avx2(const double* p, std::size_t n) noexcept
+{
+    if (n < 4)
+        return max_scalar(p + 1, n - 1, p[0]);
+
+    __m256d acc = _mm256_loadu_pd(p);
+    std::size_t i = 4;
+    for (; i + 4 <= n; i += 4)
+        acc = _mm256_max_pd(acc, _mm256_loadu_pd(p + i));
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, acc);
+    return max_scalar(p + i, n - i, max_scalar(lanes + 1, 3, lanes[0]));
+}
+
+DEV_SIMD_TARGET("avx2")
+inline std::int64_t min_avx2(const std::int64_t* p, std::size_t n) noexcept
+{
+    if (n < 4)
+        return min_scalar(p + 1, n - 1, p[0]);
+
+    // There is no 64-bit integer min before AVX-512, so compare and blend.
+    __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    std::size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        acc = _mm256_blendv_epi8(acc, x, _mm256_cmpgt_epi64(acc, x));
+    }
+    alignas(32) std::int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return min_scalar(p + i, n - i, min_scalar(lanes + 1, 3, lanes[0]));
+}
+
+DEV_SIMD_TARGET("avx2")
+inline std::int64_t max_avx2(const std::int64_t* p, std::size_t n) noexcept
+{
+    if (n < 4)
+        return max_scalar(p + 1, n - 1, p[0]);
+
+    __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    std::size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        acc = _mm256_blendv_epi8(acc, x, _mm256_cmpgt_epi64(x, acc));
+    }
+    alignas(32) std::int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return max_scalar(p + i, n - i, max_scalar(lanes + 1, 3, lanes[0]));
+}
+
+DEV_SIMD_TARGET("avx2")
+inline double sum_avx2(const double* p, std::size_t n) noexcept
+{
+    // Two independent accumulators hide the latency of the FP adds.
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(p + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(p + i + 4));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_add_pd(acc0, acc1));
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + sum_scalar(p + i, n - i);
+}
+
+DEV_SIMD_TARGET("avx2")
+inline std::int64_t sum_avx2(const std::int64_t* p, std::size_t n) noexcept
+{
+    __m256i acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        acc = _mm256_add_epi64(
+          acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i)));
+    alignas(32) std::int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return sum_scalar(lanes, 4) + sum_scalar(p + i, n - i);
+}
+
+// SSE4.2 kernels: 2 lanes of 64 bits.
+
+DEV_SIMD_TARGET("sse4.2")
+inline std::size_t find_sse42(const double* p, std::size_t n, double value) noexcept
+{
+    const __m128d v = _mm_set1_pd(value);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128d a = _mm_cmpeq_pd(_mm_loadu_pd(p + i), v);
+        __m128d b = _mm_cmpeq_pd(_mm_loadu_pd(p + i + 2), v);
+        unsigned mask = _mm_movemask_pd(a) | (_mm_movemask_pd(b) << 2);
+        if (mask)
+            return i + std::countr_zero(mask);
+    }
+    return i + find_scalar(p + i, n - i, value);
+}
+
+DEV_SIMD_TARGET("sse4.2")
+inline std::size_t find_sse42(const std::int64_t* p,
+                              std::size_t n,
+                              std::int64_t value) noexcept
+{
+    const __m128i v = _mm_set1_epi64x(value);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i a =
+          _mm_cmpeq_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), v);
+        __m128i b = _mm_cmpeq_epi64(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 2)), v);
+        unsigned mask = _mm_movemask_pd(_mm_castsi128_pd(a)) |
+                        (_mm_movemask_pd(_mm_castsi128_pd(b)) << 2);
+        if (mask)
+            return i + std::countr_zero(mask);
+    }
+    return i + find_scalar(p + i, n - i, value);
+}
+
+DEV_SIMD_TARGET("sse4.2")
+inline std::size_t count_sse42(const double* p, std::size_t n, double value) noexcept
+{
+    const __m128d v = _mm_set1_pd(value);
+    __m128i acc = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d eq = _mm_cmpeq_pd(_mm_loadu_pd(p + i), v);
+        acc = _mm_sub_epi64(acc, _mm_castpd_si128(eq));
+    }
+    alignas(16) std::int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return lanes[0] + lanes[1] + count_scalar(p + i, n - i, value);
+}
+
+DEV_SIMD_TARGET("sse4.2")
+inline std::size_t count_sse42(const std::int64_t* p,
+                               std::size_t n,
+                               std::int64_t value) noexcept
+{
+    const __m128i v = _mm_set1_epi64x(value);
+    __m128i acc = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i eq =
+          _mm_cmpeq_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), v);
+        acc = _mm_sub_epi64(acc, eq);
+    }
+    alignas(16) std::int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return lanes[0] + lanes[1] + count_scalar(p + i, n - i, value);
+}
+
+DEV_SIMD_TARGET("sse4.2")
+inline double min_sse42(const double* p, std::size_t n) noexcept
+{
+    if (n < 2)
+        return p[0];
+
+    __m128d acc = _mm_loadu_pd(p);
+    std::size_t i = 2;
+    for (; i + 2 <= n; i += 2)
+        acc = _mm_min_pd(acc, _mm_loadu_pd(p + i));
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, acc);
+    return min_scalar(p + i, n - i, min_scalar(lanes + 1, 1, lanes[0]));
+}
+
+DEV_SIMD_TARGET("sse4.2")
+inline double max_sse42(const double* p, std::size_t n) noexcept
+{
+    if (n < 2)
+        return p[0];
+
+    __m128d acc = _mm_loadu_pd(p);
+    std::size_t i = 2;
+    for (; i + 2 <= n; i += 2)
+        acc = _mm_max_pd(acc, _mm_loadu_pd(p + i));
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, acc);
+    return max_scalar(p + i, n - i, max_scalar(lanes + 1, 1, lanes[0]));
+}
+
+DEV_SIMD_TARGET("sse4.2")
+inline std::int64_t min_sse42(const std::int64_t* p, std::size_t n) noexcept
+{
+    if (n < 2)
+        return p[0];
+
+    __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    std::size_t i = 2;
+    for (; i + 2 <= n; i += 2) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        acc = _mm_blendv_epi8(acc, x, _mm_cmpgt_epi64(acc, x));
+    }
+    alignas(16) std::int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return min_scalar(p + i, n - i, min_scalar(lanes + 1, 1, lanes[0]));
+}
+
+DEV_SIMD_TARGET("sse4.2")
+inline std::int64_t max_sse42(const std::int64_t* p, std::size_t n) noexcept
+{
+    if (n < 2)
+        return p[0];
+
+    __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    std::size_t i = 2;
+    for (; i + 2 <= n; i += 2) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        acc = _mm_blendv_epi8(acc, x, _mm_cmpgt_epi64(x, acc));
+    }
+    alignas(16) std::int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return max_scalar(p + i, n - i, max_scalar(lanes + 1, 1, lanes[0]));
+}
+
+DEV_SIMD_TARGET("sse4.2")
+inline double sum_sse42(const double* p, std::size_t n) noexcept
+{
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(p + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(p + i + 2));
+    }
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, _mm_add_pd(acc0, acc1));
+    return lanes[0] + lanes[1] + sum_scalar(p + i, n - i);
+}
+
+DEV_SIMD_TARGET("sse4.2")
+inline std::int64_t sum_sse42(const std::int64_t* p, std::size_t n) noexcept
+{
+    __m128i acc = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        acc =
+          _mm_add_epi64(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)));
+    alignas(16) std::int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return sum_scalar(lanes, 2) + sum_scalar(p + i, n - i);
+}
+
+#endif // DEV_SIMD_X86
+
+} // namespace detail
+
+/**
+ * @brief Returns the instruction set the algorithms currently dispatch to.
+ */
+inline isa active_isa() noexcept
+{
+    return detail::active_isa_storage().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Restricts the algorithms to the given instruction set, e.g. to compare
+ * kernels against each other. Requests for an instruction set the CPU does not
+ * support are capped at the widest one it does support.
+ * @return The instruction set that is now active.
+ */
+inline isa set_active_isa(isa level) noexcept
+{
+    isa supported = detail::detect_isa();
+    if (level > supported)
+        level = supported;
+    detail::active_isa_storage().store(level, std::memory_order_relaxed);
+    return level;
+}
+
+#if DEV_SIMD_X86
+#define DEV_SIMD_DISPATCH(name, ...)                                                     \
+    switch (active_isa()) {                                                              \
+        case isa::avx2:                                                                  \
+            return detail::name##_avx2(__VA_ARGS__);                                     \
+        case isa::sse42:                                                                 \
+            return detail::name##_sse42(__VA_ARGS__);                                    \
+        default:                                                                         \
+            break;                                                                       \
+    }
+#else
+#define DEV_SIMD_DISPATCH(name, ...)
+#endif
+
+/**
+ * @brief Returns the index of the first element equal to %value, or %s.size()
+ * if there is none.
+ */
+inline std::size_t find(std::span<const double> s, double value) noexcept
+{
+    DEV_SIMD_DISPATCH(find, s.data(), s.size(), value)
+    return detail::find_scalar(s.data(), s.size(), value);
+}
+
+inline std::size_t find(std::span<const std::int64_t> s, std::int64_t value) noexcept
+{
+    DEV_SIMD_DISPATCH(find, s.data(), s.size(), value)
+    return detail::find_scalar(s.data(), s.size(), value);
+}
+
+/**
+ * @brief Returns the number of elements equal to %value.
+ */
+inline std::size_t count(std::span<const double> s, double value) noexcept
+{
+    DEV_SIMD_DISPATCH(count, s.data(), s.size(), value)
+    return detail::count_scalar(s.data(), s.size(), value);
+}
+
+inline std::size_t count(std::span<const std::int64_t> s, std::int64_t value) noexcept
+{
+    DEV_SIMD_DISPATCH(count, s.data(), s.size(), value)
+    return detail::count_scalar(s.data(), s.size(), value);
+}
+
+/**
+ * @brief Returns the smallest element. %s must not be empty.
+ */
+inline double min(std::span<const double> s) noexcept
+{
+    assert(!s.empty());
+    DEV_SIMD_DISPATCH(min, s.data(), s.size())
+    return detail::min_scalar(s.data() + 1, s.size() - 1, s[0]);
+}
+
+inline std::int64_t min(std::span<const std::int64_t> s) noexcept
+{
+    assert(!s.empty());
+    DEV_SIMD_DISPATCH(min, s.data(), s.size())
+    return detail::min_scalar(s.data() + 1, s.size() - 1, s[0]);
+}
+
+/**
+ * @brief Returns the largest element. %s must not be empty.
+ */
+inline double max(std::span<const double> s) noexcept
+{
+    assert(!s.empty());
+    DEV_SIMD_DISPATCH(max, s.data(), s.size())
+    return detail::max_scalar(s.data() + 1, s.size() - 1, s[0]);
+}
+
+inline std::int64_t max(std::span<const std::int64_t> s) noexcept
+{
+    assert(!s.empty());
+    DEV_SIMD_DISPATCH(max, s.data(), s.size())
+    return detail::max_scalar(s.data() + 1, s.size() - 1, s[0]);
+}
+
+/**
+ * @brief Returns the sum of the elements. Integer sums wrap around on overflow.
+ */
+inline double sum(std::span<const double> s) noexcept
+{
+    DEV_SIMD_DISPATCH(sum, s.data(), s.size())
+    return detail::sum_scalar(s.data(), s.size());
+}
+
+inline std::int64_t sum(std::span<const std::int64_t> s) noexcept
+{
+    DEV_SIMD_DISPATCH(sum, s.data(), s.size())
+    return detail::sum_scalar(s.data(), s.size());
+}
+
+#undef DEV_SIMD_DISPATCH
+
+} // namespace dev::simd
@@ -0,0 +1,512 @@
+#pragma once
+
+#include "epoch_reclaimer/epoch_reclaimer.h"
+#include "node_pool/node_pool.h"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace dev {
+
+/**
+ * @brief An ordered map in a lock-free skip list, after the algorithm of
+ * Fraser and of Herlihy and Shavit.
+ *
+ * Every node is linked in level 0, which holds all entries in order, and in
+ * the levels above up to its random height, each of which skips about half of
+ * the nodes of the level below. Lookups start at the top level of the head
+ * tower and go down, in O(log n) expected steps.
+ *
+ * insert(), erase() and find() take no lock. A node is erased by marking the
+ * low bit of its next pointers, from the top level down; marking level 0 is
+ * the linearization point. Whichever thread then walks past a marked link
+ * unlinks the node at that level. An insertion is linearized when the node is
+ * linked in level 0, and links the levels above afterwards.
+ *
+ * A node can only be freed once it is unlinked from every level it was linked
+ * in, so it counts its pending links: the thread that removes the last one
+ * retires the node to dev::epoch_reclaimer. Nodes of every height come from
+ * their own dev::node_pool, and heights are drawn from a thread-local
+ * xorshift generator.
+ *
+ * Entries are immutable once inserted, so readers never race with writers on
+ * a value: find() returns a copy, and iteration is lock-free and weakly
+ * consistent, as in dev::concurrent_forward_list. An iterator pins its thread
+ * while it lives, so it must stay on that thread.
+ */
+template<typename Key,
+         typename T,
+         typename Compare = std::less<Key>,
+         std::size_t MaxLevel = 24>
+class skip_list_map
+{
+    static_assert(MaxLevel >= 1 && MaxLevel <= 64, "MaxLevel must be in [1, 64]");
+
+  public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using key_compare = Compare;
+    using reference = const value_type&;
+    using const_reference = const value_type&;
+
+    static constexpr size_type max_level = MaxLevel;
+
+  private:
+    // A tagged pointer to the next node; the low bit marks the node holding
+    // the link as erased at that level
+    using link = std::uintptr_t;
+    static constexpr link mark_bit = 1;
+
+    /**
+     * @brief A node, followed in the same block by its tower of %height
+     * links.
+     */
+    struct alignas(std::atomic<link>) node
+    {
+        value_type value;
+        std::uint32_t height;
+        // The levels the node is linked in, plus one while its insertion runs
+        std::atomic<std::uint32_t> pending;
+
+        std::atomic<link>* tower() noexcept
+        {
+            return std::launder(reinterpret_cast<std::atomic<link>*>(this + 1));
+        }
+    };
+
+    static node* to_node(link l) noexcept
+    {
+        return reinterpret_cast<node*>(l & ~mark_bit);
+    }
+    static link to_link(node* n) noexcept { return reinterpret_cast<link>(n); }
+    static bool is_marked(link l) noexcept { return l & mark_bit; }
+
+    static constexpr std::size_t block_size(std::size_t height) noexcept
+    {
+        return sizeof(node) + height * sizeof(std::atomic<link>);
+    }
+
+    struct pool_functions
+    {
+        void* (*allocate)();
+        void (*deallocate)(void*) noexcept;
+    };
+
+    template<std::size_t... Heights>
+    static constexpr auto make_pools(std::index_sequence<Heights...>) noexcept
+    {
+        return std::array<pool_functions, MaxLevel>{ pool_functions{
+          &node_pool<block_size(Heights + 1), alignof(node)>::allocate,
+          &node_pool<block_size(Heights + 1), alignof(node)>::deallocate }... };
+    }
+
+    // The pool for nodes of height h is pools[h - 1]
+    static constexpr auto pools = make_pools(std::make_index_sequence<MaxLevel>());
+
+    std::array<std::atomic<link>, MaxLevel> m_head{};
+    std::atomic<size_type> m_size{ 0 };
+    [[no_unique_address]] Compare m_comp;
+
+    /**
+     * @brief Draws a height from a geometric distribution with p = 1/2.
+     */
+    static std::uint32_t random_height_aux() noexcept
+    {
+        thread_local std::uint64_t state =
+          0x9e3779b97f4a7c15ull ^ reinterpret_cast<std::uintptr_t>(&state);
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        auto height =
+          static_cast<std::size_t>(std::countr_zero(state | (1ull << 63))) + 1;
+        return static_cast<std::uint32_t>(std::min(height, MaxLevel));
+    }
+
+    template<typename... Args>
+    static node* create_node_aux(std::uint32_t height, Args&&... args)
+    {
+        void* block = pools[height - 1].allocate();
+        node* n;
+        try {
+            n = ::new (block) node{ value_type(std::forward<Args>(args)...), height, {} };
+        } catch (...) {
+            pools[height - 1].deallocate(block);
+            throw;
+        }
+        n->pending.store(height + 1, std::memory_order_relaxed);
+        std::atomic<link>* tower = n->tower();
+        for (std::uint32_t level = 0; level < height; ++level)
+            ::new (tower + level) std::atomic<link>(0);
+        return n;
+    }
+
+    static void destroy_node_aux(node* n) noexcept
+    {
+        const std::uint32_t height = n->height;
+        std::destroy_n(n->tower(), height);
+        std::destroy_at(n);
+        pools[height - 1].deallocate(n);
+    }
+
+    static void destroy_node_aux(void* p) noexcept
+    {
+        destroy_node_aux(static_cast<node*>(p));
+    }
+
+    /**
+     * @brief Drops %count pending links of %n, and retires it once none is
+     * left.
+     */
+    static void release_aux(node* n, std::uint32_t count)
+    {
+        if (n->pending.fetch_sub(count, std::memory_order_acq_rel) == count)
+            epoch_reclaimer::retire(n, &destroy_node_aux);
+    }
+
+    std::atomic<link>* head_tower() noexcept { return m_head.data(); }
+    const std::atomic<link>* head_tower() const noexcept { return m_head.data(); }
+
+    /**
+     * @brief For every level, finds the tower of the last node less than %key
+     * and the first node not less than it, unlinking the marked nodes on the
+     * way. Returns whether the level 0 successor is equivalent to %key. The
+     * caller must be pinned.
+     */
+    template<typename K>
+    bool search_aux(const K& key, std::atomic<link>** preds, node** succs)
+    {
+    retry:
+        std::atomic<link>* pred = head_tower();
+        node* curr = nullptr;
+        for (std::size_t level = MaxLevel; level-- > 0;) {
+            curr = to_node(pred[level].load(std::memory_order_acquire));
+            while (curr) {
+                link next = curr->tower()[level].load(std::memory_order_acquire);
+                if (is_marked(next)) {
+                    link expected = to_link(curr);
+                    if (!pred[level].compare_exchange_strong(
+                          expected, next & ~mark_bit, std::memory_order_acq_rel))
+                        goto retry;
+                    release_aux(curr, 1);
+                    curr = to_node(next);
+                    continue;
+                }
+                if (!m_comp(curr->value.first, key))
+                    break;
+                pred = curr->tower();
+                curr = to_node(next);
+            }
+            preds[level] = pred;
+            succs[level] = curr;
+        }
+        return curr && !m_comp(key, curr->value.first);
+    }
+
+    /**
+     * @brief Returns the first unmarked node not less than %key, without
+     * writing to the list. The caller must be pinned.
+     */
+    template<typename K>
+    node* lower_bound_aux(const K& key) const
+    {
+        const std::atomic<link>* pred = head_tower();
+        node* curr = nullptr;
+        for (std::size_t level = MaxLevel; level-- > 0;) {
+            curr = to_node(pred[level].load(std::memory_order_acquire));
+            while (curr) {
+                link next = curr->tower()[level].load(std::memory_order_acquire);
+                if (!is_marked(next) && !m_comp(curr->value.first, key))
+                    break;
+                if (!is_marked(next))
+                    pred = curr->tower();
+                curr = to_node(next);
+            }
+        }
+        return curr;
+    }
+
+    template<typename... Args>
+    bool emplace_aux(const Key& key, Args&&... args)
+    {
+        epoch_reclaimer::guard guard;
+        std::atomic<link>* preds[MaxLevel];
+        node* succs[MaxLevel];
+        node* n = nullptr;
+        std::uint32_t height = 0;
+        while (true) {
+            if (search_aux(key, preds, succs)) {
+                if (n)
+                    destroy_node_aux(n);
+                return false;
+            }
+            if (!n) {
+                height = random_height_aux();
+                n = create_node_aux(height, std::forward<Args>(args)...);
+            }
+            for (std::uint32_t level = 0; level < height; ++level)
+                n->tower()[level].store(to_link(succs[level]), std::memory_order_relaxed);
+            link expected = to_link(succs[0]);
+            if (preds[0][0].compare_exchange_strong(expected,
+                                                    to_link(n),
+                                                    std::memory_order_release,
+                                                    std::memory_order_relaxed))
+                break;
+        }
+        m_size.fetch_add(1, std::memory_order_relaxed);
+
+        // Link the levels above, until done or until the node gets erased
+        std::uint32_t linked = 1;
+        for (std::uint32_t level = 1; level < height; ++level) {
+            while (true) {
+                link next = n->tower()[level].load(std::memory_order_acquire);
+                if (is_marked(next))
+                    goto done;
+                if (to_node(next) != succs[level] &&
+                    !n->tower()[level].compare_exchange_strong(
+                      next, to_link(succs[level]), std::memory_order_acq_rel))
+                    goto done;
+                link expected = to_link(succs[level]);
+                if (preds[level][level].compare_exchange_strong(
+                      expected,
+                      to_link(n),
+                      std::memory_order_release,
+                      std::memory_order_relaxed)) {
+                    ++linked;
+                    break;
+                }
+                search_aux(key, preds, succs);
+                if (succs[0] != n)
+                    goto done;
+            }
+        }
+    done:
+        const bool erased = is_marked(n->tower()[0].load(std::memory_order_acquire));
+        release_aux(n, height - linked + 1);
+        // Levels linked after an eraser went by are left to the next search
+        if (erased)
+            search_aux(key, preds, succs);
+        return true;
+    }
+
+  public:
+    /**
+     * @brief A forward iterator over the entries, in key order, that skips
+     * erased entries. It keeps the calling thread pinned, so the entry it
+     * points to stays valid even if another thread erases it.
+     */
+    class const_iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = skip_list_map::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+      private:
+        friend class skip_list_map;
+
+        epoch_reclaimer::guard m_guard;
+        node* m_node{ nullptr };
+
+        void skip_erased_aux() noexcept
+        {
+            while (m_node) {
+                link next = m_node->tower()[0].load(std::memory_order_acquire);
+                if (!is_marked(next))
+                    return;
+                m_node = to_node(next);
+            }
+        }
+
+      public:
+        const_iterator() = default;
+
+        reference operator*() const noexcept { return m_node->value; }
+        pointer operator->() const noexcept { return &m_node->value; }
+
+        const_iterator& operator++() noexcept
+        {
+            m_node = to_node(m_node->tower()[0].load(std::memory_order_acquire));
+            skip_erased_aux();
+            return *this;
+        }
+
+        const_iterator operator++(int) noexcept
+        {
+            auto temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        friend bool operator==(const const_iterator& lhs,
+                               const const_iterator& rhs) noexcept
+        {
+            return lhs.m_node == rhs.m_node;
+        }
+    };
+
+    using iterator = const_iterator;
+
+    skip_list_map() = default;
+
+    explicit skip_list_map(const Compare& comp)
+      : m_comp(comp)
+    {
+    }
+
+    skip_list_map(const skip_list_map&) = delete;
+    skip_list_map& operator=(const skip_list_map&) = delete;
+
+    /**
+     * @brief Frees all nodes. No other thread may access the map anymore.
+     */
+    ~skip_list_map()
+    {
+        // A node can be linked in upper levels only, if it was unlinked from
+        // level 0 first, so every level is walked and a node is freed when
+        // its last link is dropped. Levels are walked from the top, so a node
+        // is freed at its lowest linked level, after which it is not reached
+        // again.
+        for (std::size_t level = MaxLevel; level-- > 0;) {
+            node* n = to_node(m_head[level].load(std::memory_order_relaxed));
+            while (n) {
+                node* next = to_node(n->tower()[level].load(std::memory_order_relaxed));
+                if (n->pending.fetch_sub(1, std::memory_order_relaxed) == 1)
+                    destroy_node_aux(n);
+                n = next;
+            }
+        }
+    }
+
+    size_type size() const noexcept { return m_size.load(std::memory_order_relaxed); }
+    bool empty() const { return begin() == end(); }
+
+    const_iterator begin() const
+    {
+        // The guard of the iterator is constructed before the head is read
+        const_iterator it;
+        it.m_node = to_node(m_head[0].load(std::memory_order_acquire));
+        it.skip_erased_aux();
+        return it;
+    }
+
+    const_iterator cbegin() const { return begin(); }
+    const_iterator end() const { return const_iterator(); }
+    const_iterator cend() const { return end(); }
+
+    /**
+     * @brief Returns an iterator to the first entry whose key is not less than
+     * %key, for ordered scans from a price.
+     */
+    template<typename K = Key>
+    const_iterator lower_bound(const K& key) const
+    {
+        const_iterator it;
+        it.m_node = lower_bound_aux(key);
+        return it;
+    }
+
+    /**
+     * @brief Inserts %value unless an entry with an equivalent key is present.
+     * @return Whether %value was inserted.
+     */
+    bool insert(const value_type& value) { return emplace_aux(value.first, value); }
+
+    bool insert(const Key& key, const T& value) { return try_emplace(key, value); }
+
+    /**
+     * @brief Inserts an entry with %key and a value constructed from %args,
+     * unless an entry with an equivalent key is present.
+     * @return Whether the entry was inserted.
+     */
+    template<typename... Args>
+    bool try_emplace(const Key& key, Args&&... args)
+    {
+        return emplace_aux(key,
+                           std::piecewise_construct,
+                           std::forward_as_tuple(key),
+                           std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    /**
+     * @brief Erases the entry with a key equivalent to %key, if any.
+     * @return Whether this call erased it. Of several threads erasing the
+     * same entry, exactly one succeeds.
+     */
+    template<typename K = Key>
+    bool erase(const K& key)
+    {
+        epoch_reclaimer::guard guard;
+        std::atomic<link>* preds[MaxLevel];
+        node* succs[MaxLevel];
+        if (!search_aux(key, preds, succs))
+            return false;
+
+        node* victim = succs[0];
+        for (std::uint32_t level = victim->height; level-- > 1;) {
+            link next = victim->tower()[level].load(std::memory_order_acquire);
+            while (!is_marked(next) &&
+                   !victim->tower()[level].compare_exchange_weak(
+                     next, next | mark_bit, std::memory_order_acq_rel)) {
+            }
+        }
+        link next = victim->tower()[0].load(std::memory_order_acquire);
+        while (true) {
+            if (is_marked(next))
+                return false;
+            if (victim->tower()[0].compare_exchange_weak(
+                  next, next | mark_bit, std::memory_order_acq_rel)) {
+                m_size.fetch_sub(1, std::memory_order_relaxed);
+                // Unlink it from every level
+                search_aux(key, preds, succs);
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns a copy of the value mapped to %key, if any.
+     */
+    template<typename K = Key>
+    std::optional<T> find(const K& key) const
+    {
+        epoch_reclaimer::guard guard;
+        node* n = lower_bound_aux(key);
+        if (n && !m_comp(key, n->value.first))
+            return n->value.second;
+        return std::nullopt;
+    }
+
+    template<typename K = Key>
+    bool contains(const K& key) const
+    {
+        epoch_reclaimer::guard guard;
+        node* n = lower_bound_aux(key);
+        return n && !m_comp(key, n->value.first);
+    }
+
+    /**
+     * @brief Calls %f on every entry, in key order, with the thread pinned once
+     * for the whole walk.
+     */
+    template<typename F>
+    void for_each(F f) const
+    {
+        for (const value_type& entry : *this)
+            f(entry);
+    }
+};
+
+} // namespace dev
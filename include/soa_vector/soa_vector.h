@@ -0,0 +1,376 @@
+#pragma once
+
+#include "vector/vector.h"
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace dev {
+
+/**
+ * @brief A structure-of-arrays container. Conceptually a sequence of
+ * %std::tuple<Fields...> records, but each field is stored in its own contiguous
+ * dev::vector (a column).
+ *
+ * A loop that only reads a couple of fields of every record then only pulls
+ * those columns through the cache, and each column can be handed to a
+ * vectorized kernel as a %std::span via column<I>().
+ *
+ * Element access returns proxy references of type %std::tuple<Fields&...>, which
+ * work with structured bindings:
+ *
+ *     for (auto [price, qty] : book) notional += price * qty;
+ */
+template<typename... Fields>
+class soa_vector
+{
+    static_assert(sizeof...(Fields) > 0, "soa_vector needs at least one field");
+
+  public:
+    using value_type = std::tuple<Fields...>;
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<const Fields&...>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    /**
+     * @brief The type of the %I-th field.
+     */
+    template<std::size_t I>
+    using field_type = std::tuple_element_t<I, value_type>;
+
+  private:
+    std::tuple<vector<Fields>...> m_columns;
+
+    static constexpr auto m_indices = std::index_sequence_for<Fields...>{};
+
+    template<std::size_t... Is>
+    reference make_reference_aux(size_type n, std::index_sequence<Is...>)
+    {
+        return reference(std::get<Is>(m_columns)[n]...);
+    }
+
+    template<std::size_t... Is>
+    const_reference make_reference_aux(size_type n, std::index_sequence<Is...>) const
+    {
+        return const_reference(std::get<Is>(m_columns)[n]...);
+    }
+
+    /**
+     * @brief Appends one element to every column. If appending to a column
+     * throws, the elements already appended to the preceding columns are
+     * removed again, so all columns keep the same length.
+     */
+    template<typename Tuple, std::size_t... Is>
+    void push_back_aux(Tuple&& record, std::index_sequence<Is...>)
+    {
+        std::size_t num_pushed{ 0 };
+        try {
+            ((std::get<Is>(m_columns).push_back(
+                std::get<Is>(std::forward<Tuple>(record))),
+              ++num_pushed),
+             ...);
+        } catch (...) {
+            ((Is < num_pushed ? std::get<Is>(m_columns).pop_back() : void()), ...);
+            throw;
+        }
+    }
+
+    template<typename F>
+    void for_each_column_aux(F&& f)
+    {
+        std::apply([&f](auto&... column) { (f(column), ...); }, m_columns);
+    }
+
+  public:
+    /**
+     * @brief Random-access iterator over the records. Dereferencing yields a
+     * tuple of references into the columns.
+     * The iterator refers to the container and an index, so it is not invalidated
+     * by growth, only by erasing the element it refers to.
+     */
+    template<bool Const>
+    class Iterator
+    {
+      public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag; // proxy references
+        using value_type = soa_vector::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference =
+          std::conditional_t<Const, const_reference, soa_vector::reference>;
+        using container_pointer =
+          std::conditional_t<Const, const soa_vector*, soa_vector*>;
+
+        Iterator() = default;
+
+        Iterator(container_pointer container, size_type index)
+          : m_container{ container }
+          , m_index{ index }
+        {
+        }
+
+        /**
+         * @brief Conversion from a read/write iterator to a read-only one.
+         */
+        template<bool OtherConst>
+            requires(Const && !OtherConst)
+        Iterator(const Iterator<OtherConst>& other)
+          : m_container{ other.m_container }
+          , m_index{ other.m_index }
+        {
+        }
+
+        reference operator*() const { return (*m_container)[m_index]; }
+        reference operator[](difference_type n) const
+        {
+            return (*m_container)[m_index + n];
+        }
+
+        Iterator& operator++()
+        {
+            ++m_index;
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto temp = *this;
+            ++m_index;
+            return temp;
+        }
+
+        Iterator& operator--()
+        {
+            --m_index;
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            auto temp = *this;
+            --m_index;
+            return temp;
+        }
+
+        Iterator& operator+=(difference_type n)
+        {
+            m_index += n;
+            return *this;
+        }
+
+        Iterator& operator-=(difference_type n)
+        {
+            m_index -= n;
+            return *this;
+        }
+
+        Iterator operator+(difference_type n) const
+        {
+            return Iterator(m_container, m_index + n);
+        }
+        friend Iterator operator+(difference_type n, Iterator it) { return it + n; }
+        Iterator operator-(difference_type n) const
+        {
+            return Iterator(m_container, m_index - n);
+        }
+
+        difference_type operator-(const Iterator& other) const
+        {
+            return static_cast<difference_type>(m_index) -
+                   static_cast<difference_type>(other.m_index);
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs)
+        {
+            return lhs.m_index == rhs.m_index;
+        }
+
+        friend auto operator<=>(const Iterator& lhs, const Iterator& rhs)
+        {
+            return lhs.m_index <=> rhs.m_index;
+        }
+
+      private:
+        friend Iterator<true>;
+        container_pointer m_container{ nullptr };
+        size_type m_index{ 0 };
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    // Constructors
+    /**
+     * @brief Creates a soa_vector with no elements.
+     */
+    soa_vector() = default;
+
+    /**
+     * @brief Creates a soa_vector holding copies of the records in the
+     * initializer list.
+     */
+    soa_vector(std::initializer_list<value_type> records)
+    {
+        reserve(records.size());
+        for (const auto& record : records)
+            push_back(record);
+    }
+
+    // Capacity related member functions
+    /**
+     * @brief Returns the number of records.
+     */
+    [[nodiscard]] size_type size() const { return std::get<0>(m_columns).size(); }
+
+    /**
+     * @brief Returns true if the container holds no records.
+     */
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    /**
+     * @brief Returns the number of records that fit without reallocating
+     * any of the columns.
+     */
+    [[nodiscard]] size_type capacity() const
+    {
+        return std::apply(
+          [](const auto&... column) { return std::min({ column.capacity()... }); },
+          m_columns);
+    }
+
+    /**
+     * @brief Reserves room for %new_capacity records in every column.
+     */
+    void reserve(size_type new_capacity)
+    {
+        for_each_column_aux(
+          [new_capacity](auto& column) { column.reserve(new_capacity); });
+    }
+
+    /**
+     * @brief Resizes every column to %new_size, value-initializing new records.
+     */
+    void resize(size_type new_size)
+    {
+        for_each_column_aux([new_size](auto& column) { column.resize(new_size); });
+    }
+
+    /**
+     * @brief Removes all records. The capacity is left unchanged.
+     */
+    void clear() { resize(0); }
+
+    // Element access
+    /**
+     * @brief Returns a tuple of references to the fields of the %n-th record.
+     */
+    reference operator[](size_type n) { return make_reference_aux(n, m_indices); }
+    const_reference operator[](size_type n) const
+    {
+        return make_reference_aux(n, m_indices);
+    }
+
+    /**
+     * @brief Bounds-checked element access.
+     * @throws std::out_of_range if %n >= size().
+     */
+    reference at(size_type n)
+    {
+        if (n >= size())
+            throw std::out_of_range("Index out of bounds!");
+        return (*this)[n];
+    }
+
+    const_reference at(size_type n) const
+    {
+        if (n >= size())
+            throw std::out_of_range("Index out of bounds!");
+        return (*this)[n];
+    }
+
+    reference front() { return (*this)[0]; }
+    const_reference front() const { return (*this)[0]; }
+    reference back() { return (*this)[size() - 1]; }
+    const_reference back() const { return (*this)[size() - 1]; }
+
+    /**
+     * @brief Returns the %I-th column as a contiguous span, e.g. to feed
+     * it to a vectorized kernel.
+     * @note The span is invalidated when the container reallocates.
+     */
+    template<std::size_t I>
+    std::span<field_type<I>> column()
+    {
+        auto& c = std::get<I>(m_columns);
+        return std::span<field_type<I>>(c.data(), c.size());
+    }
+
+    template<std::size_t I>
+    std::span<const field_type<I>> column() const
+    {
+        const auto& c = std::get<I>(m_columns);
+        return std::span<const field_type<I>>(c.data(), c.size());
+    }
+
+    // Modifiers
+    /**
+     * @brief Appends a record. Each field is copied into its column.
+     */
+    void push_back(const value_type& record) { push_back_aux(record, m_indices); }
+
+    /**
+     * @brief Appends a record. Each field is moved into its column.
+     */
+    void push_back(value_type&& record) { push_back_aux(std::move(record), m_indices); }
+
+    /**
+     * @brief Appends a record built from one argument per field.
+     */
+    template<typename... Args>
+        requires(sizeof...(Args) == sizeof...(Fields))
+    reference emplace_back(Args&&... args)
+    {
+        push_back_aux(std::forward_as_tuple(std::forward<Args>(args)...), m_indices);
+        return back();
+    }
+
+    /**
+     * @brief Removes the last record.
+     */
+    void pop_back()
+    {
+        for_each_column_aux([](auto& column) { column.pop_back(); });
+    }
+
+    // Iterators
+    iterator begin() { return iterator(this, 0); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return iterator(this, size()); }
+    const_iterator end() const { return const_iterator(this, size()); }
+    const_iterator cend() const { return end(); }
+
+    /**
+     * @brief Swaps the contents with another soa_vector.
+     */
+    void swap(soa_vector& other) noexcept
+    {
+        std::apply(
+          [&other](auto&... column) {
+              std::apply(
+                [&column...](auto&... other_column) { (column.swap(other_column), ...); },
+                other.m_columns);
+          },
+          m_columns);
+    }
+};
+
+} // namespace dev
@@ -0,0 +1,424 @@
+#pragma once
+
+#include "hardening/hardening.h"
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace dev {
+
+namespace detail {
+
+/**
+ * @brief The default number of elements per node of an unrolled_forward_list:
+ * about 512 bytes of elements, and at least 8 of them.
+ */
+template<typename T>
+inline constexpr std::size_t unrolled_node_capacity =
+  std::max<std::size_t>(8, 512 / sizeof(T));
+
+} // namespace detail
+
+/**
+ * @brief A singly-linked list whose nodes each hold up to K elements.
+ *
+ * Traversal walks an array within each node, so it takes one cache miss per
+ * node instead of one per element. Inserting into a full node splits it in
+ * two halves, and erasing from a node that drops below half full merges it
+ * with the next node when both fit, so nodes stay at least about half full
+ * and insertion stays O(K) in the worst case, O(1) amortized.
+ *
+ * Unlike dev::forward_list, insertion and erasure move the elements that
+ * share a node with the affected position, so they invalidate iterators and
+ * references to the elements of that node and of the node it is split from
+ * or merged with. Elements must be nothrow move constructible.
+ */
+template<typename T, std::size_t K = detail::unrolled_node_capacity<T>>
+class unrolled_forward_list
+{
+    static_assert(K >= 2, "unrolled_forward_list nodes must hold at least two elements");
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+                  "unrolled_forward_list relocates elements between nodes");
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+
+    static constexpr size_type node_capacity = K;
+
+  private:
+    /**
+     * @brief The link and element count of a node. The list keeps one as the
+     * sentinel that before_begin() points to, with no elements.
+     */
+    struct node_base
+    {
+        node_base* next{ nullptr };
+        size_type count{ 0 };
+    };
+
+    struct node : node_base
+    {
+        alignas(T) std::byte storage[K * sizeof(T)];
+
+        T* data() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    node_base m_before_head;
+    size_type m_size{ 0 };
+
+    static node* as_node(node_base* base) noexcept { return static_cast<node*>(base); }
+
+    /**
+     * @brief Links a new, empty node after %prev.
+     */
+    static node* create_node_after_aux(node_base* prev)
+    {
+        node* n = new node;
+        n->next = prev->next;
+        prev->next = n;
+        return n;
+    }
+
+    /**
+     * @brief Unlinks the empty node after %prev and frees it.
+     */
+    static void destroy_node_after_aux(node_base* prev) noexcept
+    {
+        node_base* n = prev->next;
+        prev->next = n->next;
+        delete as_node(n);
+    }
+
+    /**
+     * @brief Moves the elements [%first, count) of %from to the end of %to.
+     */
+    static void relocate_tail_aux(node* from, size_type first, node* to) noexcept
+    {
+        T* src = from->data();
+        T* dst = to->data() + to->count;
+        for (size_type i = first; i < from->count; ++i, ++dst) {
+            std::construct_at(dst, std::move(src[i]));
+            std::destroy_at(src + i);
+        }
+        to->count += from->count - first;
+        from->count = first;
+    }
+
+    /**
+     * @brief Constructs an element at index %i of %n, which is not full.
+     */
+    template<typename... Args>
+    static T* emplace_in_node_aux(node* n, size_type i, Args&&... args)
+    {
+        T* data = n->data();
+        if (i == n->count) {
+            std::construct_at(data + i, std::forward<Args>(args)...);
+        } else {
+            T value(std::forward<Args>(args)...);
+            std::construct_at(data + n->count, std::move(data[n->count - 1]));
+            std::move_backward(data + i, data + n->count - 1, data + n->count);
+            data[i] = std::move(value);
+        }
+        ++n->count;
+        return data + i;
+    }
+
+  public:
+    template<bool Const>
+    class Iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+      private:
+        friend class unrolled_forward_list;
+        friend Iterator<true>;
+
+        // Either end() with a null node, before_begin() on the sentinel, or an
+        // element at an index below the count of its node
+        node_base* m_node{ nullptr };
+        size_type m_index{ 0 };
+
+        Iterator(node_base* n, size_type index) noexcept
+          : m_node(n)
+          , m_index(index)
+        {
+        }
+
+      public:
+        Iterator() = default;
+
+        template<bool OtherConst>
+            requires(Const && !OtherConst)
+        Iterator(const Iterator<OtherConst>& other) noexcept
+          : m_node(other.m_node)
+          , m_index(other.m_index)
+        {
+        }
+
+        reference operator*() const noexcept { return as_node(m_node)->data()[m_index]; }
+        pointer operator->() const noexcept { return as_node(m_node)->data() + m_index; }
+
+        Iterator& operator++() noexcept
+        {
+            // The sentinel has no elements, so it moves to the first node too
+            if (++m_index >= m_node->count) {
+                m_node = m_node->next;
+                m_index = 0;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            auto temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept
+        {
+            return lhs.m_node == rhs.m_node && lhs.m_index == rhs.m_index;
+        }
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    unrolled_forward_list() = default;
+
+    template<std::input_iterator It>
+    unrolled_forward_list(It first, It last)
+    {
+        try {
+            auto tail = before_begin();
+            for (; first != last; ++first)
+                tail = emplace_after(tail, *first);
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    unrolled_forward_list(std::initializer_list<T> init)
+      : unrolled_forward_list(init.begin(), init.end())
+    {
+    }
+
+    unrolled_forward_list(const unrolled_forward_list& other)
+      : unrolled_forward_list(other.begin(), other.end())
+    {
+    }
+
+    unrolled_forward_list(unrolled_forward_list&& other) noexcept { swap(other); }
+
+    unrolled_forward_list& operator=(const unrolled_forward_list& other)
+    {
+        unrolled_forward_list(other).swap(*this);
+        return *this;
+    }
+
+    unrolled_forward_list& operator=(unrolled_forward_list&& other) noexcept
+    {
+        unrolled_forward_list(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~unrolled_forward_list() { clear(); }
+
+    void swap(unrolled_forward_list& other) noexcept
+    {
+        std::swap(m_before_head.next, other.m_before_head.next);
+        std::swap(m_size, other.m_size);
+    }
+
+    friend void swap(unrolled_forward_list& lhs, unrolled_forward_list& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    size_type size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    /**
+     * @brief Returns an iterator that points before the first element, for use
+     * with insert_after, emplace_after and erase_after. It must not be
+     * dereferenced.
+     */
+    iterator before_begin() noexcept { return iterator(&m_before_head, 0); }
+    const_iterator before_begin() const noexcept
+    {
+        return const_iterator(const_cast<node_base*>(&m_before_head), 0);
+    }
+    const_iterator cbefore_begin() const noexcept { return before_begin(); }
+
+    iterator begin() noexcept { return iterator(m_before_head.next, 0); }
+    const_iterator begin() const noexcept { return const_iterator(m_before_head.next, 0); }
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    iterator end() noexcept { return iterator(nullptr, 0); }
+    const_iterator end() const noexcept { return const_iterator(nullptr, 0); }
+    const_iterator cend() const noexcept { return end(); }
+
+    reference front() noexcept
+    {
+        DEV_HARDENING_ASSERT(!empty(), "front() called on an empty unrolled_forward_list");
+        return *begin();
+    }
+
+    const_reference front() const noexcept
+    {
+        DEV_HARDENING_ASSERT(!empty(), "front() called on an empty unrolled_forward_list");
+        return *begin();
+    }
+
+    /**
+     * @brief Destroys all elements and frees all nodes.
+     */
+    void clear() noexcept
+    {
+        while (m_before_head.next) {
+            node* n = as_node(m_before_head.next);
+            std::destroy_n(n->data(), n->count);
+            n->count = 0;
+            destroy_node_after_aux(&m_before_head);
+        }
+        m_size = 0;
+    }
+
+    /**
+     * @brief Constructs an element after %position.
+     *
+     * A full node is split in two halves, except when the element goes at its
+     * end, in which case it starts a new node, so that appending fills every
+     * node. Likewise, inserting at the front of a full first node starts a new
+     * node.
+     *
+     * @return An iterator to the new element.
+     */
+    template<typename... Args>
+    iterator emplace_after(const_iterator position, Args&&... args)
+    {
+        node_base* prev = position.m_node;
+        size_type index = position.m_index + 1;
+        if (prev == &m_before_head) {
+            index = 0;
+            if (!prev->next || prev->next->count == K)
+                create_node_after_aux(prev);
+            prev = prev->next;
+        }
+
+        node* n = as_node(prev);
+        if (n->count == K) {
+            node* next = n->next && n->next->count < K ? as_node(n->next) : nullptr;
+            if (index == K && next) {
+                // Goes at the front of the next node
+                n = next;
+                index = 0;
+            } else {
+                node* split = create_node_after_aux(n);
+                if (index < K)
+                    relocate_tail_aux(n, K / 2, split);
+                if (index >= n->count) {
+                    index -= n->count;
+                    n = split;
+                }
+            }
+        }
+
+        try {
+            T* element = emplace_in_node_aux(n, index, std::forward<Args>(args)...);
+            ++m_size;
+            return iterator(n, static_cast<size_type>(element - n->data()));
+        } catch (...) {
+            // A node created for the element alone always follows %position
+            if (n->count == 0)
+                destroy_node_after_aux(position.m_node);
+            throw;
+        }
+    }
+
+    iterator insert_after(const_iterator position, const T& value)
+    {
+        return emplace_after(position, value);
+    }
+
+    iterator insert_after(const_iterator position, T&& value)
+    {
+        return emplace_after(position, std::move(value));
+    }
+
+    template<typename... Args>
+    reference emplace_front(Args&&... args)
+    {
+        return *emplace_after(before_begin(), std::forward<Args>(args)...);
+    }
+
+    void push_front(const T& value) { emplace_after(before_begin(), value); }
+    void push_front(T&& value) { emplace_after(before_begin(), std::move(value)); }
+
+    /**
+     * @brief Destroys the element after %position. A node that drops below
+     * half full absorbs the next node if their elements fit in one node, and a
+     * node left empty is freed.
+     *
+     * @return An iterator to the element that followed the erased one, or end().
+     */
+    iterator erase_after(const_iterator position) noexcept
+    {
+        DEV_HARDENING_ASSERT(position.m_node && std::next(position) != end(),
+                             "unrolled_forward_list::erase_after() has nothing to erase");
+        const_iterator target = std::next(position);
+        // The node before the target's one, if the target starts a node
+        node_base* prev = target.m_node == position.m_node ? nullptr : position.m_node;
+        node* n = as_node(target.m_node);
+        size_type index = target.m_index;
+
+        T* data = n->data();
+        std::move(data + index + 1, data + n->count, data + index);
+        std::destroy_at(data + n->count - 1);
+        --n->count;
+        --m_size;
+
+        if (n->count == 0) {
+            destroy_node_after_aux(prev);
+            return iterator(prev->next, 0);
+        }
+        if (n->count < K / 2 && n->next && n->count + n->next->count <= K) {
+            node* next = as_node(n->next);
+            relocate_tail_aux(next, 0, n);
+            destroy_node_after_aux(n);
+        }
+        if (index == n->count)
+            return iterator(n->next, 0);
+        return iterator(n, index);
+    }
+
+    void pop_front() noexcept
+    {
+        DEV_HARDENING_ASSERT(!empty(), "pop_front() called on an empty unrolled_forward_list");
+        erase_after(before_begin());
+    }
+
+    friend bool operator==(const unrolled_forward_list& lhs, const unrolled_forward_list& rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+};
+
+} // namespace dev
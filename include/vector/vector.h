@@ -1,11 +1,19 @@
+#pragma once
+
+#include "execution/policy.h"
+#include "hardening/hardening.h"
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstring>
 #include <format>
+#include <functional>
 #include <initializer_list>
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <ranges>
+#include <span>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
@@ -33,12 +41,12 @@ template<typename T>
 struct Iterator
 {
     using iterator_concept = std::contiguous_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
     using difference_type = std::ptrdiff_t;
-    using value_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using element_type = T;
     using reference = T&;
-    using const_reference = const T&;
     using pointer = T*;
-    using pointer_to_const = const T*;
     using size_type = std::size_t;
     friend vector<T>;
     friend Iterator<const T>;
@@ -112,7 +120,7 @@ struct Iterator
     {
         auto temp = *this;
         --m_ptr;
-        return (*this);
+        return temp;
     }
 
     /**
@@ -120,15 +128,15 @@ struct Iterator
      * @param n The offset to add.
      * @return A new Iterator pointing to the new position.
      */
-    auto operator+(difference_type n) const { return Iterator(m_ptr + n); }
-    friend auto operator+(difference_type n, Iterator j) { return (j + n); }
+    Iterator operator+(difference_type n) const { return Iterator(m_ptr + n); }
+    friend Iterator operator+(difference_type n, Iterator j) { return (j + n); }
 
     /**
      * @brief Adds an offset to the Iterator and assigns it.
      * @param n The offset to add.
      * @return Reference to the updated Iterator.
      */
-    Iterator& operator+=(size_type n)
+    Iterator& operator+=(difference_type n)
     {
         m_ptr += n;
         return *this;
@@ -139,15 +147,14 @@ struct Iterator
      * @param n The offset to subtract.
      * @return A new Iterator pointing to the new position.
      */
-    auto operator-(size_type n) const { return Iterator(m_ptr - n); }
-    friend auto operator-(difference_type n, Iterator j) { return (j - n); }
+    Iterator operator-(difference_type n) const { return Iterator(m_ptr - n); }
 
     /**
      * @brief Subtracts an offset from the Iterator and assigns it.
      * @param n The offset to subtract.
      * @return Reference to the updated Iterator.
      */
-    Iterator& operator-=(size_type n)
+    Iterator& operator-=(difference_type n)
     {
         m_ptr -= n;
         return *this;
@@ -158,21 +165,21 @@ struct Iterator
      * @param i The index to access.
      * @return Reference to the element at the index.
      */
-    reference operator[](size_type i) const { return m_ptr[i]; }
+    reference operator[](difference_type i) const { return m_ptr[i]; }
 
     /**
      * @brief Dereferences the Iterator.
      * @return Reference to the element pointed to by the Iterator.
+     * Constness of the Iterator itself does not propagate to the element, as
+     * with raw pointers (Iterator<const T> is the read-only iterator).
      */
-    reference operator*() { return *m_ptr; }
-    const_reference operator*() const { return *m_ptr; }
+    reference operator*() const { return *m_ptr; }
 
     /**
      * @brief Accesses the member of the element pointed to by the Iterator.
-     * @return Pointer to the element.
+     * @return Pointer to the element. This is also what %std::to_address uses.
      */
-    pointer operator->() { return m_ptr; }
-    pointer_to_const operator->() const { return m_ptr; }
+    pointer operator->() const { return m_ptr; }
 
     /**
      * @brief Computes the distance between two Iterators.
@@ -312,13 +319,11 @@ class vector
      */
     void copy_old_storage_to_new(pointer ptr_to_new_storage_block)
     {
-        iterator d_first = iterator(ptr_to_new_storage_block);
-
         if constexpr (std::is_nothrow_move_constructible_v<T>) {
-            std::uninitialized_move(begin(), end(), d_first);
+            relocate_aux(m_elements, m_elements + m_size, ptr_to_new_storage_block);
         } else {
             try {
-                std::uninitialized_copy(begin(), end(), d_first);
+                relocate_aux(m_elements, m_elements + m_size, ptr_to_new_storage_block);
             } catch (std::exception& ex) {
                 ::operator delete(ptr_to_new_storage_block);
                 throw ex; // rethrow
@@ -326,6 +331,167 @@ class vector
         }
     }
 
+    /**
+     * @brief Moves (or copies, if the move c'tor of T may throw) the elements
+     * %[first,last) into the raw memory at %d_first. Trivially copyable types
+     * are relocated with a single memcpy. The two ranges must not overlap.
+     */
+    static void relocate_aux(pointer first, pointer last, pointer d_first)
+    {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (first != last)
+                std::memcpy(d_first, first, (last - first) * sizeof(value_type));
+        } else if constexpr (std::is_nothrow_move_constructible_v<T>) {
+            std::uninitialized_move(first, last, d_first);
+        } else {
+            std::uninitialized_copy(first, last, d_first);
+        }
+    }
+
+    /**
+     * @brief True if %It refers to elements of type T laid out contiguously in
+     * memory (this vector's own iterators, raw pointers, std::vector iterators ...).
+     * Such sources can be copied with memcpy and checked for aliasing.
+     */
+    template<typename It>
+    static constexpr bool is_contiguous_iter_v =
+      std::contiguous_iterator<It> && std::is_same_v<std::iter_value_t<It>, T>;
+
+    /**
+     * @brief True if the range %[first,last) can be traversed more than once,
+     * so that its length can be computed before copying it.
+     */
+    template<typename It>
+    static constexpr bool is_multipass_iter_v = std::forward_iterator<It>;
+
+    /**
+     * @brief Returns the address of the element %it refers to.
+     */
+    template<typename It>
+        requires is_contiguous_iter_v<It>
+    static const_pointer to_address_aux(It it)
+    {
+        return std::to_address(it);
+    }
+
+    /**
+     * @brief Checks if %ptr points to one of the elements of this vector.
+     */
+    bool points_into_aux(const_pointer ptr) const
+    {
+        return std::less_equal<const_pointer>{}(m_elements, ptr) &&
+               std::less<const_pointer>{}(ptr, m_elements + m_size);
+    }
+
+    /**
+     * @brief Inserts copies of the %n elements starting at %first before the
+     * element at %index. The storage is grown at most once.
+     *
+     * %[first, first + n) may be a subrange of this vector. When a reallocation
+     * is needed, the new elements are copied into the new block before the old
+     * storage is released. Otherwise, trivially copyable types read the source back
+     * from where the gap-opening memmove left it, and all other types take a copy
+     * of the source first.
+     */
+    template<typename It>
+        requires is_multipass_iter_v<It>
+    iterator insert_aux(size_type index, It first, size_type n)
+    {
+        if (n == 0)
+            return begin() + index;
+
+        if (m_size + n > m_capacity) {
+            size_type new_capacity = std::max(m_size + n, 2 * m_capacity);
+            pointer p = allocate_aux(new_capacity);
+
+            try {
+                if constexpr (is_contiguous_iter_v<It> && std::is_trivially_copyable_v<T>)
+                    std::memcpy(p + index, to_address_aux(first), n * sizeof(value_type));
+                else
+                    std::uninitialized_copy_n(first, n, p + index);
+            } catch (...) {
+                ::operator delete(p);
+                throw;
+            }
+
+            size_type num_relocated{ 0 };
+            try {
+                relocate_aux(m_elements, m_elements + index, p);
+                num_relocated = index;
+                relocate_aux(m_elements + index, m_elements + m_size, p + index + n);
+            } catch (...) {
+                std::destroy(p, p + num_relocated);
+                std::destroy(p + index, p + index + n);
+                ::operator delete(p);
+                throw;
+            }
+
+            destroy_aux(begin(), end(), m_elements);
+            m_elements = p;
+            m_capacity = new_capacity;
+            m_size += n;
+            return begin() + index;
+        }
+
+        pointer pos = m_elements + index;
+        size_type num_elems_to_shift = m_size - index;
+
+        if constexpr (is_contiguous_iter_v<It> && std::is_trivially_copyable_v<T>) {
+            const_pointer src = to_address_aux(first);
+            bool aliased = points_into_aux(src);
+
+            std::memmove(pos + n, pos, num_elems_to_shift * sizeof(value_type));
+
+            if (!aliased) {
+                std::memcpy(pos, src, n * sizeof(value_type));
+            } else {
+                // The part of the source in front of %pos is still where it was,
+                // the rest of it has moved n slots to the right.
+                size_type head = src < pos ? std::min<size_type>(pos - src, n) : 0;
+                std::memmove(pos, src, head * sizeof(value_type));
+                std::memcpy(pos + head, src + head + n, (n - head) * sizeof(value_type));
+            }
+        } else {
+            if constexpr (is_contiguous_iter_v<It>) {
+                if (points_into_aux(to_address_aux(first))) {
+                    vector tmp;
+                    tmp.insert_aux(0, first, n);
+                    return insert_aux(index, tmp.cbegin(), n);
+                }
+            }
+
+            //             num_elems_to_shift
+            //               |<--------->|                             capacity
+            //   begin()     pos         end()                               |
+            //    ===========================================================
+            //   |42 |5  |17 |28 |63 |55 |   |   |   |   |   |   |   |   |   |
+            //    ===========================================================
+            //                           ^-----------------------------------^
+            //                                       Raw Storage
+            pointer last = m_elements + m_size;
+            if (n >= num_elems_to_shift) {
+                // a) The whole of [pos,end()) lands in raw storage. The head of the
+                // source overwrites it and the rest is constructed past end().
+                relocate_aux(pos, last, pos + n);
+                auto mid = std::next(first, num_elems_to_shift);
+                std::copy(first, mid, pos);
+                std::uninitialized_copy_n(mid, n - num_elems_to_shift, last);
+            } else {
+                // b) Only [end() - n, end()) lands in raw storage. The remainder
+                // of the shifted range stays in initialized storage.
+                relocate_aux(last - n, last, last);
+                if constexpr (std::is_nothrow_move_assignable_v<T>)
+                    std::move_backward(pos, last - n, last);
+                else
+                    std::copy_backward(pos, last - n, last);
+                std::copy_n(first, n, pos);
+            }
+        }
+
+        m_size += n;
+        return begin() + index;
+    }
+
     /**
      * @brief helper function to destroy the range [first,last) and
      * deallocate the memory block pointed to by ptr.
@@ -352,6 +518,56 @@ class vector
         }
     }
 
+    /**
+     * @brief Constructs the elements %[p + first, p + first + n) of a raw block in
+     * page-aligned chunks on the shared thread pool. %construct(i, j) must
+     * construct the elements %[p + i, p + j). If it throws, the chunks that were
+     * completed are destroyed and the exception is rethrown. %p is not freed.
+     */
+    template<typename F>
+    static void parallel_construct_aux(execution::parallel_policy policy,
+                                       pointer p,
+                                       size_type first,
+                                       size_type n,
+                                       F construct)
+    {
+        // Found by argument-dependent lookup once "execution/execution.h" is
+        // included, which sequential users of vector never need
+        for_each_page_chunk(
+          policy,
+          p + first,
+          n,
+          [&](size_type i, size_type j) { construct(first + i, first + j); },
+          [&](size_type i, size_type j) { std::destroy(p + first + i, p + first + j); });
+    }
+
+    /**
+     * @brief Replaces the contents with %n elements built in a new block by
+     * %construct(p, i, j), which constructs the elements %[p + i, p + j).
+     * The old elements are destroyed only once the new ones are complete, so
+     * %construct may read from this vector.
+     */
+    template<typename Policy, typename F>
+    void rebuild_aux(Policy policy, size_type n, F construct)
+    {
+        pointer p = allocate_aux(n);
+        try {
+            if constexpr (std::is_same_v<Policy, execution::parallel_policy>) {
+                parallel_construct_aux(
+                  policy, p, 0, n, [&](size_type i, size_type j) { construct(p, i, j); });
+            } else {
+                construct(p, 0, n);
+            }
+        } catch (...) {
+            ::operator delete(p);
+            throw;
+        }
+        destroy_aux(begin(), end(), m_elements);
+        m_elements = p;
+        m_size = n;
+        m_capacity = n;
+    }
+
   public:
     // Capacity related member functions
     /**
@@ -401,6 +617,22 @@ class vector
         copy_rng_aux(other.begin(), other.end());
     }
 
+    /**
+     * @brief Parallel copy constructor. The elements are copied in page-aligned
+     * chunks on the shared thread pool, so the pages of the new vector are
+     * first touched by the threads that fill them.
+     * @param policy %dev::execution::par, optionally with a thread limit.
+     * @param other A vector of identical element type %T
+     */
+    vector(execution::parallel_policy policy, const vector& other)
+      : vector()
+    {
+        const_pointer src = other.m_elements;
+        rebuild_aux(policy, other.m_size, [src](pointer p, size_type i, size_type j) {
+            std::uninitialized_copy(src + i, src + j, p + i);
+        });
+    }
+
     /**
      * @brief swaps data with another vector.
      * The global %std::swap function is specialized
@@ -476,6 +708,26 @@ class vector
     vector& assign(InputIt first, InputIt last)
     {
         size_t n = std::distance(first, last);
+        if constexpr (is_contiguous_iter_v<InputIt> && std::is_trivially_copyable_v<T>) {
+            if (n == 0) {
+                m_size = 0;
+                return *this;
+            }
+            // memmove, since [first,last) may be a subrange of this vector
+            const_pointer src = to_address_aux(first);
+            if (n > capacity()) {
+                pointer p = allocate_aux(n);
+                std::memcpy(p, src, n * sizeof(value_type));
+                ::operator delete(m_elements);
+                m_elements = p;
+                m_capacity = n;
+            } else {
+                std::memmove(m_elements, src, n * sizeof(value_type));
+            }
+            m_size = n;
+            return *this;
+        }
+
         if (n > capacity()) {
             // Triggers Reallocation
             pointer p = allocate_aux(n);
@@ -494,6 +746,36 @@ class vector
         return *this;
     }
 
+    /**
+     * @brief Assigns a random-access range to a vector, copying it in parallel
+     * into a newly allocated block.
+     * @note All iterators including the end() iterator and any references
+     * to vector elements are invalidate.
+     */
+    template<std::random_access_iterator It>
+        requires std::is_convertible_v<std::iter_reference_t<It>, T>
+    vector& assign(execution::parallel_policy policy, It first, It last)
+    {
+        using diff_t = std::iter_difference_t<It>;
+        rebuild_aux(policy, last - first, [first](pointer p, size_type i, size_type j) {
+            std::uninitialized_copy(
+              first + static_cast<diff_t>(i), first + static_cast<diff_t>(j), p + i);
+        });
+        return *this;
+    }
+
+    /**
+     * @brief Replaces the contents with %n copies of %value, filled in parallel
+     * into a newly allocated block.
+     */
+    vector& assign(execution::parallel_policy policy, size_type n, const_reference value)
+    {
+        rebuild_aux(policy, n, [&value](pointer p, size_type i, size_type j) {
+            std::uninitialized_fill(p + i, p + j, value);
+        });
+        return *this;
+    }
+
     /**
      * @brief Destructor
      */
@@ -503,6 +785,13 @@ class vector
         ::operator delete(m_elements);
     }
 
+    /**
+     * @brief Returns a pointer to the underlying contiguous storage.
+     * [data(), data() + size()) is always a valid range, even when empty.
+     */
+    pointer data() noexcept { return m_elements; }
+    const_pointer data() const noexcept { return m_elements; }
+
     /**
      * @brief Returns a read/write iterator that points to the first element
      * of the vector.
@@ -556,26 +845,53 @@ class vector
     /**
      * @brief Array subscript operator.
      * Returns a read/write reference to the element at index %n.
+     * @note Unchecked, unless built with DEV_HARDENED.
      */
-    reference operator[](size_type n) { return m_elements[n]; }
+    reference operator[](size_type n)
+    {
+        DEV_HARDENING_ASSERT(n < m_size, "vector index out of bounds");
+        return m_elements[n];
+    }
 
     /**
      * @brief Array subscript operator.
      * Returns a read-only reference to the element at index %n.
      */
-    const_reference operator[](size_type n) const { return m_elements[n]; }
+    const_reference operator[](size_type n) const
+    {
+        DEV_HARDENING_ASSERT(n < m_size, "vector index out of bounds");
+        return m_elements[n];
+    }
 
     /**
      * @brief Accesses the first element of the container
      */
-    reference front() { return m_elements[0]; }
-    const_reference front() const { return m_elements[0]; }
+    reference front()
+    {
+        DEV_HARDENING_ASSERT(m_size != 0, "front() called on an empty vector");
+        return m_elements[0];
+    }
+
+    const_reference front() const
+    {
+        DEV_HARDENING_ASSERT(m_size != 0, "front() called on an empty vector");
+        return m_elements[0];
+    }
 
     /**
      * @brief Accesses the last element of the container
      */
-    reference back() { return m_elements[m_size - 1]; }
-    const_reference back() const { return m_elements[m_size - 1]; }
+    reference back()
+    {
+        DEV_HARDENING_ASSERT(m_size != 0, "back() called on an empty vector");
+        return m_elements[m_size - 1];
+    }
+
+    const_reference back() const
+    {
+        DEV_HARDENING_ASSERT(m_size != 0, "back() called on an empty vector");
+        return m_elements[m_size - 1];
+    }
 
     // Modifiers
     /**
@@ -617,6 +933,7 @@ class vector
      */
     void pop_back()
     {
+        DEV_HARDENING_ASSERT(m_size != 0, "pop_back() called on an empty vector");
         std::destroy_at(std::prev(end()).get());
         --m_size;
     }
@@ -660,14 +977,204 @@ class vector
         if (new_size > capacity())
             reserve(new_size);
 
-        // Default construct elements at indices
-        // [current_size,...,new_size-1]
-        for (auto p{ begin() + current_size }; p != begin() + new_size; ++p)
-            std::construct_at(p.get(), value_type{});
+        // Value-initialize elements at indices
+        // [current_size,...,new_size-1]. For arithmetic, enum and object
+        // pointer types the value is all-zero bits, so a single memset does
+        // the job. Not for pointers to members, whose null value is -1 on
+        // the Itanium ABI, nor for the classes that may hold them.
+        if constexpr (std::is_scalar_v<T> && !std::is_member_pointer_v<T>) {
+            std::memset(m_elements + current_size,
+                        0,
+                        (new_size - current_size) * sizeof(value_type));
+        } else {
+            std::uninitialized_value_construct(m_elements + current_size,
+                                               m_elements + new_size);
+        }
+
+        m_size = new_size;
+    }
+
+    /**
+     * @brief Resize the container to contain %new_size elements. If
+     * %new_size > size(), copies of %value are appended.
+     */
+    void resize(size_type new_size, const_reference value)
+    {
+        size_t current_size = size();
+        if (new_size <= current_size) {
+            resize(new_size);
+            return;
+        }
+
+        if (new_size > capacity()) {
+            // %value may be an element of this vector
+            value_type copy(value);
+            reserve(new_size);
+            std::uninitialized_fill(
+              m_elements + current_size, m_elements + new_size, copy);
+        } else {
+            std::uninitialized_fill(
+              m_elements + current_size, m_elements + new_size, value);
+        }
+        m_size = new_size;
+    }
+
+    /**
+     * @brief Parallel version of resize(%new_size, %value). The appended copies
+     * are filled in page-aligned chunks on the shared thread pool. When the
+     * vector has to grow, the existing elements are relocated into the new
+     * block in parallel as well.
+     */
+    void resize(execution::parallel_policy policy,
+                size_type new_size,
+                const_reference value)
+    {
+        size_t current_size = size();
+        if (new_size <= current_size) {
+            resize(new_size);
+            return;
+        }
+
+        auto fill = [&value](pointer p) {
+            return [p, &value](size_type i, size_type j) {
+                std::uninitialized_fill(p + i, p + j, value);
+            };
+        };
+
+        if (new_size <= capacity()) {
+            parallel_construct_aux(policy,
+                                   m_elements,
+                                   current_size,
+                                   new_size - current_size,
+                                   fill(m_elements));
+            m_size = new_size;
+            return;
+        }
+
+        pointer p = allocate_aux(new_size);
+        try {
+            // Fill first: %value may be an element that is about to be moved from
+            parallel_construct_aux(
+              policy, p, current_size, new_size - current_size, fill(p));
+            try {
+                pointer old = m_elements;
+                parallel_construct_aux(
+                  policy, p, 0, current_size, [old, p](size_type i, size_type j) {
+                      relocate_aux(old + i, old + j, p + i);
+                  });
+            } catch (...) {
+                std::destroy(p + current_size, p + new_size);
+                throw;
+            }
+        } catch (...) {
+            ::operator delete(p);
+            throw;
+        }
+        destroy_aux(begin(), end(), m_elements);
+        m_elements = p;
+        m_size = new_size;
+        m_capacity = new_size;
+    }
+
+    /**
+     * @brief Resize the container to contain %new_size elements, without
+     * value-initializing the appended elements.
+     * The additional elements are default-initialized: for trivial types such as
+     * %int or %double their values are indeterminate and must be written before
+     * they are read. Use this when the caller overwrites the whole buffer
+     * straight away, to save a pass over memory.
+     */
+    void resize_for_overwrite(size_type new_size)
+    {
+        size_t current_size = size();
+        if (new_size <= current_size) {
+            resize(new_size);
+            return;
+        }
+
+        if (new_size > capacity())
+            reserve(new_size);
 
+        std::uninitialized_default_construct(m_elements + current_size,
+                                             m_elements + new_size);
         m_size = new_size;
     }
 
+    /**
+     * @brief Appends %n default-initialized elements to the end of the vector
+     * and returns a writable view of them.
+     * Capacity grows geometrically, so repeated calls are amortized O(n).
+     * @note The returned span is invalidated by the next operation that
+     * reallocates the vector.
+     */
+    std::span<value_type> append_uninitialized(size_type n)
+    {
+        size_t current_size = size();
+        if (current_size + n > capacity())
+            reserve(std::max(current_size + n, 2 * capacity()));
+
+        std::uninitialized_default_construct(m_elements + current_size,
+                                             m_elements + current_size + n);
+        m_size = current_size + n;
+        return std::span<value_type>(m_elements + current_size, n);
+    }
+
+    /**
+     * @brief Replaces the contents with %f(x) for every element x of %rg. The
+     * results are constructed in place in a new block, with no
+     * default-constructed intermediate. %rg may be this vector.
+     */
+    template<std::ranges::forward_range R, typename F>
+        requires std::ranges::sized_range<R> &&
+                 std::is_convertible_v<
+                   std::invoke_result_t<F&, std::ranges::range_reference_t<R>>, T>
+    vector& transform_into(R&& rg, F f)
+    {
+        auto src = std::ranges::begin(rg);
+        rebuild_aux(execution::sequenced_policy{},
+                    std::ranges::size(rg),
+                    [&src, &f](pointer p, size_type i, size_type j) {
+                        size_type k = i;
+                        try {
+                            for (; k < j; ++k, ++src)
+                                std::construct_at(p + k, std::invoke(f, *src));
+                        } catch (...) {
+                            std::destroy(p + i, p + k);
+                            throw;
+                        }
+                    });
+        return *this;
+    }
+
+    /**
+     * @brief Parallel version of transform_into(). The results are constructed in
+     * page-aligned chunks on the shared thread pool.
+     * @note %f is called concurrently from several threads.
+     */
+    template<std::ranges::random_access_range R, typename F>
+        requires std::ranges::sized_range<R> &&
+                 std::is_convertible_v<
+                   std::invoke_result_t<F&, std::ranges::range_reference_t<R>>, T>
+    vector& transform_into(execution::parallel_policy policy, R&& rg, F f)
+    {
+        using diff_t = std::ranges::range_difference_t<R>;
+        auto src = std::ranges::begin(rg);
+        rebuild_aux(policy,
+                    std::ranges::size(rg),
+                    [src, &f](pointer p, size_type i, size_type j) {
+                        size_type k = i;
+                        try {
+                            for (; k < j; ++k)
+                                std::construct_at(
+                                  p + k, std::invoke(f, src[static_cast<diff_t>(k)]));
+                        } catch (...) {
+                            std::destroy(p + i, p + k);
+                            throw;
+                        }
+                    });
+        return *this;
+    }
+
     /**
      * @brief Inserts given %value into vector before specified %position,
      * possibly using move-semantics.
@@ -704,7 +1211,7 @@ class vector
 
             try {
                 for (; p1 != begin() + index; ++p1, ++i) {
-                    construct_at_addr(ptr_new_blk + i, std::forward<U>(*p1));
+                    construct_at_addr(ptr_new_blk + i, std::move_if_noexcept(*p1));
                 }
             } catch (std::exception& ex) {
                 auto q{ iterator(ptr_new_blk) };
@@ -721,7 +1228,7 @@ class vector
 
             try {
                 for (; p2 != end(); ++p2, ++j) {
-                    construct_at_addr(ptr_new_blk + j, std::forward<U>(*p2));
+                    construct_at_addr(ptr_new_blk + j, std::move_if_noexcept(*p2));
                 }
             } catch (std::exception& ex) {
                 auto q{ ptr_new_blk };
@@ -735,14 +1242,16 @@ class vector
             m_elements = ptr_new_blk;
             m_capacity = new_capacity;
             pos_ = begin() + index;
+        } else if (pos_ == end()) {
+            construct_at_addr(end().get(), std::forward<U>(value));
         } else {
             if constexpr (std::is_nothrow_move_constructible_v<T>) {
                 std::uninitialized_move(end() - 1, end(), end());
-                std::move_backward(pos_, end(), end());
+                std::move_backward(pos_, end() - 1, end());
                 *pos_ = std::forward<U>(value);
             } else {
                 std::uninitialized_copy(end() - 1, end(), end());
-                std::copy_backward(pos_, end(), end());
+                std::copy_backward(pos_, end() - 1, end());
                 *pos_ = value;
             }
         }
@@ -764,6 +1273,7 @@ class vector
      * @param last The end of the range to insert.
      * @return An iterator pointing to the first of the newly inserted elements.
      *
+     * @note `[first, last)` may be a subrange of this vector.
      * @note If reallocation occurs, all iterators, references, and pointers to
      * elements in the vector are invalidated.
      *
@@ -773,74 +1283,56 @@ class vector
     template<class InputIt>
     iterator insert(const_iterator position, InputIt first, InputIt last)
     {
-        auto index = std::distance(begin(), iterator(position));
-
-        // Algorithm.
-        // ----------
-        // 1. Determine if the elements in the range [first,last) can
-        //    fit into the remaining_capacity = capacity() - size().
-        //    If not, a reallocation is triggered.
+        size_type index = position - cbegin();
 
-        // Possible reallocation
-        if (std::distance(first, last) > capacity() - size()) {
-            size_t new_capacity = size() + std::distance(first, last);
-            reserve(new_capacity);
-        }
-
-        iterator pos_ = begin() + index;
-
-        //             num_elems_to_shift
-        // 2.            |<--------->|                             capacity
-        //   begin()     position    end()                               |
-        //    ===========================================================
-        //   |42 |5  |17 |28 |63 |55 |   |   |   |   |   |   |   |   |   |
-        //    ===========================================================
-        //                           ^-----------------------------------^
-        //                                       Raw Storage
-
-        size_t src_len = std::distance(first, last);
-        size_t num_elems_to_shift = std::distance(pos_, end());
-        iterator d_first = pos_ + src_len;
-        iterator d_last = end() + src_len;
-
-        if (src_len >= num_elems_to_shift) {
-            // a) If 3 or more elements have to be inserted at pos_,
-            //  then the range [position,end) has to be copied
-            //  to raw storage.
-            std::uninitialized_copy(pos_, end(), d_first);
+        if constexpr (is_multipass_iter_v<InputIt>) {
+            return insert_aux(index, first, std::distance(first, last));
         } else {
-            // b) If less than 3 elements have to be inserted at pos_,
-            // then
-            //   => a subsequence [end() - src_len, end()) has to be
-            //   copied
-            //      to raw storage.
-            //   => the subsequence [pos_,end() - src_len) has to be
-            //   copied
-            //      to initialized storage.
-            std::uninitialized_copy(end() - src_len, end(), d_last - src_len);
-            std::copy_backward(pos_, end() - src_len, end());
+            // The length of a single-pass range is only known once it has been
+            // consumed, so buffer it first.
+            vector tmp;
+            for (; first != last; ++first)
+                tmp.emplace_back(*first);
+            return insert_aux(index, tmp.cbegin(), tmp.size());
         }
+    }
 
-        // 3. Copy elements from src to dest range.
-        if (src_len <= num_elems_to_shift) {
-            // a) Copy the elements from the source range to
-            // [pos_,pos+src_len)
-            std::copy(first, last, pos_);
-
+    /**
+     * @brief Inserts copies of the elements of the range %rg before %position.
+     * (C++23 %insert_range)
+     *
+     * The storage is grown at most once. For trivially copyable T the existing
+     * elements are shifted with memmove, and contiguous sources are copied with
+     * memcpy. %rg may be a subrange of this vector.
+     * @return An iterator pointing to the first of the newly inserted elements.
+     */
+    template<std::ranges::range R>
+        requires std::is_convertible_v<std::ranges::range_reference_t<R>, T>
+    iterator insert_range(const_iterator position, R&& rg)
+    {
+        if constexpr (std::ranges::sized_range<R> &&
+                      is_multipass_iter_v<std::ranges::iterator_t<R>>) {
+            return insert_aux(position - cbegin(),
+                              std::ranges::begin(rg),
+                              static_cast<size_type>(std::ranges::size(rg)));
         } else {
-            // b) (i) Copy the elements from
-            //     the subsequence [first,first + num_elems_to_shift)
-            //     to [pos_,end())
-            std::copy(first, first + num_elems_to_shift, pos_);
-
-            // (ii) Copy the elements from
-            // [first+num_elems_to_shift,last)
-            //      to uninitialized storage [end(),pos_ + src_len)
-            std::uninitialized_copy(first + num_elems_to_shift, last, end());
+            return insert(position,
+                          std::ranges::begin(rg),
+                          std::ranges::next(std::ranges::begin(rg), std::ranges::end(rg)));
         }
+    }
 
-        m_size += src_len;
-        return pos_;
+    /**
+     * @brief Appends copies of the elements of the range %rg to the end of the
+     * vector. (C++23 %append_range)
+     * Reserves once and, for trivially copyable T and contiguous %rg,
+     * copies with a single memcpy.
+     */
+    template<std::ranges::range R>
+        requires std::is_convertible_v<std::ranges::range_reference_t<R>, T>
+    void append_range(R&& rg)
+    {
+        insert_range(cend(), std::forward<R>(rg));
     }
 
     /**
@@ -852,15 +1344,11 @@ class vector
         return insert(position, ilist.begin(), ilist.end());
     }
 
-    // TODO: Add an implementation of insert(const_iterator position, InputIt first,
-    // InputIt last) which handles the special case where [first,last) are a subrange in
-    // %this vector.
-
     template<typename It>
         requires(std::is_same_v<It, iterator> || std::is_same_v<It, const_iterator>)
     iterator erase(It position)
     {
-        auto pos_ = iterator(position.get());
+        auto pos_ = iterator(position);
         if (pos_ == end())
             return pos_;
 
@@ -870,6 +1358,34 @@ class vector
         return pos_;
     }
 
+    /**
+     * @brief Removes the elements in the range %[first, last). The elements after
+     * the range are moved down to close the gap.
+     * @return An iterator pointing to the element that followed the last
+     * removed element.
+     */
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        auto first_ = iterator(first);
+        auto last_ = iterator(last);
+        if (first_ == last_)
+            return first_;
+
+        auto new_end = std::move(last_, end(), first_);
+        std::destroy(new_end, end());
+        m_size = new_end - begin();
+        return first_;
+    }
+
+    /**
+     * @brief Removes all elements. The capacity is left unchanged.
+     */
+    void clear() noexcept
+    {
+        std::destroy(begin(), end());
+        m_size = 0;
+    }
+
     void reserve(size_type new_capacity)
     {
         if (new_capacity <= capacity())
@@ -886,7 +1402,9 @@ class vector
     }
 };
 
-// static_assert(std::contiguous_iterator<Iterator<int>>);
-// static_assert(std::contiguous_iterator<Iterator<const int>>);
+static_assert(std::contiguous_iterator<Iterator<int>>);
+static_assert(std::contiguous_iterator<Iterator<const int>>);
+static_assert(std::ranges::contiguous_range<vector<int>>);
+static_assert(std::ranges::contiguous_range<const vector<int>>);
 
 } // namespace dev
\ No newline at end of file
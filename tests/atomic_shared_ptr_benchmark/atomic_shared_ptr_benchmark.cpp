@@ -0,0 +1,111 @@
+#include "atomic_shared_ptr.h"
+#include <array>
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// One writer republishes a snapshot of reference data while the other threads
+// read it, across thread counts: thread 0 stores a new snapshot every
+// iteration, and every other thread takes the current one and reads a field.
+// dev::atomic_shared_ptr is compared with a dev::shared_ptr behind a
+// std::mutex, and with std::atomic<std::shared_ptr>, which libstdc++
+// implements with a spin lock in the low bit of the pointer.
+//
+// The reads_per_second and writes_per_second counters split the work done by
+// both roles.
+
+/**
+ * @brief Reference data, large enough that copying it would be noticed.
+ */
+struct snapshot
+{
+    std::uint64_t version;
+    std::array<std::uint64_t, 15> data{};
+};
+
+/**
+ * @brief The locked baseline.
+ */
+class locked_snapshot
+{
+  private:
+    dev::shared_ptr<snapshot> m_ptr{ dev::make_shared<snapshot>() };
+    mutable std::mutex m_mutex;
+
+  public:
+    dev::shared_ptr<snapshot> load() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_ptr;
+    }
+
+    void store(dev::shared_ptr<snapshot> desired)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_ptr.swap(desired);
+        }
+        // The old snapshot is released outside of the lock
+    }
+
+    static dev::shared_ptr<snapshot> make(std::uint64_t version) { return dev::make_shared<snapshot>(version); }
+};
+
+class lock_free_snapshot
+{
+  private:
+    dev::atomic_shared_ptr<snapshot> m_ptr{ dev::make_shared<snapshot>() };
+
+  public:
+    dev::shared_ptr<snapshot> load() const { return m_ptr.load(); }
+    void store(dev::shared_ptr<snapshot> desired) { m_ptr.store(std::move(desired)); }
+    static dev::shared_ptr<snapshot> make(std::uint64_t version) { return dev::make_shared<snapshot>(version); }
+};
+
+class std_snapshot
+{
+  private:
+    std::atomic<std::shared_ptr<snapshot>> m_ptr{ std::make_shared<snapshot>() };
+
+  public:
+    std::shared_ptr<snapshot> load() const { return m_ptr.load(); }
+    void store(std::shared_ptr<snapshot> desired) { m_ptr.store(std::move(desired)); }
+    static std::shared_ptr<snapshot> make(std::uint64_t version) { return std::make_shared<snapshot>(version); }
+};
+
+template<typename Snapshot>
+static void bench_publish(benchmark::State& state)
+{
+    // The timed loops of all threads start and end together, after the
+    // setup and before the teardown of thread 0
+    static Snapshot* shared = nullptr;
+    if (state.thread_index() == 0)
+        shared = new Snapshot;
+    std::uint64_t reads = 0;
+    std::uint64_t writes = 0;
+    std::uint64_t version = 0;
+    for (auto _ : state) {
+        if (state.thread_index() == 0) {
+            shared->store(Snapshot::make(++version));
+            ++writes;
+        } else {
+            auto s = shared->load();
+            benchmark::DoNotOptimize(s->version);
+            ++reads;
+        }
+    }
+    if (state.thread_index() == 0)
+        delete shared;
+    state.counters["reads_per_second"] =
+      benchmark::Counter(static_cast<double>(reads), benchmark::Counter::kIsRate);
+    state.counters["writes_per_second"] =
+      benchmark::Counter(static_cast<double>(writes), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(bench_publish<locked_snapshot>)->ThreadRange(2, 32)->UseRealTime();
+BENCHMARK(bench_publish<lock_free_snapshot>)->ThreadRange(2, 32)->UseRealTime();
+BENCHMARK(bench_publish<std_snapshot>)->ThreadRange(2, 32)->UseRealTime();
+
+BENCHMARK_MAIN();
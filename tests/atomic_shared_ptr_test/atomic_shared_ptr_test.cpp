@@ -0,0 +1,154 @@
+#include "atomic_shared_ptr.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Counts its destructions, so that tests can tell when a snapshot is
+ * released.
+ */
+struct snapshot
+{
+    std::atomic<int>* destroyed;
+    long long version;
+    long long twice;
+
+    snapshot(std::atomic<int>* destroyed, long long version)
+      : destroyed{ destroyed }
+      , version{ version }
+      , twice{ 2 * version }
+    {
+    }
+
+    ~snapshot() { ++*destroyed; }
+};
+
+TEST(AtomicSharedPtrTest, DefaultConstructorTest)
+{
+    dev::atomic_shared_ptr<int> ptr;
+    EXPECT_EQ(ptr.load(), nullptr);
+    EXPECT_TRUE(ptr.is_lock_free());
+    static_assert(dev::atomic_shared_ptr<int>::is_always_lock_free);
+}
+
+TEST(AtomicSharedPtrTest, LoadAndStoreTest)
+{
+    std::atomic<int> destroyed{ 0 };
+    {
+        dev::atomic_shared_ptr<snapshot> ptr(dev::make_shared<snapshot>(&destroyed, 1));
+        dev::shared_ptr<snapshot> first = ptr.load();
+        EXPECT_EQ(first->version, 1);
+        EXPECT_EQ(first.use_count(), 2);
+
+        // The replaced snapshot lives on in its readers only
+        ptr.store(dev::make_shared<snapshot>(&destroyed, 2));
+        EXPECT_EQ(first.use_count(), 1);
+        EXPECT_EQ(ptr.load()->version, 2);
+        first.reset();
+        EXPECT_EQ(destroyed.load(), 1);
+
+        ptr = dev::shared_ptr<snapshot>(new snapshot(&destroyed, 3));
+        EXPECT_EQ(destroyed.load(), 2);
+        dev::shared_ptr<snapshot> third = ptr;
+        EXPECT_EQ(third->version, 3);
+
+        ptr.store(nullptr);
+        EXPECT_EQ(ptr.load(), nullptr);
+        EXPECT_EQ(third.use_count(), 1);
+    }
+    EXPECT_EQ(destroyed.load(), 3);
+}
+
+TEST(AtomicSharedPtrTest, ExchangeTest)
+{
+    std::atomic<int> destroyed{ 0 };
+    dev::atomic_shared_ptr<snapshot> ptr(dev::make_shared<snapshot>(&destroyed, 1));
+    dev::shared_ptr<snapshot> old = ptr.exchange(dev::make_shared<snapshot>(&destroyed, 2));
+    EXPECT_EQ(old->version, 1);
+    EXPECT_EQ(old.use_count(), 1);
+    EXPECT_EQ(ptr.load()->version, 2);
+    old.reset();
+    EXPECT_EQ(destroyed.load(), 1);
+}
+
+TEST(AtomicSharedPtrTest, CompareExchangeTest)
+{
+    std::atomic<int> destroyed{ 0 };
+    dev::atomic_shared_ptr<snapshot> ptr(dev::make_shared<snapshot>(&destroyed, 1));
+    dev::shared_ptr<snapshot> expected = ptr.load();
+
+    // Another owner of an equal value is not the same object
+    dev::shared_ptr<snapshot> impostor = dev::make_shared<snapshot>(&destroyed, 1);
+    EXPECT_FALSE(ptr.compare_exchange_strong(impostor, dev::make_shared<snapshot>(&destroyed, 9)));
+    EXPECT_EQ(impostor, expected);
+    EXPECT_EQ(destroyed.load(), 2);
+
+    EXPECT_TRUE(ptr.compare_exchange_strong(expected, dev::make_shared<snapshot>(&destroyed, 2)));
+    EXPECT_EQ(ptr.load()->version, 2);
+    EXPECT_EQ(expected->version, 1);
+    EXPECT_EQ(expected.use_count(), 2);
+
+    dev::shared_ptr<snapshot> empty;
+    EXPECT_FALSE(ptr.compare_exchange_weak(empty, nullptr));
+    EXPECT_EQ(empty->version, 2);
+}
+
+TEST(AtomicSharedPtrTest, ConcurrentReadersAndWriterTest)
+{
+    // Readers must always see a whole snapshot, and every snapshot must be
+    // destroyed exactly once, by its last reader or by the writer.
+    std::atomic<int> destroyed{ 0 };
+    constexpr int num_readers = 4;
+    constexpr long long num_versions = 2000;
+    {
+        dev::atomic_shared_ptr<snapshot> ptr(dev::make_shared<snapshot>(&destroyed, 0));
+        std::atomic<bool> done{ false };
+        std::vector<std::thread> readers;
+        for (int t = 0; t < num_readers; ++t) {
+            readers.emplace_back([&ptr, &done] {
+                long long last = 0;
+                while (!done.load()) {
+                    dev::shared_ptr<snapshot> s = ptr.load();
+                    ASSERT_EQ(s->twice, 2 * s->version);
+                    // A single writer publishes versions in order
+                    ASSERT_GE(s->version, last);
+                    last = s->version;
+                }
+            });
+        }
+        for (long long version = 1; version <= num_versions; ++version)
+            ptr.store(dev::make_shared<snapshot>(&destroyed, version));
+        done.store(true);
+        for (auto& reader : readers)
+            reader.join();
+        EXPECT_EQ(destroyed.load(), num_versions);
+    }
+    EXPECT_EQ(destroyed.load(), num_versions + 1);
+}
+
+TEST(AtomicSharedPtrTest, ConcurrentCompareExchangeTest)
+{
+    // Threads increment a counter held in an immutable object, by replacing
+    // it with a copy plus one; no increment may be lost.
+    std::atomic<int> destroyed{ 0 };
+    constexpr int num_threads = 4;
+    constexpr int increments = 1000;
+    {
+        dev::atomic_shared_ptr<snapshot> ptr(dev::make_shared<snapshot>(&destroyed, 0));
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&ptr, &destroyed] {
+                for (int i = 0; i < increments; ++i) {
+                    dev::shared_ptr<snapshot> expected = ptr.load();
+                    while (!ptr.compare_exchange_weak(
+                      expected, dev::make_shared<snapshot>(&destroyed, expected->version + 1))) {
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        EXPECT_EQ(ptr.load()->version, num_threads * increments);
+    }
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Replaces every form of the global operator new and operator delete, plain,
+// array, nothrow and aligned, with malloc and free behind a counter of the
+// allocations, so that tests and benchmarks can check how many times a
+// container reaches the heap. Replacement functions can not be inline: include
+// this header from a single translation unit of each executable.
+
+// GCC pairs the std::free below with the operator new at the call site of
+// every delete, and reports a mismatch it can not see through.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace allocation_counter {
+
+inline std::atomic<std::uint64_t> g_allocations{ 0 };
+
+inline void* allocate(std::size_t size) noexcept
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+inline void* allocate(std::size_t size, std::align_val_t alignment) noexcept
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    const auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc wants a size that is a multiple of the alignment
+    return std::aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+inline void* allocate_or_throw(std::size_t size)
+{
+    if (void* p = allocate(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+inline void* allocate_or_throw(std::size_t size, std::align_val_t alignment)
+{
+    if (void* p = allocate(size, alignment))
+        return p;
+    throw std::bad_alloc();
+}
+
+} // namespace allocation_counter
+
+/**
+ * @brief Returns the number of allocations made so far.
+ */
+inline std::uint64_t allocation_count()
+{
+    return allocation_counter::g_allocations.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the number of allocations made by %f.
+ */
+template<typename F>
+std::uint64_t count_allocations(F f)
+{
+    const std::uint64_t before = allocation_count();
+    f();
+    return allocation_count() - before;
+}
+
+void* operator new(std::size_t size)
+{
+    return allocation_counter::allocate_or_throw(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return allocation_counter::allocate_or_throw(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocation_counter::allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocation_counter::allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocation_counter::allocate_or_throw(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return allocation_counter::allocate_or_throw(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocation_counter::allocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocation_counter::allocate(size, alignment);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <benchmark/benchmark.h>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The benchmarks shared by the containers that trade some indexing speed for
+// a flatter push_back latency than dev::vector, so that their reports can be
+// compared with each other directly.
+
+struct Quote
+{
+    double bid;
+    double ask;
+    std::int64_t bid_qty;
+    std::int64_t ask_qty;
+    std::int64_t ts;
+};
+
+/**
+ * @brief Times every push_back of %n quotes into an empty container, and
+ * reports the last run as counters: its percentiles in nanoseconds, and a log2
+ * histogram where "<2^k ns" counts the push_backs that took less than 2^k ns
+ * and at least 2^(k-1) ns. Meant to run a fixed number of times: the runs
+ * before the last one warm up the allocator, as the process that fills a book
+ * is rarely the first to touch its memory.
+ */
+template<typename Container>
+static void bench_push_back_latency(benchmark::State& state)
+{
+    using clock = std::chrono::steady_clock;
+    const auto n = static_cast<std::size_t>(state.range(0));
+
+    std::vector<std::int64_t> latencies;
+    latencies.reserve(n);
+
+    for (auto _ : state) {
+        latencies.clear();
+        Container quotes;
+        for (std::size_t i = 0; i < n; ++i) {
+            Quote q{ 100.0, 100.5, 10, 20, static_cast<std::int64_t>(i) };
+            auto start = clock::now();
+            quotes.push_back(q);
+            auto stop = clock::now();
+            latencies.push_back(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+        }
+        benchmark::DoNotOptimize(&quotes.back());
+    }
+
+    std::ranges::sort(latencies);
+    auto percentile = [&latencies](double p) {
+        auto i = static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1));
+        return static_cast<double>(latencies[i]);
+    };
+    state.counters["p50"] = percentile(0.50);
+    state.counters["p99"] = percentile(0.99);
+    state.counters["p99.99"] = percentile(0.9999);
+    state.counters["max"] = static_cast<double>(latencies.back());
+
+    std::array<std::int64_t, 32> histogram{};
+    for (std::int64_t ns : latencies) {
+        auto k = std::bit_width(static_cast<std::uint64_t>(ns));
+        ++histogram[std::min<std::size_t>(k, histogram.size() - 1)];
+    }
+    for (std::size_t k = 0; k < histogram.size(); ++k) {
+        if (histogram[k])
+            state.counters["<2^" + std::to_string(k) + "ns"] =
+              static_cast<double>(histogram[k]);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+/**
+ * @brief Sums the spreads of %state.range(0) quotes by index, which is what
+ * a container pays on the read side for its push_back.
+ */
+template<typename Container>
+static void bench_index_scan(benchmark::State& state)
+{
+    Container quotes;
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+        quotes.push_back(Quote{ 100.0, 100.5 + (i % 8) * 0.5, 10, 20, i });
+
+    for (auto _ : state) {
+        double spread{ 0 };
+        for (std::size_t i = 0; i < quotes.size(); ++i)
+            spread += quotes[i].ask - quotes[i].bid;
+        benchmark::DoNotOptimize(spread);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
@@ -0,0 +1,113 @@
+#include "concurrent_forward_list.h"
+#include "forward_list/forward_list.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+// A shared sorted set of active order ids under contention, across thread
+// counts. The argument is the percentage of lookups; half of the writes
+// insert, the other half erase, so the size of the set stays around half of
+// the key range. dev::concurrent_forward_list is compared with a sorted
+// dev::forward_list behind a std::mutex.
+
+constexpr std::uint64_t key_range = 512;
+
+/**
+ * @brief The single-lock baseline.
+ */
+class locked_forward_list
+{
+  private:
+    dev::forward_list<std::uint64_t> m_list;
+    mutable std::mutex m_mutex;
+
+    // The last element less than key, or before_begin()
+    auto lower_bound_before(std::uint64_t key)
+    {
+        auto prev = m_list.before_begin();
+        for (auto it = m_list.begin(); it != m_list.end() && *it < key; ++it)
+            prev = it;
+        return prev;
+    }
+
+  public:
+    bool contains(std::uint64_t key) const
+    {
+        std::lock_guard lock(m_mutex);
+        for (auto value : m_list) {
+            if (value >= key)
+                return value == key;
+        }
+        return false;
+    }
+
+    bool insert(std::uint64_t key)
+    {
+        std::lock_guard lock(m_mutex);
+        auto prev = lower_bound_before(key);
+        auto next = std::next(prev);
+        if (next != m_list.end() && *next == key)
+            return false;
+        m_list.insert_after(prev, key);
+        return true;
+    }
+
+    bool erase(std::uint64_t key)
+    {
+        std::lock_guard lock(m_mutex);
+        auto prev = lower_bound_before(key);
+        auto next = std::next(prev);
+        if (next == m_list.end() || *next != key)
+            return false;
+        m_list.erase_after(prev);
+        return true;
+    }
+};
+
+using concurrent_list = dev::concurrent_forward_list<std::uint64_t>;
+
+template<typename List>
+static List& shared_list()
+{
+    static List* list = [] {
+        auto* l = new List();
+        for (std::uint64_t key = 0; key < key_range; key += 2)
+            l->insert(key);
+        return l;
+    }();
+    return *list;
+}
+
+template<typename List>
+static void bench_contention(benchmark::State& state)
+{
+    auto& list = shared_list<List>();
+    const auto lookup_percent = static_cast<std::uint64_t>(state.range(0));
+    std::mt19937_64 rng(state.thread_index());
+    std::uint64_t hits = 0;
+    for (auto _ : state) {
+        auto r = rng();
+        auto key = r % key_range;
+        if ((r >> 32) % 100 < lookup_percent)
+            hits += list.contains(key);
+        else if ((r >> 40) & 1)
+            list.insert(key);
+        else
+            list.erase(key);
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void mixes(benchmark::internal::Benchmark* b)
+{
+    for (int lookup_percent : { 90, 50, 0 })
+        b->Arg(lookup_percent);
+    b->ThreadRange(1, 16)->UseRealTime();
+}
+
+BENCHMARK(bench_contention<locked_forward_list>)->Apply(mixes);
+BENCHMARK(bench_contention<concurrent_list>)->Apply(mixes);
+
+BENCHMARK_MAIN();
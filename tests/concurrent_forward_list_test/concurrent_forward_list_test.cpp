@@ -0,0 +1,184 @@
+#include "concurrent_forward_list.h"
+#include <atomic>
+#include <barrier>
+#include <functional>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+template<typename List>
+static std::vector<typename List::value_type> to_vector(const List& list)
+{
+    return std::vector<typename List::value_type>(list.begin(), list.end());
+}
+
+TEST(ConcurrentForwardListTest, DefaultConstructorTest)
+{
+    dev::concurrent_forward_list<int> list;
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(list.size(), 0);
+    EXPECT_FALSE(list.contains(1));
+    EXPECT_FALSE(list.erase(1));
+}
+
+TEST(ConcurrentForwardListTest, InsertEraseContainsTest)
+{
+    dev::concurrent_forward_list<std::string> list;
+    EXPECT_TRUE(list.insert("IBM"));
+    EXPECT_TRUE(list.insert("AAPL"));
+    EXPECT_TRUE(list.emplace(4, 'Z'));
+    EXPECT_FALSE(list.insert("AAPL"));
+    EXPECT_EQ(list.size(), 3);
+    EXPECT_EQ(to_vector(list), (std::vector<std::string>{ "AAPL", "IBM", "ZZZZ" }));
+
+    EXPECT_TRUE(list.contains("IBM"));
+    EXPECT_TRUE(list.erase("IBM"));
+    EXPECT_FALSE(list.erase("IBM"));
+    EXPECT_FALSE(list.contains("IBM"));
+    EXPECT_EQ(list.size(), 2);
+    EXPECT_EQ(to_vector(list), (std::vector<std::string>{ "AAPL", "ZZZZ" }));
+}
+
+TEST(ConcurrentForwardListTest, CustomCompareTest)
+{
+    dev::concurrent_forward_list<int, std::greater<int>> list;
+    for (int i : { 3, 1, 4, 1, 5, 9, 2, 6 })
+        list.insert(i);
+    EXPECT_EQ(to_vector(list), (std::vector<int>{ 9, 6, 5, 4, 3, 2, 1 }));
+    int sum = 0;
+    list.for_each([&sum](int value) { sum += value; });
+    EXPECT_EQ(sum, 30);
+}
+
+TEST(ConcurrentForwardListTest, ConcurrentDisjointInsertsTest)
+{
+    dev::concurrent_forward_list<int> list;
+    constexpr int num_threads = 8;
+    constexpr int per_thread = 500;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&list, t] {
+            // Interleaved keys, so that the threads insert next to each other
+            for (int i = 0; i < per_thread; ++i)
+                ASSERT_TRUE(list.insert(i * num_threads + t));
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(list.size(), num_threads * per_thread);
+    auto values = to_vector(list);
+    ASSERT_EQ(values.size(), num_threads * per_thread);
+    for (int i = 0; i < num_threads * per_thread; ++i)
+        ASSERT_EQ(values[i], i);
+}
+
+TEST(ConcurrentForwardListTest, ExactlyOneWinnerTest)
+{
+    // Every round, all threads race to insert the same keys, then to erase
+    // them: every operation must succeed exactly once per key.
+    dev::concurrent_forward_list<int> list;
+    constexpr int num_threads = 4;
+    constexpr int num_keys = 32;
+    constexpr int rounds = 50;
+    std::vector<std::atomic<int>> inserted(num_keys);
+    std::vector<std::atomic<int>> erased(num_keys);
+    std::atomic<int> failures{ 0 };
+    std::barrier sync(num_threads, [&]() noexcept {
+        for (int key = 0; key < num_keys; ++key) {
+            if (inserted[key] != erased[key] && inserted[key] != erased[key] + 1)
+                ++failures;
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int round = 0; round < rounds; ++round) {
+                for (int i = 0; i < num_keys; ++i) {
+                    int key = (i + t * 7) % num_keys;
+                    if (list.insert(key))
+                        ++inserted[key];
+                }
+                sync.arrive_and_wait();
+                for (int i = 0; i < num_keys; ++i) {
+                    int key = (i + t * 5) % num_keys;
+                    if (list.erase(key))
+                        ++erased[key];
+                }
+                sync.arrive_and_wait();
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(failures.load(), 0);
+    for (int key = 0; key < num_keys; ++key) {
+        EXPECT_EQ(inserted[key].load(), rounds);
+        EXPECT_EQ(erased[key].load(), rounds);
+    }
+    EXPECT_TRUE(list.empty());
+}
+
+TEST(ConcurrentForwardListTest, RandomOperationsStressTest)
+{
+    // Threads insert and erase random keys while readers iterate. Successful
+    // inserts and erases of a key must alternate, so their difference ends at
+    // 0 or 1 and matches contains(); readers must always see a sorted list
+    // without duplicates.
+    dev::concurrent_forward_list<int> list;
+    constexpr int num_keys = 128;
+    constexpr int num_writers = 4;
+    constexpr int ops = 20000;
+    std::vector<std::atomic<int>> balance(num_keys);
+    std::atomic<bool> stop{ false };
+    std::atomic<int> failures{ 0 };
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; ++t) {
+        readers.emplace_back([&] {
+            while (!stop) {
+                int previous = -1;
+                for (int value : list) {
+                    if (value <= previous)
+                        ++failures;
+                    previous = value;
+                }
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int t = 0; t < num_writers; ++t) {
+        writers.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            for (int i = 0; i < ops; ++i) {
+                int key = static_cast<int>(rng() % num_keys);
+                if (rng() % 2) {
+                    if (list.insert(key))
+                        ++balance[key];
+                } else if (list.erase(key)) {
+                    --balance[key];
+                }
+                list.contains(static_cast<int>(rng() % num_keys));
+            }
+        });
+    }
+    for (auto& writer : writers)
+        writer.join();
+    stop = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    EXPECT_EQ(failures.load(), 0);
+    std::size_t present = 0;
+    for (int key = 0; key < num_keys; ++key) {
+        ASSERT_TRUE(balance[key] == 0 || balance[key] == 1);
+        ASSERT_EQ(list.contains(key), balance[key] == 1);
+        present += balance[key];
+    }
+    EXPECT_EQ(list.size(), present);
+    EXPECT_EQ(to_vector(list).size(), present);
+}
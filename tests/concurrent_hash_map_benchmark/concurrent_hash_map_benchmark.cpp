@@ -0,0 +1,97 @@
+#include "concurrent_hash_map.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <shared_mutex>
+#include <unordered_map>
+
+// A shared symbol cache under a read/write mix, across thread counts. The
+// argument is the percentage of reads; half of the writes insert, the other
+// half erase, so the size of the map stays around its initial size.
+// dev::concurrent_hash_map is compared with a std::unordered_map behind a
+// single std::shared_mutex, the way dev::threadsafe_stack guards its stack.
+
+constexpr std::uint64_t key_range = 1 << 18;
+
+/**
+ * @brief The single-lock baseline.
+ */
+class locked_unordered_map
+{
+  private:
+    std::unordered_map<std::uint64_t, std::uint64_t> m_map;
+    mutable std::shared_mutex m_shared_mutex;
+
+  public:
+    std::optional<std::uint64_t> find(std::uint64_t key) const
+    {
+        std::shared_lock lock(m_shared_mutex);
+        auto it = m_map.find(key);
+        if (it == m_map.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    bool insert_or_assign(std::uint64_t key, std::uint64_t value)
+    {
+        std::unique_lock lock(m_shared_mutex);
+        return m_map.insert_or_assign(key, value).second;
+    }
+
+    bool erase(std::uint64_t key)
+    {
+        std::unique_lock lock(m_shared_mutex);
+        return m_map.erase(key) != 0;
+    }
+};
+
+using concurrent_map = dev::concurrent_hash_map<std::uint64_t, std::uint64_t>;
+
+template<typename Map>
+static Map& shared_map()
+{
+    static Map* map = [] {
+        auto* m = new Map();
+        for (std::uint64_t key = 0; key < key_range; key += 2)
+            m->insert_or_assign(key, key);
+        return m;
+    }();
+    return *map;
+}
+
+template<typename Map>
+static void bench_read_write_mix(benchmark::State& state)
+{
+    auto& map = shared_map<Map>();
+    const auto read_percent = static_cast<std::uint64_t>(state.range(0));
+    std::mt19937_64 rng(state.thread_index());
+    std::uint64_t sum = 0;
+    for (auto _ : state) {
+        auto r = rng();
+        auto key = r % key_range;
+        if ((r >> 32) % 100 < read_percent) {
+            if (auto value = map.find(key))
+                sum += *value;
+        } else if ((r >> 40) & 1) {
+            map.insert_or_assign(key, key);
+        } else {
+            map.erase(key);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void mixes(benchmark::internal::Benchmark* b)
+{
+    for (int read_percent : { 99, 90, 50 })
+        b->Arg(read_percent);
+    b->ThreadRange(1, 16)->UseRealTime();
+}
+
+BENCHMARK(bench_read_write_mix<locked_unordered_map>)->Apply(mixes);
+BENCHMARK(bench_read_write_mix<concurrent_map>)->Apply(mixes);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,177 @@
+#include "concurrent_hash_map.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ConcurrentHashMapTest, DefaultConstructorTest)
+{
+    dev::concurrent_hash_map<int, int> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.size(), 0);
+    EXPECT_FALSE(m.contains(1));
+    EXPECT_EQ(m.find(1), std::nullopt);
+    EXPECT_FALSE(m.erase(1));
+}
+
+TEST(ConcurrentHashMapTest, InsertFindEraseTest)
+{
+    dev::concurrent_hash_map<std::string, int> m;
+    EXPECT_TRUE(m.insert("AAPL", 1));
+    EXPECT_FALSE(m.insert("AAPL", 2));
+    EXPECT_EQ(m.find("AAPL"), 1);
+    EXPECT_TRUE(m.try_emplace("MSFT", 3));
+    EXPECT_FALSE(m.insert_or_assign("MSFT", 4));
+    EXPECT_EQ(m.find("MSFT"), 4);
+    EXPECT_TRUE(m.insert_or_assign("IBM", 5));
+    EXPECT_EQ(m.size(), 3);
+
+    EXPECT_TRUE(m.update("AAPL", [](int& value) { value += 10; }));
+    EXPECT_FALSE(m.update("GOOG", [](int& value) { value += 10; }));
+    int seen = 0;
+    EXPECT_TRUE(m.visit("AAPL", [&seen](const int& value) { seen = value; }));
+    EXPECT_EQ(seen, 11);
+
+    EXPECT_TRUE(m.erase("AAPL"));
+    EXPECT_FALSE(m.erase("AAPL"));
+    EXPECT_FALSE(m.contains("AAPL"));
+    EXPECT_EQ(m.size(), 2);
+
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    EXPECT_FALSE(m.contains("MSFT"));
+}
+
+TEST(ConcurrentHashMapTest, IncrementalGrowthTest)
+{
+    // A single stripe, so that it goes through many growths; every lookup is
+    // checked while migrations are pending.
+    dev::concurrent_hash_map<int, int, std::hash<int>, std::equal_to<int>, 1> m;
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_TRUE(m.insert(i, -i));
+        ASSERT_EQ(m.find(i / 2), -(i / 2));
+        if (i % 97 == 0) {
+            for (int j = 0; j <= i; ++j)
+                ASSERT_EQ(m.find(j), -j);
+        }
+    }
+    for (int i = 0; i < 5000; i += 2)
+        ASSERT_TRUE(m.erase(i));
+    EXPECT_EQ(m.size(), 2500);
+    for (int i = 0; i < 5000; ++i)
+        ASSERT_EQ(m.contains(i), i % 2 == 1);
+
+    int count = 0;
+    m.for_each([&count](const auto& entry) {
+        EXPECT_EQ(entry.second, -entry.first);
+        ++count;
+    });
+    EXPECT_EQ(count, 2500);
+}
+
+TEST(ConcurrentHashMapTest, ReserveTest)
+{
+    dev::concurrent_hash_map<int, int> m;
+    m.insert(1, 1);
+    m.reserve(100000);
+    for (int i = 0; i < 1000; ++i)
+        m.insert(i, i);
+    EXPECT_EQ(m.size(), 1000);
+    EXPECT_EQ(m.find(999), 999);
+}
+
+TEST(ConcurrentHashMapTest, ConcurrentWritersTest)
+{
+    dev::concurrent_hash_map<int, int> m;
+    constexpr int num_threads = 8;
+    constexpr int per_thread = 5000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&m, t] {
+            for (int i = 0; i < per_thread; ++i)
+                m.insert(t * per_thread + i, t);
+            // Erase every other key again
+            for (int i = 0; i < per_thread; i += 2)
+                m.erase(t * per_thread + i);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(m.size(), num_threads * per_thread / 2);
+    for (int t = 0; t < num_threads; ++t) {
+        for (int i = 0; i < per_thread; ++i) {
+            auto value = m.find(t * per_thread + i);
+            if (i % 2)
+                ASSERT_EQ(value, t);
+            else
+                ASSERT_EQ(value, std::nullopt);
+        }
+    }
+}
+
+TEST(ConcurrentHashMapTest, ConcurrentUpdatesAreAtomicTest)
+{
+    dev::concurrent_hash_map<int, long> positions;
+    for (int symbol = 0; symbol < 16; ++symbol)
+        positions.insert(symbol, 0);
+
+    constexpr int num_threads = 8;
+    constexpr int fills = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&positions] {
+            for (int i = 0; i < fills; ++i)
+                positions.update(i % 16, [](long& qty) { ++qty; });
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    long total = 0;
+    positions.for_each([&total](const auto& entry) { total += entry.second; });
+    EXPECT_EQ(total, num_threads * fills);
+}
+
+TEST(ConcurrentHashMapTest, ReadersDuringWritesTest)
+{
+    // Readers look up keys that are never erased while writers insert and erase
+    // other keys, forcing growth and migration under the readers.
+    dev::concurrent_hash_map<int, int, std::hash<int>, std::equal_to<int>, 4> m;
+    for (int i = 0; i < 1000; ++i)
+        m.insert(i, i);
+
+    std::atomic<bool> stop{ false };
+    std::atomic<int> failures{ 0 };
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                for (int i = 0; i < 1000; ++i) {
+                    if (m.find(i) != i)
+                        ++failures;
+                }
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 2; ++t) {
+        writers.emplace_back([&m, t] {
+            for (int round = 0; round < 3; ++round) {
+                for (int i = 0; i < 5000; ++i)
+                    m.insert(1000 + t * 5000 + i, i);
+                for (int i = 0; i < 5000; ++i)
+                    m.erase(1000 + t * 5000 + i);
+            }
+        });
+    }
+    for (auto& writer : writers)
+        writer.join();
+    stop = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(m.size(), 1000);
+}
@@ -0,0 +1,106 @@
+#include "epoch_reclaimer.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<int> g_deleted{ 0 };
+
+struct tracked
+{
+    ~tracked() { ++g_deleted; }
+};
+
+// Runs enough reclamation rounds for the epoch to move two steps, when no
+// other thread is pinned.
+void reclaim_all()
+{
+    for (int i = 0; i < 4; ++i)
+        dev::epoch_reclaimer::try_reclaim();
+}
+
+} // namespace
+
+TEST(EpochReclaimerTest, GuardsNestTest)
+{
+    EXPECT_FALSE(dev::epoch_reclaimer::is_pinned());
+    {
+        dev::epoch_reclaimer::guard outer;
+        EXPECT_TRUE(dev::epoch_reclaimer::is_pinned());
+        {
+            dev::epoch_reclaimer::guard inner(outer);
+            EXPECT_TRUE(dev::epoch_reclaimer::is_pinned());
+        }
+        EXPECT_TRUE(dev::epoch_reclaimer::is_pinned());
+    }
+    EXPECT_FALSE(dev::epoch_reclaimer::is_pinned());
+}
+
+TEST(EpochReclaimerTest, RetiredObjectsAreFreedTest)
+{
+    g_deleted = 0;
+    for (int i = 0; i < 10; ++i)
+        dev::epoch_reclaimer::retire(new tracked);
+    reclaim_all();
+    EXPECT_EQ(g_deleted.load(), 10);
+}
+
+TEST(EpochReclaimerTest, PinnedThreadDelaysReclamationTest)
+{
+    g_deleted = 0;
+    std::atomic<bool> pinned{ false };
+    std::atomic<bool> release{ false };
+    std::thread reader([&] {
+        dev::epoch_reclaimer::guard guard;
+        pinned = true;
+        while (!release)
+            std::this_thread::yield();
+    });
+    while (!pinned)
+        std::this_thread::yield();
+
+    dev::epoch_reclaimer::retire(new tracked);
+    auto epoch = dev::epoch_reclaimer::epoch();
+    reclaim_all();
+    // The epoch moves at most one step past the reader
+    EXPECT_LE(dev::epoch_reclaimer::epoch(), epoch + 1);
+    EXPECT_EQ(g_deleted.load(), 0);
+
+    release = true;
+    reader.join();
+    reclaim_all();
+    EXPECT_EQ(g_deleted.load(), 1);
+}
+
+TEST(EpochReclaimerTest, ExitedThreadHandsOverItsObjectsTest)
+{
+    g_deleted = 0;
+    std::thread([] {
+        for (int i = 0; i < 5; ++i)
+            dev::epoch_reclaimer::retire(new tracked);
+    }).join();
+    reclaim_all();
+    EXPECT_EQ(g_deleted.load(), 5);
+}
+
+TEST(EpochReclaimerTest, ConcurrentRetireTest)
+{
+    g_deleted = 0;
+    constexpr int num_threads = 4;
+    constexpr int per_thread = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([] {
+            for (int i = 0; i < per_thread; ++i) {
+                dev::epoch_reclaimer::guard guard;
+                dev::epoch_reclaimer::retire(new tracked);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    reclaim_all();
+    EXPECT_EQ(g_deleted.load(), num_threads * per_thread);
+}
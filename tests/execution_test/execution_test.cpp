@@ -0,0 +1,125 @@
+#include "execution.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(ThreadPoolTest, RunsEveryTaskOnceTest)
+{
+    dev::execution::thread_pool pool(3);
+    EXPECT_EQ(pool.concurrency(), 4);
+
+    for (int round = 0; round < 50; ++round) {
+        std::vector<std::atomic<int>> hits(1000);
+        pool.run(hits.size(), 0, [&](std::size_t i) { ++hits[i]; });
+        for (auto& h : hits)
+            ASSERT_EQ(h.load(), 1);
+    }
+    pool.run(0, 0, [](std::size_t) { FAIL(); });
+}
+
+TEST(ThreadPoolTest, UsesAtMostMaxThreadsTest)
+{
+    dev::execution::thread_pool pool(3);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    pool.run(200, 2, [&](std::size_t) {
+        std::lock_guard lock(mutex);
+        threads.insert(std::this_thread::get_id());
+    });
+    EXPECT_LE(threads.size(), 2);
+
+    threads.clear();
+    pool.run(200, 1, [&](std::size_t) {
+        std::lock_guard lock(mutex);
+        threads.insert(std::this_thread::get_id());
+    });
+    EXPECT_EQ(threads.size(), 1);
+    EXPECT_EQ(*threads.begin(), std::this_thread::get_id());
+}
+
+TEST(ThreadPoolTest, PropagatesExceptionsTest)
+{
+    dev::execution::thread_pool pool(3);
+    std::atomic<int> ran{ 0 };
+    EXPECT_THROW(pool.run(100,
+                          0,
+                          [&](std::size_t i) {
+                              ++ran;
+                              if (i == 10)
+                                  throw std::runtime_error("task failed");
+                          }),
+                 std::runtime_error);
+    EXPECT_LE(ran.load(), 100);
+
+    // The pool is still usable afterwards
+    std::atomic<int> sum{ 0 };
+    pool.run(10, 0, [&](std::size_t i) { sum += static_cast<int>(i); });
+    EXPECT_EQ(sum.load(), 45);
+}
+
+TEST(ThreadPoolTest, NestedRunTest)
+{
+    dev::execution::thread_pool pool(2);
+    std::atomic<int> count{ 0 };
+    pool.run(4, 0, [&](std::size_t) { pool.run(4, 0, [&](std::size_t) { ++count; }); });
+    EXPECT_EQ(count.load(), 16);
+}
+
+TEST(ThreadPoolTest, ConcurrentSubmittersTest)
+{
+    dev::execution::thread_pool pool(2);
+    std::atomic<int> count{ 0 };
+    std::vector<std::thread> submitters;
+    for (int t = 0; t < 4; ++t)
+        submitters.emplace_back([&] {
+            for (int round = 0; round < 20; ++round)
+                pool.run(16, 0, [&](std::size_t) { ++count; });
+        });
+    for (auto& s : submitters)
+        s.join();
+    EXPECT_EQ(count.load(), 4 * 20 * 16);
+}
+
+TEST(PageChunksTest, ChunksArePageAlignedAndCoverTheRangeTest)
+{
+    const std::size_t page = dev::execution::page_size();
+    std::vector<double> buffer(1 << 20);
+
+    // Deliberately misaligned start
+    const double* first = buffer.data() + 3;
+    std::size_t n = buffer.size() - 3;
+    dev::execution::page_chunks<double> chunks(first, n, 4);
+    ASSERT_GT(chunks.count(), 1);
+
+    EXPECT_EQ(chunks.begin(0), 0);
+    EXPECT_EQ(chunks.begin(chunks.count()), n);
+    for (std::size_t k = 1; k < chunks.count(); ++k) {
+        ASSERT_LE(chunks.begin(k - 1), chunks.begin(k));
+        std::size_t i = chunks.begin(k);
+        if (i == n)
+            continue;
+        // The chunk starts at the first element that starts at or after a page
+        // boundary
+        auto address = reinterpret_cast<std::uintptr_t>(first + i);
+        ASSERT_LT(address % page, sizeof(double));
+    }
+}
+
+TEST(PageChunksTest, ForEachPageChunkTest)
+{
+    std::vector<int> buffer(3 * dev::execution::parallel_threshold_bytes / sizeof(int));
+    dev::execution::for_each_page_chunk(
+      dev::execution::par.with_threads(4),
+      buffer.data(),
+      buffer.size(),
+      [&](std::size_t i, std::size_t j) {
+          for (; i < j; ++i)
+              buffer[i] += 1;
+      },
+      [](std::size_t, std::size_t) {});
+    EXPECT_EQ(std::accumulate(buffer.begin(), buffer.end(), std::size_t{ 0 }), buffer.size());
+}
@@ -0,0 +1,135 @@
+#include "flat_hash_map.h"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// dev::flat_hash_map against std::unordered_map on a table of order ids. The
+// argument is the load factor of the flat table in percent: every run uses a
+// table of 2^20 slots holding 2^20 * load / 100 entries. std::unordered_map is
+// given the same number of entries and buckets.
+
+constexpr std::size_t table_slots = std::size_t{ 1 } << 20;
+
+using std_map = std::unordered_map<std::uint64_t, std::uint64_t>;
+using flat_map = dev::flat_hash_map<std::uint64_t, std::uint64_t>;
+
+static std::size_t entries_for(const benchmark::State& state)
+{
+    return table_slots * static_cast<std::size_t>(state.range(0)) / 100;
+}
+
+/**
+ * @brief Order ids present in the map, the same ids in a different order to
+ * look them up, and ids that are not in the map.
+ */
+struct Ids
+{
+    std::vector<std::uint64_t> present;
+    std::vector<std::uint64_t> lookups;
+    std::vector<std::uint64_t> absent;
+
+    explicit Ids(std::size_t n)
+    {
+        std::mt19937_64 rng(n);
+        present.resize(n);
+        absent.resize(n);
+        // Odd ids are in the map, even ids are not
+        for (auto& id : present)
+            id = rng() | 1;
+        for (auto& id : absent)
+            id = rng() & ~std::uint64_t{ 1 };
+        // Looking the ids up in insertion order would walk the nodes of
+        // std::unordered_map in allocation order
+        lookups = present;
+        std::shuffle(lookups.begin(), lookups.end(), rng);
+    }
+};
+
+template<typename Map>
+static Map make_map(const Ids& ids)
+{
+    Map map;
+    map.reserve(table_slots - table_slots / 8);
+    for (auto id : ids.present)
+        map.try_emplace(id, id);
+    return map;
+}
+
+template<typename Map>
+static void bench_insert(benchmark::State& state)
+{
+    Ids ids(entries_for(state));
+    for (auto _ : state) {
+        auto map = make_map<Map>(ids);
+        benchmark::DoNotOptimize(&map);
+    }
+    state.SetItemsProcessed(state.iterations() * ids.present.size());
+}
+
+template<typename Map>
+static void bench_lookup(benchmark::State& state, bool hit)
+{
+    Ids ids(entries_for(state));
+    auto map = make_map<Map>(ids);
+    const auto& probes = hit ? ids.lookups : ids.absent;
+    std::size_t i = 0;
+    std::uint64_t sum = 0;
+    for (auto _ : state) {
+        auto it = map.find(probes[i]);
+        if (it != map.end())
+            sum += it->second;
+        benchmark::DoNotOptimize(sum);
+        if (++i == probes.size())
+            i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename Map>
+static void bench_hit(benchmark::State& state)
+{
+    bench_lookup<Map>(state, true);
+}
+
+template<typename Map>
+static void bench_miss(benchmark::State& state)
+{
+    bench_lookup<Map>(state, false);
+}
+
+// Erases an entry and inserts it back, so that the load factor stays constant
+template<typename Map>
+static void bench_erase(benchmark::State& state)
+{
+    Ids ids(entries_for(state));
+    auto map = make_map<Map>(ids);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto id = ids.lookups[i];
+        benchmark::DoNotOptimize(map.erase(id));
+        map.try_emplace(id, id);
+        if (++i == ids.lookups.size())
+            i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void load_factors(benchmark::internal::Benchmark* b)
+{
+    for (int load : { 25, 50, 75, 87 })
+        b->Arg(load);
+}
+
+BENCHMARK(bench_insert<std_map>)->Apply(load_factors)->Unit(benchmark::kMillisecond);
+BENCHMARK(bench_insert<flat_map>)->Apply(load_factors)->Unit(benchmark::kMillisecond);
+BENCHMARK(bench_hit<std_map>)->Apply(load_factors);
+BENCHMARK(bench_hit<flat_map>)->Apply(load_factors);
+BENCHMARK(bench_miss<std_map>)->Apply(load_factors);
+BENCHMARK(bench_miss<flat_map>)->Apply(load_factors);
+BENCHMARK(bench_erase<std_map>)->Apply(load_factors);
+BENCHMARK(bench_erase<flat_map>)->Apply(load_factors);
+
+BENCHMARK_MAIN();
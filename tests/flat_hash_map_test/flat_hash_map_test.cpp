@@ -0,0 +1,215 @@
+#include "flat_hash_map.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+static_assert(std::forward_iterator<dev::flat_hash_map<int, int>::iterator>);
+static_assert(std::forward_iterator<dev::flat_hash_map<int, int>::const_iterator>);
+
+// Sends every key to one of 4 hash values, so that probe runs get long and
+// wrap around the end of the table.
+struct CollidingHash
+{
+    std::size_t operator()(int key) const { return static_cast<std::size_t>(key & 3); }
+};
+
+struct StringHash
+{
+    using is_transparent = void;
+    std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+
+TEST(FlatHashMapTest, DefaultConstructorTest)
+{
+    dev::flat_hash_map<int, int> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.size(), 0);
+    EXPECT_EQ(m.capacity(), 0);
+    EXPECT_EQ(m.begin(), m.end());
+    EXPECT_FALSE(m.contains(1));
+    EXPECT_EQ(m.find(1), m.end());
+    EXPECT_EQ(m.erase(1), 0);
+}
+
+TEST(FlatHashMapTest, InsertAndFindTest)
+{
+    dev::flat_hash_map<int, std::string> m{ { 1, "a" }, { 2, "b" } };
+    EXPECT_EQ(m.size(), 2);
+    EXPECT_EQ(m.at(1), "a");
+    EXPECT_EQ(m.find(2)->second, "b");
+    EXPECT_THROW(m.at(3), std::out_of_range);
+
+    auto [it, inserted] = m.insert({ 3, "c" });
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->first, 3);
+    auto [it2, inserted2] = m.insert({ 1, "x" });
+    EXPECT_FALSE(inserted2);
+    EXPECT_EQ(it2->second, "a");
+
+    m[4] = "d";
+    m[1] += "!";
+    EXPECT_EQ(m.at(1), "a!");
+    m.try_emplace(4, "y");
+    EXPECT_EQ(m.at(4), "d");
+    m.insert_or_assign(4, "z");
+    EXPECT_EQ(m.at(4), "z");
+    EXPECT_EQ(m.count(4), 1);
+    EXPECT_EQ(m.count(5), 0);
+}
+
+TEST(FlatHashMapTest, GrowthTest)
+{
+    dev::flat_hash_map<std::uint64_t, std::uint64_t> m;
+    for (std::uint64_t i = 0; i < 10000; ++i) {
+        m[i] = i * 3;
+        ASSERT_LE(m.load_factor(), m.max_load_factor());
+    }
+    EXPECT_EQ(m.size(), 10000);
+    for (std::uint64_t i = 0; i < 10000; ++i)
+        ASSERT_EQ(m.at(i), i * 3);
+    EXPECT_FALSE(m.contains(10000));
+
+    std::size_t visited = 0;
+    for (const auto& [key, value] : m) {
+        EXPECT_EQ(value, key * 3);
+        ++visited;
+    }
+    EXPECT_EQ(visited, 10000);
+}
+
+TEST(FlatHashMapTest, ReserveTest)
+{
+    dev::flat_hash_map<int, int> m;
+    m.reserve(1000);
+    auto capacity = m.capacity();
+    EXPECT_GE(capacity * m.max_load_factor(), 1000);
+    for (int i = 0; i < 1000; ++i)
+        m.try_emplace(i, i);
+    EXPECT_EQ(m.capacity(), capacity);
+
+    // Reserving less than the current capacity does nothing
+    m.reserve(10);
+    EXPECT_EQ(m.capacity(), capacity);
+}
+
+TEST(FlatHashMapTest, EraseShiftsBackTest)
+{
+    dev::flat_hash_map<int, int, CollidingHash> m;
+    for (int i = 0; i < 100; ++i)
+        m[i] = i;
+    for (int i = 0; i < 100; i += 3)
+        EXPECT_EQ(m.erase(i), 1);
+    for (int i = 0; i < 100; ++i)
+        ASSERT_EQ(m.contains(i), i % 3 != 0) << i;
+
+    // No tombstones: erasing everything leaves every slot empty, and the
+    // capacity does not change when the table is refilled.
+    auto capacity = m.capacity();
+    for (int i = 0; i < 100; ++i)
+        m.erase(i);
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.begin(), m.end());
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 100; ++i)
+            m[i] = i;
+        for (int i = 0; i < 100; ++i)
+            m.erase(i);
+    }
+    EXPECT_EQ(m.capacity(), capacity);
+}
+
+TEST(FlatHashMapTest, RandomizedAgainstStdUnorderedMapTest)
+{
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> dist(0, 2000);
+    dev::flat_hash_map<int, int> m;
+    std::unordered_map<int, int> reference;
+    for (int i = 0; i < 50000; ++i) {
+        int key = dist(rng);
+        if (rng() % 3 == 0) {
+            ASSERT_EQ(m.erase(key), reference.erase(key));
+        } else {
+            ASSERT_EQ(m.try_emplace(key, i).second, reference.try_emplace(key, i).second);
+        }
+    }
+    ASSERT_EQ(m.size(), reference.size());
+    for (const auto& [key, value] : reference)
+        ASSERT_EQ(m.at(key), value);
+}
+
+TEST(FlatHashMapTest, EraseIfTest)
+{
+    dev::flat_hash_map<int, int, CollidingHash> m;
+    for (int i = 0; i < 200; ++i)
+        m[i] = i;
+    auto removed = erase_if(m, [](const auto& entry) { return entry.second % 2 == 0; });
+    EXPECT_EQ(removed, 100);
+    EXPECT_EQ(m.size(), 100);
+    for (int i = 0; i < 200; ++i)
+        ASSERT_EQ(m.contains(i), i % 2 == 1);
+
+    m.erase(m.find(1));
+    EXPECT_FALSE(m.contains(1));
+    EXPECT_EQ(m.size(), 99);
+}
+
+TEST(FlatHashMapTest, HeterogeneousLookupTest)
+{
+    dev::flat_hash_map<std::string, int, StringHash, std::equal_to<>> m;
+    m["AAPL"] = 1;
+    m["MSFT"] = 2;
+    std::string_view key = "MSFT";
+    EXPECT_TRUE(m.contains(key));
+    EXPECT_EQ(m.find(key)->second, 2);
+    EXPECT_EQ(m.at("AAPL"), 1);
+    EXPECT_EQ(m.erase(std::string_view("AAPL")), 1);
+    EXPECT_EQ(m.size(), 1);
+}
+
+TEST(FlatHashMapTest, MoveOnlyValueTest)
+{
+    dev::flat_hash_map<int, std::unique_ptr<int>> m;
+    for (int i = 0; i < 100; ++i)
+        m.try_emplace(i, std::make_unique<int>(i));
+    m.erase(50);
+    for (int i = 0; i < 100; ++i) {
+        if (i != 50) {
+            ASSERT_EQ(*m.at(i), i);
+        }
+    }
+}
+
+TEST(FlatHashMapTest, CopyMoveAndClearTest)
+{
+    dev::flat_hash_map<std::string, std::string> m{ { "a", "1" }, { "b", "2" } };
+    auto copy = m;
+    EXPECT_EQ(copy.size(), 2);
+    EXPECT_EQ(copy.at("b"), "2");
+
+    auto moved = std::move(m);
+    EXPECT_EQ(moved.size(), 2);
+    EXPECT_TRUE(m.empty());
+    EXPECT_FALSE(m.contains("a"));
+
+    copy.clear();
+    EXPECT_TRUE(copy.empty());
+    EXPECT_FALSE(copy.contains("a"));
+    copy["c"] = "3";
+    EXPECT_EQ(copy.size(), 1);
+
+    copy = moved;
+    EXPECT_EQ(copy.at("a"), "1");
+    EXPECT_FALSE(copy.contains("c"));
+}
+
+#if DEV_HARDENED
+TEST(FlatHashMapDeathTest, HardenedPreconditionsTest)
+{
+    dev::flat_hash_map<int, int> m{ { 1, 1 } };
+    EXPECT_DEATH(m.erase(m.end()), "invalid iterator");
+}
+#endif
@@ -0,0 +1,186 @@
+#include "flat_map.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <map>
+#include <random>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+static_assert(std::random_access_iterator<dev::flat_map<int, int>::iterator>);
+
+TEST(FlatMapTest, DefaultConstructorTest)
+{
+    dev::flat_map<int, std::string> m;
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.size(), 0);
+    EXPECT_EQ(m.begin(), m.end());
+    EXPECT_FALSE(m.contains(1));
+}
+
+TEST(FlatMapTest, BulkConstructionSortsAndDedupesTest)
+{
+    dev::flat_map<int, std::string> m{ { 3, "c" }, { 1, "a" }, { 3, "x" }, { 2, "b" } };
+    EXPECT_EQ(m.size(), 3);
+    EXPECT_TRUE(std::ranges::equal(m.keys(), std::vector<int>{ 1, 2, 3 }));
+    // The first of the duplicates is kept
+    EXPECT_EQ(m.at(3), "c");
+
+    dev::flat_map<int, int> from_vectors(dev::vector<int>{ 5, 4, 6 }, dev::vector<int>{ 50, 40, 60 });
+    EXPECT_TRUE(std::ranges::equal(from_vectors.values(), std::vector<int>{ 40, 50, 60 }));
+
+    EXPECT_THROW((dev::flat_map<int, int>(dev::vector<int>{ 1 }, dev::vector<int>{})),
+                 std::invalid_argument);
+}
+
+TEST(FlatMapTest, SortedUniqueConstructorTest)
+{
+    dev::flat_map<int, int> m(
+      dev::sorted_unique, dev::vector<int>{ 1, 2, 3 }, dev::vector<int>{ 10, 20, 30 });
+    EXPECT_EQ(m.at(2), 20);
+}
+
+TEST(FlatMapTest, IteratorTest)
+{
+    dev::flat_map<int, int> m{ { 2, 20 }, { 1, 10 }, { 3, 30 } };
+    int expected = 1;
+    for (auto [key, value] : m) {
+        EXPECT_EQ(key, expected);
+        EXPECT_EQ(value, 10 * expected);
+        value += 1;
+        ++expected;
+    }
+    EXPECT_EQ(m.at(1), 11);
+
+    auto it = m.begin() + 1;
+    EXPECT_EQ(it->first, 2);
+    EXPECT_EQ(it->second, 21);
+    EXPECT_EQ(it[1].first, 3);
+    EXPECT_EQ(m.end() - m.begin(), 3);
+
+    dev::flat_map<int, int>::const_iterator cit = it;
+    EXPECT_EQ(cit, it);
+    const auto& cm = m;
+    EXPECT_EQ((*cm.find(3)).second, 31);
+}
+
+TEST(FlatMapTest, LookupTest)
+{
+    dev::flat_map<int, char> m{ { 10, 'a' }, { 20, 'b' }, { 30, 'c' } };
+    EXPECT_EQ(m.find(20)->second, 'b');
+    EXPECT_EQ(m.find(25), m.end());
+    EXPECT_EQ(m.count(30), 1);
+    EXPECT_EQ(m.lower_bound(15)->first, 20);
+    EXPECT_EQ(m.upper_bound(20)->first, 30);
+    EXPECT_EQ(m.upper_bound(30), m.end());
+    auto [first, last] = m.equal_range(10);
+    EXPECT_EQ(last - first, 1);
+    EXPECT_THROW(m.at(11), std::out_of_range);
+}
+
+TEST(FlatMapTest, InsertTest)
+{
+    dev::flat_map<std::string, int> m;
+    m["b"] = 2;
+    m["a"] = 1;
+    ++m["b"];
+    EXPECT_EQ(m.at("b"), 3);
+
+    auto [it, inserted] = m.insert({ "c", 4 });
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(it->first, "c");
+    auto [it2, inserted2] = m.insert({ "a", 100 });
+    EXPECT_FALSE(inserted2);
+    EXPECT_EQ(it2->second, 1);
+
+    m.try_emplace("a", 7);
+    EXPECT_EQ(m.at("a"), 1);
+    m.insert_or_assign("a", 7);
+    EXPECT_EQ(m.at("a"), 7);
+    EXPECT_TRUE(std::ranges::equal(m.keys(), std::vector<std::string>{ "a", "b", "c" }));
+}
+
+TEST(FlatMapTest, InsertRangeTest)
+{
+    dev::flat_map<int, int> m{ { 1, 1 }, { 5, 5 } };
+    std::vector<std::pair<int, int>> batch{ { 4, 4 }, { 5, 50 }, { 2, 2 }, { 4, 40 } };
+    m.insert_range(batch);
+    EXPECT_TRUE(std::ranges::equal(m.keys(), std::vector<int>{ 1, 2, 4, 5 }));
+    EXPECT_TRUE(std::ranges::equal(m.values(), std::vector<int>{ 1, 2, 4, 5 }));
+
+    std::vector<std::pair<int, int>> tail{ { 6, 6 }, { 9, 9 } };
+    m.insert_range(dev::sorted_unique, tail);
+    std::vector<std::pair<int, int>> interleaved{ { 0, 0 }, { 3, 3 }, { 9, 90 } };
+    m.insert_range(dev::sorted_unique, interleaved);
+    EXPECT_TRUE(std::ranges::equal(m.keys(), std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 9 }));
+    EXPECT_TRUE(std::ranges::equal(m.values(), std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 9 }));
+}
+
+TEST(FlatMapTest, InsertRangeRollsBackOnThrowTest)
+{
+    dev::flat_map<int, int> m{ { 10, 10 }, { 20, 20 } };
+    std::vector<int> batch{ 4, 3, 2, 1 };
+    auto entries = batch | std::views::transform([](int key) {
+                       if (key == 2)
+                           throw std::runtime_error("entry");
+                       return std::pair<int, int>{ key, key };
+                   });
+    EXPECT_THROW(m.insert_range(entries), std::runtime_error);
+    EXPECT_EQ(m.size(), 2);
+    EXPECT_EQ(m.values().size(), 2);
+    EXPECT_NE(m.find(10), m.end());
+    EXPECT_EQ(m.at(20), 20);
+}
+
+TEST(FlatMapTest, RandomizedAgainstStdMapTest)
+{
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> dist(0, 3000);
+    dev::flat_map<int, int> m;
+    std::map<int, int> reference;
+    for (int round = 0; round < 50; ++round) {
+        std::vector<std::pair<int, int>> batch;
+        for (int i = 0; i < 100; ++i)
+            batch.emplace_back(dist(rng), round * 1000 + i);
+        m.insert_range(batch);
+        reference.insert(batch.begin(), batch.end());
+        for (int i = 0; i < 20; ++i) {
+            int key = dist(rng);
+            EXPECT_EQ(m.erase(key), reference.erase(key));
+        }
+        ASSERT_EQ(m.size(), reference.size());
+        ASSERT_TRUE(std::ranges::equal(
+          m, reference, [](auto lhs, const auto& rhs) {
+              return lhs.first == rhs.first && lhs.second == rhs.second;
+          }));
+    }
+}
+
+TEST(FlatMapTest, EraseTest)
+{
+    dev::flat_map<int, std::string> m{ { 1, "a" }, { 2, "b" }, { 3, "c" } };
+    EXPECT_EQ(m.erase(2), 1);
+    EXPECT_EQ(m.erase(2), 0);
+    auto it = m.erase(m.find(1));
+    EXPECT_EQ(it->first, 3);
+    EXPECT_EQ(it->second, "c");
+    m.clear();
+    EXPECT_TRUE(m.empty());
+}
+
+TEST(FlatMapTest, ExtractAndSwapTest)
+{
+    dev::flat_map<int, int> a{ { 1, 10 }, { 2, 20 } };
+    dev::flat_map<int, int> b;
+    a.swap(b);
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(b, (dev::flat_map<int, int>{ { 2, 20 }, { 1, 10 } }));
+
+    auto [keys, values] = std::move(b).extract();
+    EXPECT_EQ(keys.size(), 2);
+    EXPECT_EQ(values[1], 20);
+    EXPECT_TRUE(b.empty());
+}
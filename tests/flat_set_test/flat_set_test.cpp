@@ -0,0 +1,207 @@
+#include "flat_set.h"
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(FlatSetTest, DefaultConstructorTest)
+{
+    dev::flat_set<int> s;
+    EXPECT_TRUE(s.empty());
+    EXPECT_EQ(s.size(), 0);
+    EXPECT_EQ(s.begin(), s.end());
+    EXPECT_FALSE(s.contains(0));
+    EXPECT_EQ(s.lower_bound(0), s.end());
+}
+
+TEST(FlatSetTest, BulkConstructionSortsAndDedupesTest)
+{
+    dev::flat_set<int> s{ 5, 3, 9, 3, 1, 5, 7 };
+    EXPECT_EQ(s.size(), 5);
+    EXPECT_TRUE(std::ranges::equal(s, std::vector<int>{ 1, 3, 5, 7, 9 }));
+
+    dev::vector<int> keys{ 4, 2, 2, 8 };
+    dev::flat_set<int> from_vector(std::move(keys));
+    EXPECT_TRUE(std::ranges::equal(from_vector, std::vector<int>{ 2, 4, 8 }));
+}
+
+TEST(FlatSetTest, SortedUniqueConstructorTest)
+{
+    dev::flat_set<int> s(dev::sorted_unique, dev::vector<int>{ 1, 2, 3 });
+    EXPECT_EQ(s.size(), 3);
+    EXPECT_TRUE(s.contains(2));
+}
+
+TEST(FlatSetTest, CustomCompareTest)
+{
+    dev::flat_set<int, std::greater<int>> s{ 1, 3, 2 };
+    EXPECT_TRUE(std::ranges::equal(s, std::vector<int>{ 3, 2, 1 }));
+    EXPECT_EQ(*s.lower_bound(2), 2);
+    EXPECT_EQ(*s.upper_bound(2), 1);
+}
+
+TEST(FlatSetTest, LookupTest)
+{
+    dev::flat_set<int> s{ 10, 20, 30, 40 };
+    EXPECT_EQ(*s.find(20), 20);
+    EXPECT_EQ(s.find(25), s.end());
+    EXPECT_EQ(s.count(30), 1);
+    EXPECT_EQ(s.count(35), 0);
+    EXPECT_EQ(*s.lower_bound(25), 30);
+    EXPECT_EQ(*s.lower_bound(30), 30);
+    EXPECT_EQ(*s.upper_bound(30), 40);
+    EXPECT_EQ(s.lower_bound(45), s.end());
+    EXPECT_EQ(s.lower_bound(5), s.begin());
+
+    auto [first, last] = s.equal_range(20);
+    EXPECT_EQ(last - first, 1);
+    auto [first2, last2] = s.equal_range(21);
+    EXPECT_EQ(first2, last2);
+}
+
+TEST(FlatSetTest, BranchlessBoundsMatchStdTest)
+{
+    std::vector<int> keys;
+    for (int i = 0; i < 257; ++i)
+        keys.push_back(2 * i);
+    for (std::size_t n = 0; n <= keys.size(); ++n) {
+        for (int value = -1; value <= static_cast<int>(2 * n) + 1; ++value) {
+            auto first = keys.begin();
+            auto last = keys.begin() + n;
+            ASSERT_EQ(dev::detail::branchless_lower_bound(first, last, value, std::less<>()),
+                      std::lower_bound(first, last, value));
+            ASSERT_EQ(dev::detail::branchless_upper_bound(first, last, value, std::less<>()),
+                      std::upper_bound(first, last, value));
+        }
+    }
+}
+
+TEST(FlatSetTest, InsertTest)
+{
+    dev::flat_set<std::string> s;
+    auto [it, inserted] = s.insert("b");
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(*it, "b");
+    s.insert("a");
+    s.emplace(3, 'c');
+    auto [it2, inserted2] = s.insert("a");
+    EXPECT_FALSE(inserted2);
+    EXPECT_EQ(*it2, "a");
+    EXPECT_TRUE(std::ranges::equal(s, std::vector<std::string>{ "a", "b", "ccc" }));
+}
+
+TEST(FlatSetTest, InsertRangeMergesTest)
+{
+    dev::flat_set<int> s{ 1, 5, 9 };
+    s.insert_range(std::vector<int>{ 8, 2, 5, 2, 12 });
+    EXPECT_TRUE(std::ranges::equal(s, std::vector<int>{ 1, 2, 5, 8, 9, 12 }));
+
+    // Appending keys greater than all existing ones
+    s.insert_range(dev::sorted_unique, std::vector<int>{ 20, 30 });
+    EXPECT_TRUE(std::ranges::equal(s, std::vector<int>{ 1, 2, 5, 8, 9, 12, 20, 30 }));
+
+    // A sorted batch interleaved with the existing keys
+    s.insert_range(dev::sorted_unique, std::vector<int>{ 0, 9, 25 });
+    EXPECT_TRUE(std::ranges::equal(s, std::vector<int>{ 0, 1, 2, 5, 8, 9, 12, 20, 25, 30 }));
+
+    s.insert_range(std::vector<int>{});
+    EXPECT_EQ(s.size(), 10);
+}
+
+TEST(FlatSetTest, InsertRangeKeepsExistingKeyTest)
+{
+    // Keys are compared case-insensitively, so that equivalent keys can be told
+    // apart.
+    auto less = [](const std::string& lhs, const std::string& rhs) {
+        return std::ranges::lexicographical_compare(
+          lhs, rhs, [](char a, char b) { return std::tolower(a) < std::tolower(b); });
+    };
+    dev::flat_set<std::string, decltype(less)> s({ "b", "D" }, less);
+    s.insert_range(std::vector<std::string>{ "d", "B", "a", "A" });
+    EXPECT_TRUE(std::ranges::equal(s, std::vector<std::string>{ "a", "b", "D" }));
+}
+
+TEST(FlatSetTest, InsertRangeRollsBackOnThrowTest)
+{
+    dev::flat_set<int> s{ 10, 20 };
+    std::vector<int> batch{ 4, 3, 2, 1 };
+    auto keys = batch | std::views::transform([](int key) {
+                    if (key == 2)
+                        throw std::runtime_error("key");
+                    return key;
+                });
+    EXPECT_THROW(s.insert_range(keys), std::runtime_error);
+    EXPECT_TRUE(std::ranges::equal(s, std::vector<int>{ 10, 20 }));
+    EXPECT_TRUE(s.contains(10));
+
+    // A comparison that throws during the merge leaves no unsorted tail
+    bool armed = false;
+    auto throwing = [&armed](int a, int b) {
+        if (armed)
+            throw std::runtime_error("compare");
+        return a < b;
+    };
+    dev::flat_set<int, decltype(throwing)> t({ 10, 20 }, throwing);
+    armed = true;
+    EXPECT_THROW(t.insert_range(batch), std::runtime_error);
+    armed = false;
+    EXPECT_TRUE(t.empty());
+    t.insert(5);
+    EXPECT_TRUE(std::ranges::equal(t, std::vector<int>{ 5 }));
+}
+
+TEST(FlatSetTest, RandomizedAgainstStdSetTest)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(0, 5000);
+    dev::flat_set<int> s;
+    std::set<int> reference;
+    for (int round = 0; round < 50; ++round) {
+        std::vector<int> batch(100);
+        for (auto& key : batch)
+            key = dist(rng);
+        s.insert_range(batch);
+        reference.insert(batch.begin(), batch.end());
+        for (int i = 0; i < 20; ++i) {
+            int key = dist(rng);
+            EXPECT_EQ(s.erase(key), reference.erase(key));
+        }
+        ASSERT_TRUE(std::ranges::equal(s, reference));
+    }
+}
+
+TEST(FlatSetTest, EraseTest)
+{
+    dev::flat_set<int> s{ 1, 2, 3, 4, 5, 6 };
+    EXPECT_EQ(s.erase(3), 1);
+    EXPECT_EQ(s.erase(3), 0);
+    auto it = s.erase(s.find(1));
+    EXPECT_EQ(*it, 2);
+    it = s.erase(s.find(4), s.end());
+    EXPECT_EQ(it, s.end());
+    EXPECT_TRUE(std::ranges::equal(s, std::vector<int>{ 2 }));
+    s.clear();
+    EXPECT_TRUE(s.empty());
+}
+
+TEST(FlatSetTest, ExtractAndSwapTest)
+{
+    dev::flat_set<int> a{ 3, 1, 2 };
+    dev::flat_set<int> b{ 7 };
+    a.swap(b);
+    EXPECT_EQ(a.size(), 1);
+    EXPECT_EQ(b.size(), 3);
+    EXPECT_EQ(b, (dev::flat_set<int>{ 1, 2, 3 }));
+
+    auto keys = std::move(b).extract();
+    EXPECT_EQ(keys.size(), 3);
+    EXPECT_EQ(keys[0], 1);
+    EXPECT_TRUE(b.empty());
+}
@@ -0,0 +1,244 @@
+#include "../common/allocation_counter.h"
+#include "forward_list.h"
+#include "vector/vector.h"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <forward_list>
+#include <random>
+
+// Push/pop churn on a list that stays around a steady size, the way an order
+// book level or a free list of sessions is used. dev::forward_list with the
+// default std::allocator and with the node pool is compared with
+// std::forward_list. The allocs_per_iter counter shows how many times each
+// iteration reached the global operator new.
+//
+// FIFO price levels of 10K orders are compared with and without a tail
+// pointer. Sorting lists of up to 10M nodes in place is compared with copying
+// the values into a vector, sorting it and rebuilding the list.
+
+struct order
+{
+    std::uint64_t id;
+    std::int64_t price;
+    std::uint32_t quantity;
+};
+
+using std_list = std::forward_list<order>;
+using dev_list = dev::forward_list<order>;
+using pooled_list = dev::pooled_forward_list<order>;
+
+static void report_allocations(benchmark::State& state, std::uint64_t allocations)
+{
+    state.counters["allocs_per_iter"] = benchmark::Counter(
+      static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Pushes and pops at the front of a list holding state.range(0) elements.
+template<typename List>
+static void bench_push_pop_front(benchmark::State& state)
+{
+    List list;
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+        list.push_front(order{ static_cast<std::uint64_t>(i), i, 100 });
+
+    std::uint64_t id = 0;
+    auto allocations = allocation_count();
+    for (auto _ : state) {
+        list.push_front(order{ ++id, 100, 1 });
+        benchmark::DoNotOptimize(&*list.begin());
+        list.pop_front();
+    }
+    report_allocations(state, allocation_count() - allocations);
+}
+
+// Inserts behind a cursor that walks the list, and erases the element behind
+// the next one, so nodes are freed and reused in a scattered order.
+template<typename List>
+static void bench_insert_erase_after(benchmark::State& state)
+{
+    List list;
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+        list.push_front(order{ static_cast<std::uint64_t>(i), i, 100 });
+
+    std::uint64_t id = 0;
+    auto cursor = list.begin();
+    auto allocations = allocation_count();
+    for (auto _ : state) {
+        auto inserted = list.insert_after(cursor, order{ ++id, 100, 1 });
+        list.erase_after(inserted);
+        if (++inserted == list.end())
+            inserted = list.begin();
+        cursor = inserted;
+    }
+    report_allocations(state, allocation_count() - allocations);
+}
+
+// Grows the list to state.range(0) elements and tears it down again.
+template<typename List>
+static void bench_fill_drain(benchmark::State& state)
+{
+    List list;
+    auto allocations = allocation_count();
+    for (auto _ : state) {
+        for (std::int64_t i = 0; i < state.range(0); ++i)
+            list.push_front(order{ static_cast<std::uint64_t>(i), i, 100 });
+        benchmark::DoNotOptimize(&*list.begin());
+        list.clear();
+    }
+    report_allocations(state, allocation_count() - allocations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Overwrites the values of a list with a random sequence, in place, so that
+// every sort starts from unsorted data without reallocating the nodes.
+template<typename List>
+static void shuffle_values(List& list, std::mt19937_64& rng)
+{
+    for (auto& value : list)
+        value = rng();
+}
+
+// Sorts a list of state.range(0) nodes in place, relinking the nodes.
+template<typename List>
+static void bench_sort(benchmark::State& state)
+{
+    std::mt19937_64 rng(1);
+    List list;
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+        list.push_front(rng());
+
+    std::uint64_t allocations = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        shuffle_values(list, rng);
+        allocations -= allocation_count();
+        state.ResumeTiming();
+        list.sort();
+        state.PauseTiming();
+        allocations += allocation_count();
+        state.ResumeTiming();
+    }
+    report_allocations(state, allocations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The workaround without sort(): copy the values into a vector, sort it and
+// rebuild the list from it.
+static void bench_copy_sort_rebuild(benchmark::State& state)
+{
+    using list_type = dev::forward_list<std::uint64_t>;
+    std::mt19937_64 rng(1);
+    list_type list;
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+        list.push_front(rng());
+
+    std::uint64_t allocations = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        shuffle_values(list, rng);
+        allocations -= allocation_count();
+        state.ResumeTiming();
+        dev::vector<std::uint64_t> values;
+        values.assign(list.begin(), list.end());
+        std::sort(values.begin(), values.end());
+        list = list_type(values.begin(), values.end());
+        state.PauseTiming();
+        allocations += allocation_count();
+        state.ResumeTiming();
+    }
+    report_allocations(state, allocations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+constexpr std::int64_t orders_per_level = 10'000;
+
+// Appends at the end of a list without a tail pointer, by walking to the last
+// node, which is what a FIFO price level had to do before TrackTail.
+template<typename List>
+static void walk_and_append(List& list, const order& o)
+{
+    auto last = list.before_begin();
+    for (auto it = list.begin(); it != list.end(); ++it)
+        last = it;
+    list.insert_after(last, o);
+}
+
+template<typename List>
+static void append_order(List& list, const order& o)
+{
+    if constexpr (requires { list.push_back(o); })
+        list.push_back(o);
+    else
+        walk_and_append(list, o);
+}
+
+// A FIFO price level holding 10K orders: every iteration enqueues an order at
+// the back and fills the one at the front.
+template<typename List>
+static void bench_fifo_level(benchmark::State& state)
+{
+    List level;
+    for (std::int64_t i = 0; i < orders_per_level; ++i)
+        append_order(level, order{ static_cast<std::uint64_t>(i), 100, 1 });
+
+    std::uint64_t id = orders_per_level;
+    for (auto _ : state) {
+        append_order(level, order{ ++id, 100, 1 });
+        benchmark::DoNotOptimize(level.begin()->id);
+        level.pop_front();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Moves a batch of state.range(0) incoming orders to the back of a level
+// holding 10K orders with append(), then drains as many from the front.
+static void bench_append_batch(benchmark::State& state)
+{
+    using list_type = dev::pooled_forward_list<order, true>;
+    list_type level;
+    for (std::int64_t i = 0; i < orders_per_level; ++i)
+        level.push_back(order{ static_cast<std::uint64_t>(i), 100, 1 });
+
+    std::uint64_t id = orders_per_level;
+    for (auto _ : state) {
+        list_type batch;
+        for (std::int64_t i = 0; i < state.range(0); ++i)
+            batch.push_back(order{ ++id, 100, 1 });
+        level.append(std::move(batch));
+        for (std::int64_t i = 0; i < state.range(0); ++i)
+            level.pop_front();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(bench_push_pop_front<std_list>)->Arg(1)->Arg(1000);
+BENCHMARK(bench_push_pop_front<dev_list>)->Arg(1)->Arg(1000);
+BENCHMARK(bench_push_pop_front<pooled_list>)->Arg(1)->Arg(1000);
+
+BENCHMARK(bench_insert_erase_after<std_list>)->Arg(1000)->Arg(100000);
+BENCHMARK(bench_insert_erase_after<dev_list>)->Arg(1000)->Arg(100000);
+BENCHMARK(bench_insert_erase_after<pooled_list>)->Arg(1000)->Arg(100000);
+
+BENCHMARK(bench_fill_drain<std_list>)->Arg(1000);
+BENCHMARK(bench_fill_drain<dev_list>)->Arg(1000);
+BENCHMARK(bench_fill_drain<pooled_list>)->Arg(1000);
+
+BENCHMARK(bench_fifo_level<std_list>);
+BENCHMARK(bench_fifo_level<dev_list>);
+BENCHMARK(bench_fifo_level<dev::forward_list<order, std::allocator<order>, true>>);
+BENCHMARK(bench_fifo_level<dev::pooled_forward_list<order, true>>);
+BENCHMARK(bench_append_batch)->Arg(1)->Arg(16)->Arg(256);
+
+static void sort_sizes(benchmark::internal::Benchmark* b)
+{
+    b->Arg(1'000)->Arg(100'000)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(bench_sort<std::forward_list<std::uint64_t>>)->Apply(sort_sizes);
+BENCHMARK(bench_sort<dev::forward_list<std::uint64_t>>)->Apply(sort_sizes);
+BENCHMARK(bench_sort<dev::pooled_forward_list<std::uint64_t>>)->Apply(sort_sizes);
+BENCHMARK(bench_copy_sort_rebuild)->Apply(sort_sizes);
+
+BENCHMARK_MAIN();
@@ -1,5 +1,12 @@
 #include <gtest/gtest.h>
 #include "forward_list.h"
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 TEST(ForwardListTest, DefaultConstructorTest)
 {
@@ -57,4 +64,300 @@ TEST(ForwardListTest, MoveConstructorTest)
     EXPECT_EQ(lst1.empty(), true);
     EXPECT_EQ(lst2.size(), 3);
     EXPECT_EQ(*lst2.begin(), 1);
-}
\ No newline at end of file
+}
+
+TEST(ForwardListTest, PushFrontAndBeforeBeginTest)
+{
+    dev::forward_list<int> lst;
+    lst.push_front(3);
+    lst.push_front(2);
+    lst.insert_after(lst.before_begin(), 1);
+    EXPECT_EQ(lst.size(), 3);
+    EXPECT_EQ(std::vector<int>(lst.begin(), lst.end()), (std::vector<int>{1, 2, 3}));
+
+    lst.pop_front();
+    EXPECT_EQ(*lst.begin(), 2);
+    EXPECT_EQ(lst.size(), 2);
+}
+
+TEST(ForwardListTest, EraseAfterTest)
+{
+    dev::forward_list<int> lst{1, 2, 3, 4};
+    auto it = lst.erase_after(lst.begin());
+    EXPECT_EQ(*it, 3);
+    EXPECT_EQ(lst.erase_after(it), lst.end());
+    EXPECT_EQ(lst.erase_after(it), lst.end());
+    EXPECT_EQ(std::vector<int>(lst.begin(), lst.end()), (std::vector<int>{1, 3}));
+    EXPECT_EQ(lst.size(), 2);
+}
+
+TEST(ForwardListTest, ResizeTest)
+{
+    dev::forward_list<int> lst{1, 2, 3, 4, 5};
+    lst.resize(2);
+    EXPECT_EQ(std::vector<int>(lst.begin(), lst.end()), (std::vector<int>{1, 2}));
+    lst.resize(4);
+    EXPECT_EQ(std::vector<int>(lst.begin(), lst.end()), (std::vector<int>{1, 2, 0, 0}));
+    lst.resize(0);
+    EXPECT_TRUE(lst.empty());
+    EXPECT_EQ(lst.size(), 0);
+}
+
+TEST(ForwardListTest, EmplaceAndArrowTest)
+{
+    dev::forward_list<std::string> lst;
+    lst.emplace_front(3, 'a');
+    auto it = lst.emplace_after(lst.begin(), "bc");
+    EXPECT_EQ(*lst.begin(), "aaa");
+    EXPECT_EQ(it->size(), 2);
+
+    dev::forward_list<std::string>::const_iterator cit = lst.begin();
+    EXPECT_EQ(cit->size(), 3);
+}
+
+TEST(ForwardListTest, AssignmentTest)
+{
+    dev::forward_list<int> lst1{1, 2, 3};
+    dev::forward_list<int> lst2{4};
+    lst2 = lst1;
+    EXPECT_EQ(std::vector<int>(lst2.begin(), lst2.end()), (std::vector<int>{1, 2, 3}));
+
+    dev::forward_list<int> lst3;
+    lst3 = std::move(lst1);
+    EXPECT_TRUE(lst1.empty());
+    EXPECT_EQ(lst3.size(), 3);
+}
+
+TEST(ForwardListTest, PoolAllocatorTest)
+{
+    dev::pooled_forward_list<std::string> lst;
+    for (int i = 0; i < 1000; ++i)
+        lst.push_front(std::to_string(i));
+    EXPECT_EQ(lst.size(), 1000);
+    EXPECT_EQ(*lst.begin(), "999");
+
+    // A freed node goes back to the free list of this thread and is the next
+    // one handed out
+    const std::string* front = &*lst.begin();
+    lst.pop_front();
+    lst.push_front("again");
+    EXPECT_EQ(&*lst.begin(), front);
+    EXPECT_EQ(lst.size(), 1000);
+
+    dev::pooled_forward_list<std::string> copy(lst);
+    EXPECT_EQ(std::vector<std::string>(copy.begin(), copy.end()),
+              std::vector<std::string>(lst.begin(), lst.end()));
+}
+
+TEST(ForwardListTest, SpliceAfterTest)
+{
+    dev::forward_list<int> lst1{1, 2, 3};
+    dev::forward_list<int> lst2{10, 20, 30};
+    const int* moved = &*lst2.begin();
+
+    // A single element, relinked rather than copied
+    lst1.splice_after(lst1.before_begin(), lst2, lst2.before_begin());
+    EXPECT_EQ(&*lst1.begin(), moved);
+    EXPECT_EQ(std::vector<int>(lst1.begin(), lst1.end()), (std::vector<int>{10, 1, 2, 3}));
+    EXPECT_EQ(std::vector<int>(lst2.begin(), lst2.end()), (std::vector<int>{20, 30}));
+
+    // A range
+    auto last = lst1.begin();
+    ++last;
+    ++last;
+    lst2.splice_after(lst2.begin(), lst1, lst1.begin(), ++last);
+    EXPECT_EQ(std::vector<int>(lst1.begin(), lst1.end()), (std::vector<int>{10, 3}));
+    EXPECT_EQ(std::vector<int>(lst2.begin(), lst2.end()), (std::vector<int>{20, 1, 2, 30}));
+
+    // A whole list
+    lst1.splice_after(lst1.begin(), std::move(lst2));
+    EXPECT_TRUE(lst2.empty());
+    EXPECT_EQ(lst2.size(), 0);
+    EXPECT_EQ(std::vector<int>(lst1.begin(), lst1.end()), (std::vector<int>{10, 20, 1, 2, 30, 3}));
+    EXPECT_EQ(lst1.size(), 6);
+}
+
+TEST(ForwardListTest, MergeTest)
+{
+    using entry = std::pair<int, char>;
+    auto by_key = [](const entry& a, const entry& b) { return a.first < b.first; };
+    dev::forward_list<entry> lst1{{1, 'a'}, {3, 'a'}, {5, 'a'}};
+    dev::forward_list<entry> lst2{{1, 'b'}, {2, 'b'}, {5, 'b'}, {6, 'b'}};
+    lst1.merge(lst2, by_key);
+    EXPECT_TRUE(lst2.empty());
+    EXPECT_EQ(lst1.size(), 7);
+    EXPECT_EQ(std::vector<entry>(lst1.begin(), lst1.end()),
+              (std::vector<entry>{{1, 'a'}, {1, 'b'}, {2, 'b'}, {3, 'a'}, {5, 'a'}, {5, 'b'}, {6, 'b'}}));
+}
+
+TEST(ForwardListTest, SortTest)
+{
+    dev::forward_list<int> empty;
+    empty.sort();
+    EXPECT_TRUE(empty.empty());
+
+    std::vector<int> values(1000);
+    std::mt19937 rng(3);
+    for (auto& value : values)
+        value = static_cast<int>(rng() % 100);
+    dev::forward_list<int> lst(values.begin(), values.end());
+    lst.sort();
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(std::vector<int>(lst.begin(), lst.end()), values);
+    EXPECT_EQ(lst.size(), 1000);
+
+    lst.sort(std::greater<>());
+    std::reverse(values.begin(), values.end());
+    EXPECT_EQ(std::vector<int>(lst.begin(), lst.end()), values);
+}
+
+TEST(ForwardListTest, SortIsStableTest)
+{
+    using entry = std::pair<int, int>;
+    std::vector<entry> values;
+    for (int i = 0; i < 257; ++i)
+        values.emplace_back(i % 7, i);
+    dev::forward_list<entry> lst(values.begin(), values.end());
+    lst.sort([](const entry& a, const entry& b) { return a.first < b.first; });
+    std::stable_sort(values.begin(), values.end(),
+                     [](const entry& a, const entry& b) { return a.first < b.first; });
+    EXPECT_EQ(std::vector<entry>(lst.begin(), lst.end()), values);
+}
+
+TEST(ForwardListTest, ThrowingCompareKeepsElementsTest)
+{
+    // A comparator that throws on its fourth call
+    auto throwing = [calls = 0](int a, int b) mutable {
+        if (++calls == 4)
+            throw std::runtime_error("compare");
+        return a < b;
+    };
+    std::vector<int> values{5, 4, 3, 2, 1, 0, 9, 8};
+    dev::forward_list<int> lst(values.begin(), values.end());
+    EXPECT_THROW(lst.sort(throwing), std::runtime_error);
+    std::vector<int> left(lst.begin(), lst.end());
+    EXPECT_EQ(left.size(), lst.size());
+    std::sort(left.begin(), left.end());
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(left, values);
+
+    using list = dev::forward_list<int, std::allocator<int>, true>;
+    list lst1{1, 3, 5, 7};
+    list lst2{2, 4, 6};
+    EXPECT_THROW(lst1.merge(lst2, throwing), std::runtime_error);
+    EXPECT_TRUE(lst2.empty());
+    EXPECT_EQ(lst2.begin(), lst2.end());
+    EXPECT_EQ(lst1.size(), 7);
+    EXPECT_EQ(std::distance(lst1.begin(), lst1.end()), 7);
+    lst1.push_back(8);
+    lst2.push_back(9);
+    EXPECT_EQ(lst1.back(), 8);
+    EXPECT_EQ(lst2.back(), 9);
+    EXPECT_EQ(lst1.size(), 8);
+}
+
+TEST(ForwardListTest, ReverseUniqueRemoveTest)
+{
+    dev::forward_list<int> lst{1, 1, 2, 3, 3, 3, 4, 1};
+    lst.reverse();
+    EXPECT_EQ(std::vector<int>(lst.begin(), lst.end()), (std::vector<int>{1, 4, 3, 3, 3, 2, 1, 1}));
+
+    EXPECT_EQ(lst.unique(), 3);
+    EXPECT_EQ(std::vector<int>(lst.begin(), lst.end()), (std::vector<int>{1, 4, 3, 2, 1}));
+    EXPECT_EQ(lst.size(), 5);
+
+    EXPECT_EQ(lst.remove_if([](int value) { return value % 2 == 0; }), 2);
+    EXPECT_EQ(std::vector<int>(lst.begin(), lst.end()), (std::vector<int>{1, 3, 1}));
+
+    // The value may be an element of the list itself
+    EXPECT_EQ(lst.remove(*lst.begin()), 2);
+    EXPECT_EQ(std::vector<int>(lst.begin(), lst.end()), (std::vector<int>{3}));
+    EXPECT_EQ(lst.size(), 1);
+}
+
+TEST(ForwardListTest, PushBackWithTailTest)
+{
+    dev::forward_list<std::string, std::allocator<std::string>, true> lst;
+    lst.push_back("b");
+    lst.push_front("a");
+    lst.emplace_back(2, 'c');
+    EXPECT_EQ(lst.back(), "cc");
+    EXPECT_EQ(lst.size(), 3);
+    EXPECT_EQ(std::vector<std::string>(lst.begin(), lst.end()), (std::vector<std::string>{"a", "b", "cc"}));
+
+    // Erasing the last element moves the tail back
+    lst.erase_after(lst.begin());
+    lst.erase_after(lst.begin());
+    EXPECT_EQ(lst.back(), "a");
+    lst.pop_front();
+    EXPECT_TRUE(lst.empty());
+    lst.push_back("d");
+    EXPECT_EQ(lst.back(), "d");
+    EXPECT_EQ(*lst.begin(), "d");
+}
+
+TEST(ForwardListTest, AppendWithTailTest)
+{
+    using list = dev::pooled_forward_list<int, true>;
+    list lst1{1, 2};
+    list lst2{3, 4};
+    lst1.append(std::move(lst2));
+    EXPECT_TRUE(lst2.empty());
+    EXPECT_EQ(lst1.size(), 4);
+    EXPECT_EQ(lst1.back(), 4);
+    lst1.append(list());
+    lst2.push_back(7);
+    lst1.append(std::move(lst2));
+    lst1.push_back(5);
+    EXPECT_EQ(std::vector<int>(lst1.begin(), lst1.end()), (std::vector<int>{1, 2, 3, 4, 7, 5}));
+
+    // Moved-from and swapped lists keep a valid tail
+    list lst3(std::move(lst1));
+    lst1.push_back(9);
+    EXPECT_EQ(lst1.back(), 9);
+    lst1.swap(lst3);
+    lst3.push_back(10);
+    lst1.push_back(6);
+    EXPECT_EQ(std::vector<int>(lst3.begin(), lst3.end()), (std::vector<int>{9, 10}));
+    EXPECT_EQ(lst1.back(), 6);
+    EXPECT_EQ(lst1.size(), 7);
+}
+
+TEST(ForwardListTest, TailFollowsListOperationsTest)
+{
+    using list = dev::forward_list<int, std::allocator<int>, true>;
+    list lst{5, 3, 1, 4};
+    lst.sort();
+    EXPECT_EQ(lst.back(), 5);
+    lst.reverse();
+    EXPECT_EQ(lst.back(), 1);
+    lst.resize(2);
+    EXPECT_EQ(lst.back(), 4);
+    lst.resize(3);
+    EXPECT_EQ(lst.back(), 0);
+
+    list other{7, 8};
+    lst.splice_after(lst.before_begin(), other, other.begin());
+    EXPECT_EQ(other.back(), 7);
+    EXPECT_EQ(lst.back(), 0);
+    lst.splice_after(std::next(lst.begin(), 3), other);
+    EXPECT_EQ(lst.back(), 7);
+    EXPECT_TRUE(other.empty());
+    other.push_back(1);
+    EXPECT_EQ(std::vector<int>(other.begin(), other.end()), (std::vector<int>{1}));
+
+    list sorted1{1, 4};
+    list sorted2{2, 3};
+    sorted1.merge(sorted2);
+    EXPECT_EQ(sorted1.back(), 4);
+    sorted2.push_back(6);
+    sorted1.merge(sorted2);
+    EXPECT_EQ(sorted1.back(), 6);
+
+    sorted1.remove_if([](int value) { return value > 3; });
+    EXPECT_EQ(sorted1.back(), 3);
+    sorted1.push_back(3);
+    sorted1.unique();
+    EXPECT_EQ(sorted1.back(), 3);
+    EXPECT_EQ(std::vector<int>(sorted1.begin(), sorted1.end()), (std::vector<int>{1, 2, 3}));
+}
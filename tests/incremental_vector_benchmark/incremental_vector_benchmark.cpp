@@ -0,0 +1,32 @@
+#include "../common/push_back_latency.h"
+#include "incremental_vector.h"
+#include "vector.h"
+#include <benchmark/benchmark.h>
+
+// Per-operation latency of push_back, as percentiles and a log2 histogram,
+// reported as in the segmented_vector benchmark. A dev::vector reallocation
+// shows up as a single push_back in the millisecond buckets, which
+// incremental_vector spreads over the following push_backs, a few elements at
+// a time.
+
+BENCHMARK(bench_push_back_latency<dev::vector<Quote>>)
+  ->Arg(1 << 20)
+  ->Arg(10'000'000)
+  ->Iterations(3)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(bench_push_back_latency<dev::incremental_vector<Quote, 1>>)
+  ->Arg(1 << 20)
+  ->Arg(10'000'000)
+  ->Iterations(3)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(bench_push_back_latency<dev::incremental_vector<Quote, 4>>)
+  ->Arg(1 << 20)
+  ->Arg(10'000'000)
+  ->Iterations(3)
+  ->Unit(benchmark::kMillisecond);
+
+// The cost on the read side: one branch per access while migrating.
+BENCHMARK(bench_index_scan<dev::vector<Quote>>)->Range(1 << 10, 1 << 20);
+BENCHMARK(bench_index_scan<dev::incremental_vector<Quote>>)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,152 @@
+#include "incremental_vector.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <numeric>
+#include <string>
+
+TEST(IncrementalVectorTest, DefaultConstructorTest)
+{
+    dev::incremental_vector<int> v;
+    EXPECT_EQ(v.empty(), true);
+    EXPECT_EQ(v.size(), 0);
+    EXPECT_EQ(v.capacity(), 0);
+    EXPECT_EQ(v.pending_migration(), 0);
+}
+
+TEST(IncrementalVectorTest, GrowthIsSpreadOverPushBacksTest)
+{
+    dev::incremental_vector<int, 2> v;
+    for (int i = 0; i < 16; ++i)
+        v.push_back(i);
+    EXPECT_EQ(v.capacity(), 16);
+    EXPECT_EQ(v.pending_migration(), 0);
+
+    // Growing moves two old elements per push_back
+    v.push_back(16);
+    EXPECT_EQ(v.capacity(), 32);
+    EXPECT_EQ(v.pending_migration(), 14);
+    for (int i = 0; i < v.size(); ++i)
+        EXPECT_EQ(v[i], i);
+
+    for (int i = 17; i < 24; ++i)
+        v.push_back(i);
+    EXPECT_EQ(v.pending_migration(), 0);
+    for (int i = 0; i < v.size(); ++i)
+        EXPECT_EQ(v[i], i);
+}
+
+TEST(IncrementalVectorTest, MigrationFinishesBeforeNextGrowthTest)
+{
+    dev::incremental_vector<std::string, 1> v;
+    for (int i = 0; i < 10000; ++i) {
+        v.push_back(std::to_string(i));
+        ASSERT_LE(v.pending_migration(), v.capacity() - v.size());
+    }
+    for (int i = 0; i < 10000; ++i)
+        ASSERT_EQ(v[i], std::to_string(i));
+}
+
+TEST(IncrementalVectorTest, PushBackOwnElementTest)
+{
+    dev::incremental_vector<std::string, 1> v;
+    for (int i = 0; i < 16; ++i)
+        v.push_back(std::string(32, 'a' + i));
+
+    // Triggers growth: v[0] is still in the old block
+    v.push_back(v[0]);
+    EXPECT_EQ(v.back(), std::string(32, 'a'));
+    v.push_back(v[1]);
+    EXPECT_EQ(v.back(), std::string(32, 'b'));
+}
+
+TEST(IncrementalVectorTest, DataFinishesMigrationTest)
+{
+    dev::incremental_vector<double> v;
+    for (int i = 0; i < 17; ++i)
+        v.push_back(i);
+    EXPECT_GT(v.pending_migration(), 0);
+
+    double* p = v.data();
+    EXPECT_EQ(v.pending_migration(), 0);
+    EXPECT_EQ(std::accumulate(p, p + v.size(), 0.0), 136.0);
+}
+
+TEST(IncrementalVectorTest, IteratorTest)
+{
+    static_assert(std::random_access_iterator<dev::incremental_vector<int>::iterator>);
+    static_assert(std::random_access_iterator<dev::incremental_vector<int>::const_iterator>);
+
+    dev::incremental_vector<int, 1> v;
+    for (int i = 1; i <= 40; ++i)
+        v.push_back(i);
+    ASSERT_GT(v.pending_migration(), 0);
+
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0), 820);
+    EXPECT_EQ(v.end() - v.begin(), 40);
+    std::ranges::reverse(v);
+    EXPECT_EQ(v.front(), 40);
+    EXPECT_EQ(v.back(), 1);
+}
+
+TEST(IncrementalVectorTest, PopBackDuringMigrationTest)
+{
+    auto counter = std::make_shared<int>(0);
+    dev::incremental_vector<std::shared_ptr<int>, 1> v;
+    for (int i = 0; i < 17; ++i)
+        v.push_back(counter);
+    ASSERT_EQ(v.pending_migration(), 15);
+
+    // Pop into the elements that are still in the old block
+    for (int i = 0; i < 10; ++i)
+        v.pop_back();
+    EXPECT_EQ(v.size(), 7);
+    EXPECT_EQ(v.pending_migration(), 7);
+    EXPECT_EQ(counter.use_count(), 8);
+
+    v.push_back(counter);
+    EXPECT_EQ(v.pending_migration(), 6);
+
+    v.clear();
+    EXPECT_EQ(counter.use_count(), 1);
+    EXPECT_EQ(v.pending_migration(), 0);
+    EXPECT_EQ(v.capacity(), 32);
+}
+
+TEST(IncrementalVectorTest, CopyMoveAndReserveTest)
+{
+    dev::incremental_vector<std::string, 1> v;
+    for (int i = 0; i < 20; ++i)
+        v.push_back(std::to_string(i));
+    ASSERT_GT(v.pending_migration(), 0);
+
+    auto copy = v;
+    EXPECT_EQ(copy.size(), 20);
+    EXPECT_EQ(copy.pending_migration(), 0);
+    EXPECT_EQ(copy[3], "3");
+
+    auto moved = std::move(v);
+    EXPECT_EQ(v.size(), 0);
+    EXPECT_EQ(moved[19], "19");
+    EXPECT_GT(moved.pending_migration(), 0);
+
+    moved.reserve(1000);
+    EXPECT_EQ(moved.pending_migration(), 0);
+    EXPECT_EQ(moved.capacity(), 1000);
+    EXPECT_EQ(moved[0], "0");
+
+    dev::vector<std::string> plain = moved.to_vector();
+    EXPECT_EQ(plain.size(), 20);
+    EXPECT_EQ(plain[10], "10");
+}
+
+#if DEV_HARDENED
+TEST(IncrementalVectorDeathTest, HardenedPreconditionsTest)
+{
+    dev::incremental_vector<int> v{ 1, 2, 3 };
+    EXPECT_DEATH(v[3], "incremental_vector index out of bounds");
+
+    dev::incremental_vector<int> empty;
+    EXPECT_DEATH(empty.front(), "incremental_vector index out of bounds");
+    EXPECT_DEATH(empty.pop_back(), "pop_back\\(\\) called on an empty incremental_vector");
+}
+#endif
@@ -0,0 +1,120 @@
+#include "forward_list/forward_list.h"
+#include "intrusive_forward_list.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// Orders move between the price levels of a book: every iteration takes the
+// order at the front of a random level and re-queues it at another random
+// level. The intrusive list relinks the order in place; dev::forward_list has
+// to copy it into a new node, from malloc or from the node pool.
+
+constexpr std::size_t num_levels = 64;
+
+struct order
+{
+    std::uint64_t id;
+    std::int64_t price;
+    std::uint32_t quantity;
+    std::uint32_t flags;
+    dev::intrusive_forward_list_hook level_hook;
+};
+
+using intrusive_level = dev::intrusive_forward_list<order, &order::level_hook>;
+
+static std::vector<std::size_t> random_levels()
+{
+    std::mt19937_64 rng(42);
+    std::vector<std::size_t> levels(1 << 16);
+    for (auto& level : levels)
+        level = rng() % num_levels;
+    return levels;
+}
+
+static void bench_move_orders_intrusive(benchmark::State& state)
+{
+    const auto orders_per_level = static_cast<std::size_t>(state.range(0));
+    std::vector<order> orders(num_levels * orders_per_level);
+    std::vector<intrusive_level> levels(num_levels);
+    for (std::size_t i = 0; i < orders.size(); ++i) {
+        orders[i].id = i;
+        levels[i % num_levels].push_front(orders[i]);
+    }
+
+    const auto targets = random_levels();
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto& from = levels[targets[i++ & 0xffff]];
+        auto& to = levels[targets[i++ & 0xffff]];
+        if (!from.empty())
+            to.splice_after(to.before_begin(), from, from.before_begin());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename List>
+static void bench_move_orders_copy(benchmark::State& state)
+{
+    const auto orders_per_level = static_cast<std::size_t>(state.range(0));
+    std::vector<List> levels(num_levels);
+    for (std::size_t i = 0; i < num_levels * orders_per_level; ++i)
+        levels[i % num_levels].push_front(order{ i, 0, 100, 0, {} });
+
+    const auto targets = random_levels();
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto& from = levels[targets[i++ & 0xffff]];
+        auto& to = levels[targets[i++ & 0xffff]];
+        if (!from.empty()) {
+            to.push_front(*from.begin());
+            from.pop_front();
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Queues orders at a single level and fills them from the front.
+static void bench_push_pop_intrusive(benchmark::State& state)
+{
+    std::vector<order> orders(static_cast<std::size_t>(state.range(0)));
+    intrusive_level level;
+    for (auto& o : orders)
+        level.push_front(o);
+
+    for (auto _ : state) {
+        order& o = level.front();
+        level.pop_front();
+        benchmark::DoNotOptimize(o.id);
+        level.push_front(o);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename List>
+static void bench_push_pop_copy(benchmark::State& state)
+{
+    List level;
+    for (std::int64_t i = 0; i < state.range(0); ++i)
+        level.push_front(order{ static_cast<std::uint64_t>(i), 0, 100, 0, {} });
+
+    for (auto _ : state) {
+        order o = *level.begin();
+        level.pop_front();
+        benchmark::DoNotOptimize(o.id);
+        level.push_front(o);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(bench_move_orders_intrusive)->Arg(16)->Arg(1024);
+BENCHMARK(bench_move_orders_copy<dev::forward_list<order>>)->Arg(16)->Arg(1024);
+BENCHMARK(bench_move_orders_copy<dev::pooled_forward_list<order>>)->Arg(16)->Arg(1024);
+
+BENCHMARK(bench_push_pop_intrusive)->Arg(1000);
+BENCHMARK(bench_push_pop_copy<dev::forward_list<order>>)->Arg(1000);
+BENCHMARK(bench_push_pop_copy<dev::pooled_forward_list<order>>)->Arg(1000);
+
+BENCHMARK_MAIN();
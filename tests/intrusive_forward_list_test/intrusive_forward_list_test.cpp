@@ -0,0 +1,153 @@
+#include "intrusive_forward_list.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+struct order
+{
+    int id;
+    dev::intrusive_forward_list_hook level_hook;
+    dev::intrusive_forward_list_hook trader_hook;
+
+    // Implicit, so that { 1 } makes an order with unlinked hooks
+    order(int id)
+      : id{ id }
+    {
+    }
+};
+
+using level_list = dev::intrusive_forward_list<order, &order::level_hook>;
+using trader_list = dev::intrusive_forward_list<order, &order::trader_hook>;
+
+template<typename List>
+std::vector<int> ids(const List& list)
+{
+    std::vector<int> result;
+    for (const order& o : list)
+        result.push_back(o.id);
+    return result;
+}
+
+} // namespace
+
+TEST(IntrusiveForwardListTest, DefaultConstructorTest)
+{
+    level_list list;
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(list.size(), 0);
+    EXPECT_EQ(list.begin(), list.end());
+}
+
+TEST(IntrusiveForwardListTest, PushFrontAndPopFrontTest)
+{
+    std::vector<order> orders{ { 1 }, { 2 }, { 3 } };
+    level_list list;
+    for (auto& o : orders)
+        list.push_front(o);
+    EXPECT_EQ(list.size(), 3);
+    EXPECT_EQ(ids(list), (std::vector<int>{ 3, 2, 1 }));
+    EXPECT_EQ(&list.front(), &orders[2]);
+
+    list.pop_front();
+    EXPECT_EQ(ids(list), (std::vector<int>{ 2, 1 }));
+    EXPECT_EQ(orders[2].id, 3);
+}
+
+TEST(IntrusiveForwardListTest, InsertAndEraseAfterTest)
+{
+    std::vector<order> orders{ { 1 }, { 2 }, { 3 }, { 4 } };
+    level_list list;
+    auto it = list.insert_after(list.before_begin(), orders[0]);
+    it = list.insert_after(it, orders[1]);
+    list.insert_after(it, orders[3]);
+    list.insert_after(it, orders[2]);
+    EXPECT_EQ(ids(list), (std::vector<int>{ 1, 2, 3, 4 }));
+
+    it = list.erase_after(list.iterator_to(orders[1]));
+    EXPECT_EQ(it->id, 4);
+    EXPECT_EQ(ids(list), (std::vector<int>{ 1, 2, 4 }));
+
+    it = list.erase_after(list.before_begin(), list.iterator_to(orders[3]));
+    EXPECT_EQ(it->id, 4);
+    EXPECT_EQ(ids(list), (std::vector<int>{ 4 }));
+    EXPECT_EQ(list.size(), 1);
+}
+
+TEST(IntrusiveForwardListTest, SpliceAfterTest)
+{
+    std::vector<order> orders{ { 1 }, { 2 }, { 3 }, { 4 }, { 5 } };
+    level_list bid;
+    level_list ask;
+    for (int i = 2; i >= 0; --i)
+        bid.push_front(orders[i]);
+    ask.push_front(orders[4]);
+    ask.push_front(orders[3]);
+
+    // Move a single order from one level to the other
+    ask.splice_after(ask.before_begin(), bid, bid.iterator_to(orders[0]));
+    EXPECT_EQ(ids(bid), (std::vector<int>{ 1, 3 }));
+    EXPECT_EQ(ids(ask), (std::vector<int>{ 2, 4, 5 }));
+    EXPECT_EQ(bid.size(), 2);
+    EXPECT_EQ(ask.size(), 3);
+
+    // Within the same list
+    ask.splice_after(ask.iterator_to(orders[4]), ask, ask.before_begin());
+    EXPECT_EQ(ids(ask), (std::vector<int>{ 4, 5, 2 }));
+    ask.splice_after(ask.before_begin(), ask, ask.before_begin());
+    EXPECT_EQ(ids(ask), (std::vector<int>{ 4, 5, 2 }));
+
+    // A whole list
+    bid.splice_after(bid.iterator_to(orders[0]), ask);
+    EXPECT_TRUE(ask.empty());
+    EXPECT_EQ(ids(bid), (std::vector<int>{ 1, 4, 5, 2, 3 }));
+    EXPECT_EQ(bid.size(), 5);
+
+    // A range
+    ask.splice_after(ask.before_begin(), bid, bid.begin(), bid.iterator_to(orders[2]));
+    EXPECT_EQ(ids(ask), (std::vector<int>{ 4, 5, 2 }));
+    EXPECT_EQ(ids(bid), (std::vector<int>{ 1, 3 }));
+    EXPECT_EQ(ask.size(), 3);
+    EXPECT_EQ(bid.size(), 2);
+}
+
+TEST(IntrusiveForwardListTest, MultipleHooksTest)
+{
+    std::vector<order> orders{ { 1 }, { 2 }, { 3 } };
+    level_list level;
+    trader_list trader;
+    for (auto& o : orders) {
+        level.push_front(o);
+        if (o.id != 2)
+            trader.push_front(o);
+    }
+    EXPECT_EQ(ids(level), (std::vector<int>{ 3, 2, 1 }));
+    EXPECT_EQ(ids(trader), (std::vector<int>{ 3, 1 }));
+
+    trader.pop_front();
+    EXPECT_EQ(ids(level), (std::vector<int>{ 3, 2, 1 }));
+    EXPECT_EQ(ids(trader), (std::vector<int>{ 1 }));
+}
+
+TEST(IntrusiveForwardListTest, MoveAndClearTest)
+{
+    std::vector<order> orders{ { 1 }, { 2 } };
+    level_list list;
+    list.push_front(orders[1]);
+    list.push_front(orders[0]);
+
+    level_list moved(std::move(list));
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(ids(moved), (std::vector<int>{ 1, 2 }));
+
+    list = std::move(moved);
+    EXPECT_EQ(ids(list), (std::vector<int>{ 1, 2 }));
+
+    list.clear();
+    EXPECT_TRUE(list.empty());
+    list.push_front(orders[1]);
+    EXPECT_EQ(ids(list), (std::vector<int>{ 2 }));
+
+    level_list::const_iterator it = list.begin();
+    EXPECT_EQ(it->id, 2);
+}
@@ -0,0 +1,141 @@
+#include "mmap_vector.h"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+// Start-up cost of loading a file of historical prices and scanning it once.
+//
+// Warm start: the file is in the page cache.
+// Cold start: the file's pages are evicted from the page cache before every
+// iteration with posix_fadvise(POSIX_FADV_DONTNEED). This does not need root,
+// but the kernel may still keep some pages, so it is an approximation of a
+// freshly booted machine.
+
+static constexpr std::size_t num_prices = std::size_t{ 1 } << 24; // 128 MB of doubles
+
+static const std::filesystem::path& prices_file()
+{
+    static const std::filesystem::path path = [] {
+        auto p = std::filesystem::temp_directory_path() /
+                 ("mmap_vector_benchmark_" + std::to_string(::getpid()) + ".bin");
+        dev::mmap_vector<double> prices(p);
+        prices.reserve(num_prices);
+        for (std::size_t i = 0; i < num_prices; ++i)
+            prices.push_back(100.0 + static_cast<double>(i % 1000) * 0.01);
+        return p;
+    }();
+    return path;
+}
+
+static void evict_from_page_cache(const std::filesystem::path& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    ::fdatasync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+template<typename Container>
+static double scan(const Container& prices)
+{
+    double total = 0.0;
+    for (std::size_t i = 0; i < prices.size(); ++i)
+        total += prices[i];
+    return total;
+}
+
+// The current approach: read and copy element by element
+static dev::vector<double> load_elementwise(const std::filesystem::path& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    dev::vector<double> prices;
+    double price;
+    while (in.read(reinterpret_cast<char*>(&price), sizeof(price)))
+        prices.push_back(price);
+    return prices;
+}
+
+// A single bulk read into an uninitialized dev::vector buffer
+static dev::vector<double> load_bulk(const std::filesystem::path& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    dev::vector<double> prices;
+    prices.resize_for_overwrite(std::filesystem::file_size(path) / sizeof(double));
+    in.read(reinterpret_cast<char*>(prices.data()), prices.size() * sizeof(double));
+    return prices;
+}
+
+template<bool Cold>
+static void bench_vector_load_elementwise(benchmark::State& state)
+{
+    const auto& path = prices_file();
+    for (auto _ : state) {
+        if constexpr (Cold) {
+            state.PauseTiming();
+            evict_from_page_cache(path);
+            state.ResumeTiming();
+        }
+        auto prices = load_elementwise(path);
+        benchmark::DoNotOptimize(scan(prices));
+    }
+    state.SetBytesProcessed(state.iterations() * num_prices * sizeof(double));
+}
+BENCHMARK(bench_vector_load_elementwise<false>)->Unit(benchmark::kMillisecond);
+BENCHMARK(bench_vector_load_elementwise<true>)->Unit(benchmark::kMillisecond);
+
+template<bool Cold>
+static void bench_vector_load_bulk(benchmark::State& state)
+{
+    const auto& path = prices_file();
+    for (auto _ : state) {
+        if constexpr (Cold) {
+            state.PauseTiming();
+            evict_from_page_cache(path);
+            state.ResumeTiming();
+        }
+        auto prices = load_bulk(path);
+        benchmark::DoNotOptimize(scan(prices));
+    }
+    state.SetBytesProcessed(state.iterations() * num_prices * sizeof(double));
+}
+BENCHMARK(bench_vector_load_bulk<false>)->Unit(benchmark::kMillisecond);
+BENCHMARK(bench_vector_load_bulk<true>)->Unit(benchmark::kMillisecond);
+
+// Arg: 0 = lazy mapping, 1 = MAP_POPULATE, 2 = MADV_SEQUENTIAL
+template<bool Cold>
+static void bench_mmap_vector_open(benchmark::State& state)
+{
+    using options = dev::mmap_vector<double>::options;
+    options opts{ .mode = dev::mmap_vector<double>::open_mode::read_only,
+                  .advice = state.range(0) == 2
+                              ? dev::mmap_vector<double>::access_advice::sequential
+                              : dev::mmap_vector<double>::access_advice::normal,
+                  .populate = state.range(0) == 1 };
+
+    const auto& path = prices_file();
+    for (auto _ : state) {
+        if constexpr (Cold) {
+            state.PauseTiming();
+            evict_from_page_cache(path);
+            state.ResumeTiming();
+        }
+        dev::mmap_vector<double> prices(path, opts);
+        benchmark::DoNotOptimize(scan(prices));
+    }
+    state.SetBytesProcessed(state.iterations() * num_prices * sizeof(double));
+}
+BENCHMARK(bench_mmap_vector_open<false>)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+BENCHMARK(bench_mmap_vector_open<true>)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    std::filesystem::remove(prices_file());
+    return 0;
+}
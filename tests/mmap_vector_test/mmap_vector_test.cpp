@@ -0,0 +1,163 @@
+#include "mmap_vector.h"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <unistd.h>
+
+struct Tick
+{
+    double price;
+    long qty;
+    long ts;
+};
+
+class MmapVectorTest : public ::testing::Test
+{
+  protected:
+    std::filesystem::path m_path;
+
+    void SetUp() override
+    {
+        m_path = std::filesystem::temp_directory_path() /
+                 ("mmap_vector_test_" + std::to_string(::getpid()) + "_" +
+                  ::testing::UnitTest::GetInstance()->current_test_info()->name());
+        std::filesystem::remove(m_path);
+    }
+
+    void TearDown() override { std::filesystem::remove(m_path); }
+};
+
+TEST_F(MmapVectorTest, CreateAndReopenTest)
+{
+    {
+        dev::mmap_vector<Tick> ticks(m_path);
+        EXPECT_EQ(ticks.empty(), true);
+        for (long i = 0; i < 10000; ++i)
+            ticks.push_back(Tick{ 100.0 + i, i, 1000 * i });
+        EXPECT_EQ(ticks.size(), 10000);
+        EXPECT_GE(ticks.capacity(), 10000);
+        ticks.sync();
+    }
+
+    // The file is trimmed to exactly size() elements on close
+    EXPECT_EQ(std::filesystem::file_size(m_path), 10000 * sizeof(Tick));
+
+    dev::mmap_vector<Tick> ticks(m_path);
+    EXPECT_EQ(ticks.size(), 10000);
+    EXPECT_EQ(ticks.capacity(), 10000);
+    EXPECT_EQ(ticks[0].price, 100.0);
+    EXPECT_EQ(ticks.back().ts, 9999 * 1000);
+    long i = 0;
+    for (const auto& tick : ticks)
+        EXPECT_EQ(tick.qty, i++);
+}
+
+TEST_F(MmapVectorTest, ReadOnlyTest)
+{
+    {
+        dev::mmap_vector<int> v(m_path);
+        for (int i = 0; i < 100; ++i)
+            v.push_back(i);
+    }
+
+    dev::mmap_vector<int> v(m_path,
+                            { .mode = dev::mmap_vector<int>::open_mode::read_only,
+                              .advice = dev::mmap_vector<int>::access_advice::sequential,
+                              .populate = true });
+    EXPECT_EQ(v.size(), 100);
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0), 4950);
+    EXPECT_EQ(v.at(99), 99);
+    EXPECT_THROW(v.at(100), std::out_of_range);
+    EXPECT_THROW(v.push_back(1), std::logic_error);
+    EXPECT_THROW(v.resize(10), std::logic_error);
+}
+
+TEST_F(MmapVectorTest, OpenErrorsTest)
+{
+    using options = dev::mmap_vector<int>::options;
+    using open_mode = dev::mmap_vector<int>::open_mode;
+
+    // Read-only open of a file that does not exist
+    EXPECT_THROW(dev::mmap_vector<int>(m_path, options{ .mode = open_mode::read_only }),
+                 std::system_error);
+
+    {
+        std::ofstream out(m_path, std::ios::binary);
+        out << "abcde"; // not a multiple of sizeof(int)
+    }
+    EXPECT_THROW(dev::mmap_vector<int>{ m_path }, std::invalid_argument);
+}
+
+TEST_F(MmapVectorTest, ResizeAndAppendRangeTest)
+{
+    dev::mmap_vector<long> v(m_path);
+    v.resize(3);
+    EXPECT_EQ(v.size(), 3);
+    EXPECT_EQ(v[2], 0);
+
+    std::vector<long> source(5000);
+    std::iota(source.begin(), source.end(), 1);
+    v.append_range(source);
+    EXPECT_EQ(v.size(), 5003);
+    EXPECT_EQ(v[3], 1);
+    EXPECT_EQ(v.back(), 5000);
+
+    // Shrinking and growing again zero-fills
+    v.resize(4);
+    v.resize(6);
+    EXPECT_EQ(v[3], 1);
+    EXPECT_EQ(v[4], 0);
+    EXPECT_EQ(v[5], 0);
+
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 6);
+    EXPECT_EQ(std::filesystem::file_size(m_path), 6 * sizeof(long));
+
+    v.pop_back();
+    EXPECT_EQ(v.size(), 5);
+
+    dev::vector<long> copy = v.to_vector();
+    EXPECT_EQ(copy.size(), 5);
+    EXPECT_EQ(copy[3], 1);
+}
+
+TEST_F(MmapVectorTest, PushBackOwnElementTest)
+{
+    // push_back of an element of the mapping itself across a remap
+    dev::mmap_vector<int> v(m_path);
+    v.push_back(42);
+    while (v.size() < 5000)
+        v.push_back(v.back());
+    EXPECT_EQ(v.front(), 42);
+    EXPECT_EQ(v.back(), 42);
+}
+
+TEST_F(MmapVectorTest, MoveTest)
+{
+    dev::mmap_vector<int> v(m_path);
+    v.push_back(7);
+    dev::mmap_vector<int> w(std::move(v));
+    EXPECT_EQ(v.is_open(), false);
+    EXPECT_EQ(w.size(), 1);
+    EXPECT_EQ(w[0], 7);
+
+    dev::mmap_vector<int> u;
+    u = std::move(w);
+    EXPECT_EQ(u[0], 7);
+    EXPECT_EQ(u.is_open(), true);
+}
+
+#if DEV_HARDENED
+using MmapVectorDeathTest = MmapVectorTest;
+
+TEST_F(MmapVectorDeathTest, HardenedPreconditionsTest)
+{
+    dev::mmap_vector<int> v(m_path);
+    v.push_back(1);
+    EXPECT_DEATH(v[1], "mmap_vector index out of bounds");
+    v.pop_back();
+    EXPECT_DEATH(v.back(), "mmap_vector index out of bounds");
+    EXPECT_DEATH(v.pop_back(), "pop_back\\(\\) called on an empty mmap_vector");
+}
+#endif
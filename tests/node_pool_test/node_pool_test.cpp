@@ -0,0 +1,98 @@
+#include "node_pool.h"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST(NodePoolTest, BlockSizeAndAlignmentTest)
+{
+    using small_pool = dev::node_pool<1, 1>;
+    EXPECT_GE(small_pool::block_size, sizeof(void*));
+    EXPECT_EQ(small_pool::block_size % small_pool::block_align, 0);
+
+    using aligned_pool = dev::node_pool<40, 32>;
+    EXPECT_EQ(aligned_pool::block_size, 64);
+    std::vector<void*> blocks;
+    for (int i = 0; i < 200; ++i) {
+        blocks.push_back(aligned_pool::allocate());
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(blocks.back()) % 32, 0);
+    }
+    EXPECT_EQ(std::set<void*>(blocks.begin(), blocks.end()).size(), blocks.size());
+    for (void* p : blocks)
+        aligned_pool::deallocate(p);
+}
+
+TEST(NodePoolTest, ReuseTest)
+{
+    using pool = dev::node_pool<24, 8>;
+    void* p = pool::allocate();
+    auto free_count = pool::local_free_count();
+    pool::deallocate(p);
+    EXPECT_EQ(pool::local_free_count(), free_count + 1);
+    EXPECT_EQ(pool::allocate(), p);
+    EXPECT_EQ(pool::local_free_count(), free_count);
+    pool::deallocate(p);
+}
+
+TEST(NodePoolTest, GiveBackTest)
+{
+    using pool = dev::node_pool<48, 8>;
+    std::vector<void*> blocks;
+    for (std::size_t i = 0; i < 3 * pool::max_local_blocks; ++i)
+        blocks.push_back(pool::allocate());
+    for (void* p : blocks)
+        pool::deallocate(p);
+    // The local free list never grows past its bound
+    EXPECT_LE(pool::local_free_count(), pool::max_local_blocks);
+
+    // Another thread takes the blocks handed back before allocating a new slab
+    std::vector<void*> other_blocks;
+    std::thread([&other_blocks] {
+        for (int i = 0; i < 100; ++i)
+            other_blocks.push_back(pool::allocate());
+        for (void* p : other_blocks)
+            pool::deallocate(p);
+    }).join();
+    std::set<void*> known(blocks.begin(), blocks.end());
+    for (void* p : other_blocks)
+        EXPECT_TRUE(known.contains(p));
+}
+
+TEST(NodePoolTest, CrossThreadFreeTest)
+{
+    // Blocks allocated by a producer thread are freed by a consumer thread
+    using pool = dev::node_pool<32, 8>;
+    std::vector<void*> blocks;
+    std::thread producer([&blocks] {
+        for (int i = 0; i < 10000; ++i)
+            blocks.push_back(pool::allocate());
+    });
+    producer.join();
+    std::thread consumer([&blocks] {
+        for (void* p : blocks)
+            pool::deallocate(p);
+    });
+    consumer.join();
+
+    // Both threads have exited and handed their free lists back
+    void* p = pool::allocate();
+    EXPECT_TRUE(std::set<void*>(blocks.begin(), blocks.end()).contains(p));
+    pool::deallocate(p);
+}
+
+TEST(NodePoolTest, PoolAllocatorTest)
+{
+    dev::pool_allocator<double> alloc;
+    double* p = alloc.allocate(1);
+    *p = 1.5;
+    alloc.deallocate(p, 1);
+
+    double* array = alloc.allocate(16);
+    for (int i = 0; i < 16; ++i)
+        array[i] = i;
+    alloc.deallocate(array, 16);
+
+    dev::pool_allocator<int> rebound(alloc);
+    EXPECT_TRUE(rebound == dev::pool_allocator<int>());
+}
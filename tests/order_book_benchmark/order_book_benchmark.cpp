@@ -0,0 +1,247 @@
+#include "order_book.h"
+#include "vector/vector.h"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+// Replays a synthetic ITCH-like message file through dev::order_book. The
+// file holds fixed-size binary records: adds, most of them near the touch and
+// some of them marketable, partial cancels, deletes, replaces and market
+// orders, over a mid price that follows a random walk. It is generated once,
+// written to the temporary directory and read back, then replayed into a
+// fresh book every iteration.
+
+/**
+ * @brief A message of the feed. 'A' adds, 'X' cancels %quantity shares,
+ * 'D' deletes, 'U' moves the order to %price with %quantity shares, and 'E'
+ * sends a market order of %quantity shares.
+ */
+struct message
+{
+    char type;
+    std::uint8_t buy;
+    std::uint16_t padding;
+    std::uint32_t quantity;
+    std::uint64_t id;
+    std::int64_t price;
+};
+
+static_assert(sizeof(message) == 24);
+
+constexpr std::size_t message_count = 1'000'000;
+constexpr std::int64_t min_price = 0;
+constexpr std::int64_t max_price = 20'000;
+
+static dev::vector<message> generate_messages()
+{
+    struct live_order
+    {
+        std::uint64_t id;
+        std::int64_t price;
+        bool buy;
+    };
+
+    std::mt19937_64 rng(2024);
+    dev::vector<message> messages;
+    messages.reserve(message_count);
+    dev::vector<live_order> live;
+    std::int64_t mid = (min_price + max_price) / 2;
+    std::uint64_t next_id = 1;
+
+    auto pick_live = [&] {
+        // Swap-removes a random live order, as the feed forgets it
+        std::size_t i = rng() % live.size();
+        live_order o = live[i];
+        live[i] = live.back();
+        live.pop_back();
+        return o;
+    };
+
+    while (messages.size() < message_count) {
+        if (rng() % 64 == 0)
+            mid = std::clamp<std::int64_t>(
+              mid + static_cast<std::int64_t>(rng() % 3) - 1, 1'000, max_price - 1'000);
+        const auto r = rng() % 100;
+        if (r < 45 || live.size() < 1'000) {
+            const bool buy = rng() % 2;
+            // Offsets are mostly small; one add in twenty crosses the spread
+            const std::int64_t offset =
+              static_cast<std::int64_t>(std::countr_zero(rng() | (1ull << 20)));
+            const std::int64_t marketable = rng() % 20 == 0 ? 2 : -1;
+            const std::int64_t price =
+              buy ? mid + marketable - offset : mid - marketable + offset;
+            messages.push_back(message{
+              'A', buy, 0, static_cast<std::uint32_t>(1 + rng() % 500), next_id, price });
+            live.push_back(live_order{ next_id++, price, buy });
+        } else if (r < 80) {
+            live_order o = pick_live();
+            messages.push_back(message{ 'D', o.buy, 0, 0, o.id, o.price });
+        } else if (r < 88) {
+            const live_order& o = live[rng() % live.size()];
+            messages.push_back(message{ 'X',
+                                        o.buy,
+                                        0,
+                                        static_cast<std::uint32_t>(1 + rng() % 100),
+                                        o.id,
+                                        o.price });
+        } else if (r < 97) {
+            live_order& o = live[rng() % live.size()];
+            o.price += o.buy ? -1 : 1;
+            messages.push_back(message{ 'U',
+                                        o.buy,
+                                        0,
+                                        static_cast<std::uint32_t>(1 + rng() % 500),
+                                        o.id,
+                                        o.price });
+        } else {
+            messages.push_back(message{ 'E',
+                                        static_cast<std::uint8_t>(rng() % 2),
+                                        0,
+                                        static_cast<std::uint32_t>(1 + rng() % 1'000),
+                                        0,
+                                        0 });
+        }
+    }
+    return messages;
+}
+
+static const dev::vector<message>& replay_file()
+{
+    static const dev::vector<message> messages = [] {
+        const auto path =
+          std::filesystem::temp_directory_path() / "order_book_replay.bin";
+        {
+            dev::vector<message> generated = generate_messages();
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(generated.data()),
+                      static_cast<std::streamsize>(generated.size() * sizeof(message)));
+            if (!out)
+                throw std::runtime_error("Cannot write the replay file!");
+        }
+        dev::vector<message> read;
+        read.resize(std::filesystem::file_size(path) / sizeof(message));
+        std::ifstream in(path, std::ios::binary);
+        in.read(reinterpret_cast<char*>(read.data()),
+                static_cast<std::streamsize>(read.size() * sizeof(message)));
+        if (!in)
+            throw std::runtime_error("Cannot read the replay file!");
+        std::filesystem::remove(path);
+        return read;
+    }();
+    return messages;
+}
+
+/**
+ * @brief Counts the shares traded, so that matching is not optimized away.
+ */
+struct volume_counter
+{
+    std::uint64_t* volume;
+
+    void operator()(const dev::order_book::trade& t) const noexcept
+    {
+        *volume += t.quantity;
+    }
+};
+
+static void apply(dev::order_book& book, const message& m, std::uint64_t& volume)
+{
+    using side = dev::order_book::side;
+    const side s = m.buy ? side::buy : side::sell;
+    switch (m.type) {
+        case 'A':
+            book.add(m.id, s, m.price, m.quantity, volume_counter{ &volume });
+            break;
+        case 'X': {
+            // Orders filled or cancelled meanwhile are unknown to the book
+            const auto quantity = book.quantity_of(m.id);
+            if (quantity != 0)
+                book.modify(
+                  m.id, m.price, quantity > m.quantity ? quantity - m.quantity : 0);
+            break;
+        }
+        case 'D':
+            book.cancel(m.id);
+            break;
+        case 'U':
+            book.modify(m.id, m.price, m.quantity, volume_counter{ &volume });
+            break;
+        case 'E':
+            book.match(0, s, m.quantity, volume_counter{ &volume });
+            break;
+    }
+}
+
+static void bench_replay(benchmark::State& state)
+{
+    const auto& messages = replay_file();
+    std::uint64_t volume = 0;
+    for (auto _ : state) {
+        dev::order_book book(min_price, max_price);
+        for (const message& m : messages)
+            apply(book, m, volume);
+        benchmark::DoNotOptimize(volume);
+    }
+    state.SetItemsProcessed(
+      static_cast<std::int64_t>(state.iterations() * messages.size()));
+    state.counters["msgs_per_second"] =
+      benchmark::Counter(static_cast<double>(state.iterations() * messages.size()),
+                         benchmark::Counter::kIsRate);
+}
+
+/**
+ * @brief Times every message on its own. The two clock reads add their cost
+ * (some tens of nanoseconds) to every sample, so the percentiles are upper
+ * bounds, and the throughput is lower than in bench_replay.
+ */
+static void bench_replay_latency(benchmark::State& state)
+{
+    using clock = std::chrono::steady_clock;
+    const auto& messages = replay_file();
+    dev::vector<std::int64_t> latencies;
+    latencies.reserve(messages.size());
+    dev::vector<std::int64_t> all;
+    std::uint64_t volume = 0;
+    for (auto _ : state) {
+        dev::order_book book(min_price, max_price);
+        latencies.clear();
+        for (const message& m : messages) {
+            const auto start = clock::now();
+            apply(book, m, volume);
+            const auto stop = clock::now();
+            latencies.push_back(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+        }
+        benchmark::DoNotOptimize(volume);
+        state.PauseTiming();
+        for (auto latency : latencies)
+            all.push_back(latency);
+        state.ResumeTiming();
+    }
+
+    auto percentile = [&all](double p) {
+        const auto n = static_cast<double>(all.size() - 1);
+        auto nth = all.begin() + static_cast<std::ptrdiff_t>(p * n);
+        std::nth_element(all.begin(), nth, all.end());
+        return static_cast<double>(*nth);
+    };
+    state.SetItemsProcessed(
+      static_cast<std::int64_t>(state.iterations() * messages.size()));
+    state.counters["p50_ns"] = percentile(0.50);
+    state.counters["p90_ns"] = percentile(0.90);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p99.9_ns"] = percentile(0.999);
+    state.counters["max_ns"] =
+      static_cast<double>(*std::max_element(all.begin(), all.end()));
+}
+
+BENCHMARK(bench_replay)->Unit(benchmark::kMillisecond);
+BENCHMARK(bench_replay_latency)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,200 @@
+#include "order_book.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using side = dev::order_book::side;
+using trade = dev::order_book::trade;
+
+/**
+ * @brief Records the trades reported by the book.
+ */
+struct trade_log
+{
+    std::vector<trade>* trades;
+
+    void operator()(const trade& t) const { trades->push_back(t); }
+};
+
+TEST(OrderBookTest, EmptyBookTest)
+{
+    dev::order_book book(100, 200);
+    EXPECT_EQ(book.order_count(), 0);
+    EXPECT_FALSE(book.best_bid().has_value());
+    EXPECT_FALSE(book.best_ask().has_value());
+    EXPECT_FALSE(book.cancel(1));
+    EXPECT_FALSE(book.modify(1, 150, 10));
+    EXPECT_EQ(book.match(1, side::buy, 10), 0);
+    EXPECT_EQ(book.min_price(), 100);
+    EXPECT_EQ(book.max_price(), 200);
+    EXPECT_THROW(dev::order_book(200, 100), std::invalid_argument);
+}
+
+TEST(OrderBookTest, RestingOrdersTest)
+{
+    dev::order_book book(100, 200);
+    EXPECT_TRUE(book.add(1, side::buy, 149, 10));
+    EXPECT_TRUE(book.add(2, side::buy, 150, 20));
+    EXPECT_TRUE(book.add(3, side::sell, 152, 5));
+    EXPECT_TRUE(book.add(4, side::sell, 152, 7));
+    EXPECT_FALSE(book.add(4, side::sell, 160, 1));
+    EXPECT_THROW(book.add(5, side::sell, 201, 1), std::out_of_range);
+
+    EXPECT_EQ(book.order_count(), 4);
+    EXPECT_EQ(book.best_bid(), 150);
+    EXPECT_EQ(book.best_ask(), 152);
+    EXPECT_EQ(book.volume_at(side::buy, 150), 20);
+    EXPECT_EQ(book.volume_at(side::sell, 152), 12);
+    EXPECT_EQ(book.quantity_of(4), 7);
+}
+
+TEST(OrderBookTest, PriceTimePriorityTest)
+{
+    dev::order_book book(100, 200);
+    book.add(1, side::sell, 151, 5);
+    book.add(2, side::sell, 150, 5);
+    book.add(3, side::sell, 150, 5);
+    book.add(4, side::sell, 152, 5);
+
+    // Crosses 150 and 151, and rests the rest at 151
+    std::vector<trade> trades;
+    EXPECT_TRUE(book.add(10, side::buy, 151, 17, trade_log{ &trades }));
+    EXPECT_EQ(trades, (std::vector<trade>{ { 2, 10, 150, 5 }, { 3, 10, 150, 5 }, { 1, 10, 151, 5 } }));
+    EXPECT_EQ(book.best_bid(), 151);
+    EXPECT_EQ(book.quantity_of(10), 2);
+    EXPECT_EQ(book.best_ask(), 152);
+    EXPECT_EQ(book.order_count(), 2);
+}
+
+TEST(OrderBookTest, PartialFillKeepsPriorityTest)
+{
+    dev::order_book book(100, 200);
+    book.add(1, side::buy, 150, 10);
+    book.add(2, side::buy, 150, 10);
+
+    std::vector<trade> trades;
+    EXPECT_EQ(book.match(20, side::sell, 4, trade_log{ &trades }), 4);
+    EXPECT_EQ(book.match(21, side::sell, 8, trade_log{ &trades }), 8);
+    EXPECT_EQ(trades, (std::vector<trade>{ { 1, 20, 150, 4 }, { 1, 21, 150, 6 }, { 2, 21, 150, 2 } }));
+    EXPECT_FALSE(book.contains(1));
+    EXPECT_EQ(book.quantity_of(2), 8);
+
+    // A market order only executes what the book holds
+    EXPECT_EQ(book.match(22, side::sell, 100), 8);
+    EXPECT_FALSE(book.best_bid().has_value());
+}
+
+TEST(OrderBookTest, CancelTest)
+{
+    dev::order_book book(100, 200);
+    for (dev::order_book::id_type id = 1; id <= 6; ++id)
+        book.add(id, side::sell, 150 + static_cast<int>(id % 2), 10);
+
+    EXPECT_TRUE(book.cancel(3));
+    EXPECT_FALSE(book.cancel(3));
+    EXPECT_TRUE(book.cancel(2));
+    EXPECT_EQ(book.volume_at(side::sell, 151), 20);
+    EXPECT_EQ(book.volume_at(side::sell, 150), 20);
+    EXPECT_EQ(book.order_count(), 4);
+
+    // Cancelled orders are skipped by matching
+    std::vector<trade> trades;
+    book.match(7, side::buy, 25, trade_log{ &trades });
+    EXPECT_EQ(trades, (std::vector<trade>{ { 4, 7, 150, 10 }, { 6, 7, 150, 10 }, { 1, 7, 151, 5 } }));
+
+    // Emptying the best level moves the best price
+    EXPECT_TRUE(book.cancel(1));
+    EXPECT_TRUE(book.cancel(5));
+    EXPECT_FALSE(book.best_ask().has_value());
+
+    // Ids are free again once their order is gone
+    EXPECT_TRUE(book.add(1, side::buy, 120, 1));
+}
+
+TEST(OrderBookTest, ModifyTest)
+{
+    dev::order_book book(100, 200);
+    book.add(1, side::buy, 150, 10);
+    book.add(2, side::buy, 150, 10);
+    book.add(3, side::sell, 155, 10);
+
+    // Reducing keeps the priority of order 1
+    EXPECT_TRUE(book.modify(1, 150, 6));
+    EXPECT_EQ(book.volume_at(side::buy, 150), 16);
+    std::vector<trade> trades;
+    book.match(10, side::sell, 1, trade_log{ &trades });
+    EXPECT_EQ(trades.back().maker_id, 1);
+
+    // Increasing sends order 1 behind order 2
+    EXPECT_TRUE(book.modify(1, 150, 8));
+    book.match(11, side::sell, 1, trade_log{ &trades });
+    EXPECT_EQ(trades.back().maker_id, 2);
+
+    // Repricing through the spread matches
+    trades.clear();
+    EXPECT_TRUE(book.modify(1, 156, 8, trade_log{ &trades }));
+    EXPECT_EQ(trades, (std::vector<trade>{ { 3, 1, 155, 8 } }));
+    EXPECT_EQ(book.quantity_of(3), 2);
+    EXPECT_EQ(book.best_bid(), 150);
+
+    // A zero quantity cancels
+    EXPECT_TRUE(book.modify(2, 150, 0));
+    EXPECT_FALSE(book.contains(2));
+    EXPECT_FALSE(book.best_bid().has_value());
+}
+
+TEST(OrderBookTest, RandomOperationsTest)
+{
+    // Compares the book with a naive model: resting orders per price, in
+    // arrival order, without matching, since the prices of both sides never
+    // cross.
+    dev::order_book book(0, 63);
+    std::map<dev::order_book::id_type, std::pair<int, std::uint64_t>> model;
+    std::mt19937 rng(7);
+    dev::order_book::id_type next_id = 1;
+    for (int i = 0; i < 20000; ++i) {
+        int op = static_cast<int>(rng() % 4);
+        if (op < 2 || model.empty()) {
+            bool buy = rng() % 2;
+            int price = buy ? static_cast<int>(rng() % 32) : 32 + static_cast<int>(rng() % 32);
+            std::uint64_t quantity = 1 + rng() % 100;
+            ASSERT_TRUE(book.add(next_id, buy ? side::buy : side::sell, price, quantity));
+            model[next_id++] = { price, quantity };
+        } else {
+            auto it = model.begin();
+            std::advance(it, rng() % model.size());
+            if (op == 2) {
+                ASSERT_TRUE(book.cancel(it->first));
+                model.erase(it);
+            } else {
+                std::uint64_t quantity = rng() % (it->second.second + 1);
+                ASSERT_TRUE(book.modify(it->first, it->second.first, quantity));
+                if (quantity == 0)
+                    model.erase(it);
+                else
+                    it->second.second = quantity;
+            }
+        }
+    }
+
+    ASSERT_EQ(book.order_count(), model.size());
+    std::uint64_t volumes[64] = {};
+    int best_bid = -1;
+    int best_ask = 64;
+    for (const auto& [id, entry] : model) {
+        ASSERT_EQ(book.quantity_of(id), entry.second);
+        volumes[entry.first] += entry.second;
+        if (entry.first < 32)
+            best_bid = std::max(best_bid, entry.first);
+        else
+            best_ask = std::min(best_ask, entry.first);
+    }
+    for (int price = 0; price < 64; ++price)
+        ASSERT_EQ(book.volume_at(price < 32 ? side::buy : side::sell, price), volumes[price]);
+    EXPECT_EQ(book.best_bid().value_or(-1), best_bid);
+    EXPECT_EQ(book.best_ask().value_or(64), best_ask);
+}
@@ -0,0 +1,26 @@
+#include "../common/push_back_latency.h"
+#include "segmented_vector.h"
+#include "vector.h"
+#include <benchmark/benchmark.h>
+
+// Tail latency of push_back. Average throughput hides the reallocations of
+// dev::vector: each one copies the whole array, and that single push_back is
+// the one that stalls the book. dev::segmented_vector never moves an element,
+// so its worst push_back is one segment allocation.
+
+BENCHMARK(bench_push_back_latency<dev::vector<Quote>>)
+  ->RangeMultiplier(16)
+  ->Range(1 << 16, 1 << 22)
+  ->Iterations(3)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(bench_push_back_latency<dev::segmented_vector<Quote>>)
+  ->RangeMultiplier(16)
+  ->Range(1 << 16, 1 << 22)
+  ->Iterations(3)
+  ->Unit(benchmark::kMillisecond);
+
+// The price paid for stable addresses: a bit scan per index.
+BENCHMARK(bench_index_scan<dev::vector<Quote>>)->Range(1 << 10, 1 << 20);
+BENCHMARK(bench_index_scan<dev::segmented_vector<Quote>>)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,160 @@
+#include "segmented_vector.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <numeric>
+#include <string>
+
+TEST(SegmentedVectorTest, DefaultConstructorTest)
+{
+    dev::segmented_vector<int> v;
+    EXPECT_EQ(v.empty(), true);
+    EXPECT_EQ(v.size(), 0);
+    EXPECT_EQ(v.capacity(), 0);
+    EXPECT_EQ(v.segment_count(), 0);
+    EXPECT_EQ(v.begin(), v.end());
+}
+
+TEST(SegmentedVectorTest, SegmentsDoubleInSizeTest)
+{
+    dev::segmented_vector<int, 4> v;
+    v.push_back(0);
+    EXPECT_EQ(v.capacity(), 4);
+    v.resize(5);
+    EXPECT_EQ(v.segment_count(), 2);
+    EXPECT_EQ(v.capacity(), 12);
+    v.resize(13);
+    EXPECT_EQ(v.segment_count(), 3);
+    EXPECT_EQ(v.capacity(), 28);
+
+    // Elements within a segment are contiguous
+    v.resize(28);
+    EXPECT_EQ(v.segment_count(), 3);
+    EXPECT_EQ(&v[5], &v[4] + 1);
+    EXPECT_EQ(&v[27], &v[12] + 15);
+}
+
+TEST(SegmentedVectorTest, IndexingTest)
+{
+    dev::segmented_vector<std::size_t, 2> v;
+    for (std::size_t i = 0; i < 1000; ++i)
+        v.push_back(i);
+
+    EXPECT_EQ(v.size(), 1000);
+    for (std::size_t i = 0; i < v.size(); ++i)
+        ASSERT_EQ(v[i], i);
+    EXPECT_EQ(v.front(), 0);
+    EXPECT_EQ(v.back(), 999);
+    EXPECT_EQ(v.at(500), 500);
+    EXPECT_THROW(v.at(1000), std::out_of_range);
+}
+
+TEST(SegmentedVectorTest, PointersAreStableTest)
+{
+    dev::segmented_vector<std::string> v;
+    v.push_back("first");
+    std::string* first = &v[0];
+    const char* first_chars = v[0].data();
+
+    dev::segmented_vector<std::string>::iterator it = v.begin();
+    for (int i = 0; i < 10000; ++i)
+        v.emplace_back(std::to_string(i));
+
+    EXPECT_EQ(&v[0], first);
+    EXPECT_EQ(v[0].data(), first_chars);
+    EXPECT_EQ(*it, "first");
+    EXPECT_EQ(v[10000], "9999");
+}
+
+TEST(SegmentedVectorTest, IteratorTest)
+{
+    static_assert(std::random_access_iterator<dev::segmented_vector<int>::iterator>);
+    static_assert(std::random_access_iterator<dev::segmented_vector<int>::const_iterator>);
+    static_assert(std::ranges::random_access_range<dev::segmented_vector<int>>);
+
+    dev::segmented_vector<int, 4> v;
+    for (int i = 1; i <= 100; ++i)
+        v.push_back(i);
+
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0), 5050);
+    EXPECT_EQ(v.end() - v.begin(), 100);
+    EXPECT_EQ(*(v.begin() + 50), 51);
+    EXPECT_EQ(v.begin()[99], 100);
+
+    dev::segmented_vector<int, 4>::const_iterator cit = v.begin();
+    EXPECT_EQ(cit, v.cbegin());
+    EXPECT_LT(cit, v.cend());
+
+    std::ranges::reverse(v);
+    EXPECT_EQ(v.front(), 100);
+    EXPECT_EQ(v.back(), 1);
+    EXPECT_EQ(*std::ranges::lower_bound(v, 42, std::greater<>{}), 42);
+}
+
+TEST(SegmentedVectorTest, PopBackAndClearTest)
+{
+    auto counter = std::make_shared<int>(0);
+    dev::segmented_vector<std::shared_ptr<int>, 2> v;
+    for (int i = 0; i < 10; ++i)
+        v.push_back(counter);
+    EXPECT_EQ(counter.use_count(), 11);
+
+    v.pop_back();
+    EXPECT_EQ(counter.use_count(), 10);
+    v.resize(3);
+    EXPECT_EQ(counter.use_count(), 4);
+
+    auto capacity = v.capacity();
+    v.clear();
+    EXPECT_EQ(counter.use_count(), 1);
+    EXPECT_EQ(v.capacity(), capacity);
+
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 0);
+}
+
+TEST(SegmentedVectorTest, CopyAndMoveTest)
+{
+    dev::segmented_vector<std::string, 2> v{ "a", "b", "c", "d", "e" };
+
+    auto copy = v;
+    EXPECT_EQ(copy.size(), 5);
+    EXPECT_EQ(copy[4], "e");
+    EXPECT_NE(&copy[0], &v[0]);
+
+    const std::string* address = &v[0];
+    auto moved = std::move(v);
+    EXPECT_EQ(&moved[0], address);
+    EXPECT_EQ(v.size(), 0);
+    EXPECT_EQ(v.segment_count(), 0);
+
+    v = moved;
+    EXPECT_EQ(v[2], "c");
+    copy = std::move(moved);
+    EXPECT_EQ(&copy[0], address);
+}
+
+TEST(SegmentedVectorTest, ReserveAndShrinkTest)
+{
+    dev::segmented_vector<int, 8> v;
+    v.reserve(100);
+    EXPECT_GE(v.capacity(), 100);
+    EXPECT_EQ(v.size(), 0);
+
+    v.resize(10);
+    EXPECT_EQ(v[9], 0);
+    v.shrink_to_fit();
+    EXPECT_EQ(v.segment_count(), 2);
+    EXPECT_EQ(v.capacity(), 24);
+}
+
+#if DEV_HARDENED
+TEST(SegmentedVectorDeathTest, HardenedPreconditionsTest)
+{
+    dev::segmented_vector<int> v{ 1, 2, 3 };
+    EXPECT_DEATH(v[3], "segmented_vector index out of bounds");
+
+    dev::segmented_vector<int> empty;
+    EXPECT_DEATH(empty.back(), "segmented_vector index out of bounds");
+    EXPECT_DEATH(empty.pop_back(), "pop_back\\(\\) called on an empty segmented_vector");
+}
+#endif
@@ -0,0 +1,201 @@
+#include "../common/allocation_counter.h"
+#include "shared_ptr.h"
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+
+// Copies and destroys pointers that all share one control block, across
+// thread counts: every copy increments the shared count and every destruction
+// decrements it, so the cache line of the count bounces between the cores.
+// dev::shared_ptr, with a relaxed increment and an acq_rel decrement, is
+// compared with the same pointer with sequentially consistent counting, with
+// std::shared_ptr, and, on one thread, with dev::local_shared_ptr.
+//
+// On x86 every atomic read-modify-write is a locked instruction whatever its
+// order, so the orders mostly matter on weakly-ordered targets such as ARM,
+// where a seq_cst RMW needs barriers that a relaxed one does not.
+//
+// Constructing and destroying pointers, empty, owning a new object with the
+// default or a stateful deleter, or from make_shared, is compared with
+// std::shared_ptr. The allocs_per_iter counter shows how many times each
+// iteration reached the global operator new, the managed object included.
+//
+// Making shared market-data buffers of several sizes is compared three ways:
+// make_shared<T[]>, with the elements after the control block, against a
+// shared_ptr<T[]> that adopts a new[] array, and against std::make_shared.
+// The for_overwrite versions skip zeroing the buffer, which is most of the
+// cost of a large one.
+//
+// Locking one weak pointer from every thread is compared with std::weak_ptr:
+// dev::weak_ptr::lock() takes ownership with a compare-and-swap loop, which
+// retries when another thread changed the count in between, and destroying
+// the result decrements the count again.
+
+template<typename F>
+static void bench_construction(benchmark::State& state, F make)
+{
+    const std::uint64_t before = allocation_count();
+    for (auto _ : state) {
+        auto ptr = make();
+        benchmark::DoNotOptimize(ptr);
+    }
+    const std::uint64_t allocations = allocation_count() - before;
+    state.counters["allocs_per_iter"] = benchmark::Counter(
+      static_cast<double>(allocations) / static_cast<double>(state.iterations()));
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief A deleter with state, which std::shared_ptr and dev::shared_ptr both
+ * keep in the control block.
+ */
+struct counting_deleter
+{
+    std::uint64_t* count;
+
+    void operator()(int* p) const noexcept
+    {
+        ++*count;
+        delete p;
+    }
+};
+
+static std::uint64_t g_deleted = 0;
+
+template<template<typename> typename Ptr>
+static void bench_construct_empty(benchmark::State& state)
+{
+    bench_construction(state, [] { return Ptr<int>(); });
+}
+
+template<template<typename> typename Ptr>
+static void bench_construct_raw(benchmark::State& state)
+{
+    bench_construction(state, [] { return Ptr<int>(new int(42)); });
+}
+
+template<template<typename> typename Ptr>
+static void bench_construct_deleter(benchmark::State& state)
+{
+    bench_construction(state, [] { return Ptr<int>(new int(42), counting_deleter{ &g_deleted }); });
+}
+
+static void bench_make_shared_dev(benchmark::State& state)
+{
+    bench_construction(state, [] { return dev::make_shared<int>(42); });
+}
+
+static void bench_make_shared_std(benchmark::State& state)
+{
+    bench_construction(state, [] { return std::make_shared<int>(42); });
+}
+
+template<typename T>
+using dev_shared_ptr = dev::shared_ptr<T>;
+template<typename T>
+using std_shared_ptr = std::shared_ptr<T>;
+
+BENCHMARK(bench_construct_empty<dev_shared_ptr>);
+BENCHMARK(bench_construct_empty<std_shared_ptr>);
+BENCHMARK(bench_construct_raw<dev_shared_ptr>);
+BENCHMARK(bench_construct_raw<std_shared_ptr>);
+BENCHMARK(bench_construct_deleter<dev_shared_ptr>);
+BENCHMARK(bench_construct_deleter<std_shared_ptr>);
+BENCHMARK(bench_make_shared_dev);
+BENCHMARK(bench_make_shared_std);
+
+static void bench_make_shared_array_dev(benchmark::State& state)
+{
+    const auto n = static_cast<std::size_t>(state.range(0));
+    bench_construction(state, [n] { return dev::make_shared<std::uint64_t[]>(n); });
+}
+
+static void bench_adopt_array_dev(benchmark::State& state)
+{
+    const auto n = static_cast<std::size_t>(state.range(0));
+    bench_construction(state, [n] { return dev::shared_ptr<std::uint64_t[]>(new std::uint64_t[n]()); });
+}
+
+static void bench_make_shared_array_std(benchmark::State& state)
+{
+    const auto n = static_cast<std::size_t>(state.range(0));
+    bench_construction(state, [n] { return std::make_shared<std::uint64_t[]>(n); });
+}
+
+static void bench_make_shared_for_overwrite_dev(benchmark::State& state)
+{
+    const auto n = static_cast<std::size_t>(state.range(0));
+    bench_construction(state, [n] { return dev::make_shared_for_overwrite<std::uint64_t[]>(n); });
+}
+
+static void bench_make_shared_for_overwrite_std(benchmark::State& state)
+{
+    const auto n = static_cast<std::size_t>(state.range(0));
+    bench_construction(state, [n] { return std::make_shared_for_overwrite<std::uint64_t[]>(n); });
+}
+
+BENCHMARK(bench_make_shared_array_dev)->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK(bench_adopt_array_dev)->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK(bench_make_shared_array_std)->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK(bench_make_shared_for_overwrite_dev)->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK(bench_make_shared_for_overwrite_std)->RangeMultiplier(16)->Range(16, 1 << 16);
+
+/**
+ * @brief The reference count as it was, sequentially consistent throughout.
+ */
+class seq_cst_ref_count
+{
+  private:
+    std::atomic<unsigned long long> m_count;
+
+  public:
+    explicit seq_cst_ref_count(unsigned long long count) noexcept
+      : m_count{ count }
+    {
+    }
+
+    void increment() noexcept { m_count.fetch_add(1u); }
+    bool decrement() noexcept { return --m_count == 0; }
+    void store(unsigned long long count) noexcept { m_count.store(count); }
+    unsigned long long load() const noexcept { return m_count.load(); }
+};
+
+template<typename Ptr>
+static Ptr& shared_pointer()
+{
+    static Ptr* ptr = new Ptr(new int(42));
+    return *ptr;
+}
+
+template<typename Ptr>
+static void bench_copy_destroy(benchmark::State& state)
+{
+    const Ptr& shared = shared_pointer<Ptr>();
+    for (auto _ : state) {
+        Ptr copy = shared;
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(bench_copy_destroy<dev::shared_ptr<int>>)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(bench_copy_destroy<dev::shared_ptr<int, seq_cst_ref_count>>)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(bench_copy_destroy<std::shared_ptr<int>>)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(bench_copy_destroy<dev::local_shared_ptr<int>>);
+
+template<typename Ptr, typename WeakPtr>
+static void bench_lock(benchmark::State& state)
+{
+    static const WeakPtr weak = shared_pointer<Ptr>();
+    for (auto _ : state) {
+        auto locked = weak.lock();
+        benchmark::DoNotOptimize(locked);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(bench_lock<dev::shared_ptr<int>, dev::weak_ptr<int>>)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(bench_lock<std::shared_ptr<int>, std::weak_ptr<int>>)->ThreadRange(1, 16)->UseRealTime();
+
+BENCHMARK_MAIN();
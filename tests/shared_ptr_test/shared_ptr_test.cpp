@@ -1,7 +1,14 @@
+#include "../common/allocation_counter.h"
 #include "shared_ptr.h"
 #include <atomic>
+#include <cstdint>
 #include <gtest/gtest.h>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <thread>
+#include <vector>
 
 // make_shared<T>(constructor_args) test
 TEST(SharedPtrTest, MakeSharedTest)
@@ -376,4 +383,387 @@ TEST(SharedPtrTest, CustomDeleterTest)
 
         EXPECT_EQ(ptr1.use_count(), 1);
     }
-}
\ No newline at end of file
+}
+TEST(SharedPtrTest, LocalSharedPtrTest)
+{
+    int destroyed = 0;
+    struct X
+    {
+        int* destroyed;
+        ~X() { ++*destroyed; }
+    };
+
+    {
+        dev::local_shared_ptr<X> p1 = dev::make_local_shared<X>(&destroyed);
+        EXPECT_EQ(p1.use_count(), 1);
+        {
+            dev::local_shared_ptr<X> p2 = p1;
+            dev::local_shared_ptr<X> p3(p2);
+            EXPECT_EQ(p1.use_count(), 3);
+            EXPECT_EQ(p3->destroyed, &destroyed);
+        }
+        EXPECT_EQ(p1.use_count(), 1);
+        EXPECT_EQ(destroyed, 0);
+
+        dev::local_shared_ptr<int> p4(new int(7));
+        dev::local_shared_ptr<int> p5 = std::move(p4);
+        EXPECT_EQ(p4.use_count(), 0);
+        EXPECT_EQ(*p5, 7);
+    }
+    EXPECT_EQ(destroyed, 1);
+}
+
+TEST(SharedPtrTest, ConcurrentCopyAndDestroyTest)
+{
+    // Threads copy and drop references to one control block; the object must
+    // be destroyed exactly once, by whichever owner is the last.
+    std::atomic<int> destroyed{ 0 };
+    struct X
+    {
+        std::atomic<int>* destroyed;
+        int value{ 42 };
+        ~X() { ++*destroyed; }
+    };
+
+    constexpr int num_threads = 8;
+    for (int round = 0; round < 20; ++round) {
+        std::vector<std::thread> threads;
+        {
+            dev::shared_ptr<X> ptr = dev::make_shared<X>(&destroyed);
+            for (int t = 0; t < num_threads; ++t) {
+                threads.emplace_back([copy = ptr] {
+                    for (int i = 0; i < 1000; ++i) {
+                        dev::shared_ptr<X> local = copy;
+                        ASSERT_EQ(local->value, 42);
+                    }
+                });
+            }
+        }
+        for (auto& thread : threads)
+            thread.join();
+        ASSERT_EQ(destroyed.load(), round + 1);
+    }
+}
+
+TEST(SharedPtrTest, EmptyPointersDoNotAllocateTest)
+{
+    EXPECT_EQ(count_allocations([] {
+                  dev::shared_ptr<int> p1;
+                  dev::shared_ptr<int> p2(nullptr);
+                  dev::shared_ptr<int[]> p3;
+                  dev::shared_ptr<int> p4 = p1;
+                  EXPECT_EQ(p1.use_count(), 0);
+                  EXPECT_EQ(p4, nullptr);
+              }),
+              0);
+}
+
+TEST(SharedPtrTest, SingleAllocationPerOwnershipTest)
+{
+    int* raw = new int(1);
+    EXPECT_EQ(count_allocations([raw] { dev::shared_ptr<int> p(raw); }), 1);
+
+    int* array = new int[4];
+    EXPECT_EQ(count_allocations([array] { dev::shared_ptr<int[]> p(array); }), 1);
+
+    // A stateful deleter lives in the control block too
+    int deleted = 0;
+    auto deleter = [&deleted](int* p) {
+        ++deleted;
+        delete p;
+    };
+    raw = new int(2);
+    EXPECT_EQ(count_allocations([raw, &deleter] {
+                  dev::shared_ptr<int> p(raw, deleter);
+                  dev::shared_ptr<int> copy = p;
+              }),
+              1);
+    EXPECT_EQ(deleted, 1);
+
+    EXPECT_EQ(count_allocations([] { auto p = dev::make_shared<int>(3); }), 1);
+
+    dev::shared_ptr<int> p(new int(4));
+    EXPECT_EQ(count_allocations([&p] { p.reset(); }), 0);
+    EXPECT_EQ(p, nullptr);
+}
+
+TEST(SharedPtrTest, ResetWithDeleterTest)
+{
+    int deleted = 0;
+    auto deleter = [&deleted](int* p) {
+        ++deleted;
+        delete p;
+    };
+
+    dev::shared_ptr<int> p1(new int(1), deleter);
+    dev::shared_ptr<int> p2 = p1;
+    // Each object keeps the deleter it was handed over with
+    p1.reset(new int(2));
+    EXPECT_EQ(deleted, 0);
+    p2.reset(new int(3), deleter);
+    EXPECT_EQ(deleted, 1);
+    p2.reset();
+    EXPECT_EQ(deleted, 2);
+    EXPECT_EQ(*p1, 2);
+}
+
+TEST(SharedPtrTest, WeakPtrTest)
+{
+    dev::weak_ptr<int> empty;
+    EXPECT_TRUE(empty.expired());
+    EXPECT_EQ(empty.lock(), nullptr);
+    EXPECT_THROW(dev::shared_ptr<int>{ empty }, std::bad_weak_ptr);
+
+    dev::shared_ptr<int> p = dev::make_shared<int>(5);
+    dev::weak_ptr<int> w = p;
+    EXPECT_EQ(w.use_count(), 1);
+    {
+        dev::shared_ptr<int> locked = w.lock();
+        EXPECT_EQ(*locked, 5);
+        EXPECT_EQ(p.use_count(), 2);
+        dev::shared_ptr<int> owner{ w };
+        EXPECT_EQ(p.use_count(), 3);
+    }
+    dev::weak_ptr<int> copy = w;
+    dev::weak_ptr<int> moved = std::move(copy);
+    EXPECT_TRUE(copy.expired());
+    EXPECT_EQ(moved.use_count(), 1);
+
+    p.reset();
+    EXPECT_TRUE(w.expired());
+    EXPECT_TRUE(moved.expired());
+    EXPECT_EQ(w.lock(), nullptr);
+    EXPECT_THROW(dev::shared_ptr<int>{ w }, std::bad_weak_ptr);
+}
+
+TEST(SharedPtrTest, WeakPtrDoesNotKeepObjectAliveTest)
+{
+    // The object is destroyed with its last owner, even when make_shared put
+    // it in the control block that the weak pointers still hold.
+    int destroyed = 0;
+    struct X
+    {
+        int* destroyed;
+        ~X() { ++*destroyed; }
+    };
+
+    dev::weak_ptr<X> w1;
+    dev::weak_ptr<X> w2;
+    {
+        dev::shared_ptr<X> p1 = dev::make_shared<X>(&destroyed);
+        dev::shared_ptr<X> p2(new X{ &destroyed });
+        w1 = p1;
+        w2 = p2;
+    }
+    EXPECT_EQ(destroyed, 2);
+    EXPECT_TRUE(w1.expired());
+    EXPECT_TRUE(w2.expired());
+}
+
+TEST(SharedPtrTest, WeakPtrBreaksCyclesTest)
+{
+    int destroyed = 0;
+    struct child;
+    struct parent
+    {
+        int* destroyed;
+        dev::shared_ptr<child> first_child;
+        ~parent() { ++*destroyed; }
+    };
+    struct child
+    {
+        int* destroyed;
+        dev::weak_ptr<parent> owner;
+        ~child() { ++*destroyed; }
+    };
+
+    {
+        dev::shared_ptr<parent> p = dev::make_shared<parent>(&destroyed);
+        p->first_child = dev::make_shared<child>(&destroyed);
+        p->first_child->owner = p;
+        EXPECT_EQ(p->first_child->owner.lock(), p);
+        EXPECT_EQ(p.use_count(), 1);
+    }
+    EXPECT_EQ(destroyed, 2);
+
+    // A node pointing to itself does not leak either
+    struct node
+    {
+        int* destroyed;
+        dev::weak_ptr<node> self;
+        ~node() { ++*destroyed; }
+    };
+    {
+        dev::shared_ptr<node> n = dev::make_shared<node>(&destroyed);
+        n->self = n;
+    }
+    EXPECT_EQ(destroyed, 3);
+}
+
+TEST(SharedPtrTest, EnableSharedFromThisTest)
+{
+    struct widget : dev::enable_shared_from_this<widget>
+    {
+        int value;
+
+        explicit widget(int value)
+          : value{ value }
+        {
+        }
+    };
+
+    dev::shared_ptr<widget> p = dev::make_shared<widget>(3);
+    dev::shared_ptr<widget> q = p->shared_from_this();
+    EXPECT_EQ(q, p);
+    EXPECT_EQ(p.use_count(), 2);
+    EXPECT_EQ(p->weak_from_this().lock(), p);
+
+    dev::shared_ptr<widget> r(new widget(4));
+    EXPECT_EQ(r->shared_from_this(), r);
+
+    // An object that no shared_ptr owns, or a copy of an owned one, has no
+    // owner to share
+    widget unowned(5);
+    EXPECT_THROW(unowned.shared_from_this(), std::bad_weak_ptr);
+    widget copied = *p;
+    EXPECT_THROW(copied.shared_from_this(), std::bad_weak_ptr);
+
+    dev::weak_ptr<widget> w = p->weak_from_this();
+    p.reset();
+    q.reset();
+    EXPECT_TRUE(w.expired());
+}
+
+TEST(SharedPtrTest, ConcurrentLockAndResetTest)
+{
+    // Threads lock a weak pointer while the owner drops the object; a lock
+    // either fails or yields a live object, which is destroyed exactly once.
+    std::atomic<int> destroyed{ 0 };
+    struct X
+    {
+        std::atomic<int>* destroyed;
+        int value{ 42 };
+        ~X() { ++*destroyed; }
+    };
+
+    constexpr int num_threads = 4;
+    for (int round = 0; round < 50; ++round) {
+        dev::shared_ptr<X> owner = dev::make_shared<X>(&destroyed);
+        dev::weak_ptr<X> weak = owner;
+        std::atomic<bool> start{ false };
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; ++t) {
+            threads.emplace_back([&start, weak] {
+                while (!start.load())
+                    ;
+                for (int i = 0; i < 500; ++i) {
+                    dev::shared_ptr<X> locked = weak.lock();
+                    if (locked != nullptr) {
+                        ASSERT_EQ(locked->value, 42);
+                    }
+                }
+            });
+        }
+        start.store(true);
+        owner.reset();
+        for (auto& thread : threads)
+            thread.join();
+        ASSERT_TRUE(weak.expired());
+        ASSERT_EQ(destroyed.load(), round + 1);
+    }
+}
+
+TEST(SharedPtrTest, MakeSharedArrayTest)
+{
+    dev::shared_ptr<int[]> p;
+    EXPECT_EQ(count_allocations([&p] { p = dev::make_shared<int[]>(1000); }), 1);
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(p[i], 0);
+    p[999] = 7;
+    dev::shared_ptr<int[]> copy = p;
+    EXPECT_EQ(copy[999], 7);
+    EXPECT_EQ(p.use_count(), 2);
+
+    dev::shared_ptr<double[4]> fixed;
+    EXPECT_EQ(count_allocations([&fixed] { fixed = dev::make_shared<double[4]>(); }), 1);
+    for (int i = 0; i < 4; ++i)
+        EXPECT_EQ(fixed[i], 0.0);
+
+    dev::shared_ptr<int[]> empty = dev::make_shared<int[]>(0);
+    EXPECT_NE(empty.get(), nullptr);
+    EXPECT_EQ(empty.use_count(), 1);
+}
+
+TEST(SharedPtrTest, MakeSharedArrayLifetimeTest)
+{
+    static int constructed = 0;
+    static int destroyed = 0;
+    static int throw_at = -1;
+    struct X
+    {
+        int value{ 5 };
+
+        X()
+        {
+            if (constructed == throw_at)
+                throw std::runtime_error("X");
+            ++constructed;
+        }
+        ~X() { ++destroyed; }
+    };
+
+    dev::weak_ptr<X[]> w;
+    {
+        dev::shared_ptr<X[]> p = dev::make_shared<X[]>(10);
+        EXPECT_EQ(constructed, 10);
+        EXPECT_EQ(p[9].value, 5);
+        w = p;
+    }
+    // The elements go with the last owner, even though the block remains
+    EXPECT_EQ(destroyed, 10);
+    EXPECT_TRUE(w.expired());
+
+    // The elements constructed before one throws are destroyed again
+    constructed = 0;
+    destroyed = 0;
+    throw_at = 3;
+    EXPECT_THROW(dev::make_shared<X[]>(10), std::runtime_error);
+    EXPECT_EQ(destroyed, 3);
+    throw_at = -1;
+
+    EXPECT_THROW(dev::make_shared<X[]>(std::numeric_limits<std::size_t>::max() / 2), std::bad_array_new_length);
+}
+
+TEST(SharedPtrTest, MakeSharedForOverwriteTest)
+{
+    EXPECT_EQ(count_allocations([] {
+                  dev::shared_ptr<unsigned char[]> buffer = dev::make_shared_for_overwrite<unsigned char[]>(1 << 16);
+                  buffer[0] = 1;
+                  buffer[(1 << 16) - 1] = 2;
+                  EXPECT_EQ(buffer[0] + buffer[(1 << 16) - 1], 3);
+              }),
+              1);
+    EXPECT_EQ(count_allocations([] { auto p = dev::make_shared_for_overwrite<int[8]>(); }), 1);
+
+    dev::shared_ptr<int> scalar = dev::make_shared_for_overwrite<int>();
+    *scalar = 3;
+    EXPECT_EQ(*scalar, 3);
+
+    // Default-initialization still runs the constructors of class types
+    auto strings = dev::make_shared_for_overwrite<std::string[]>(3);
+    EXPECT_TRUE(strings[2].empty());
+}
+
+TEST(SharedPtrTest, MakeSharedOverAlignedArrayTest)
+{
+    struct alignas(64) line
+    {
+        unsigned char bytes[64];
+    };
+
+    dev::shared_ptr<line[]> lines;
+    // The aligned operator new is counted too
+    EXPECT_EQ(count_allocations([&lines] { lines = dev::make_shared<line[]>(3); }), 1);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(lines.get()) % 64, 0);
+    EXPECT_EQ(lines[2].bytes[63], 0);
+}
@@ -0,0 +1,167 @@
+#include "simd_algorithms.h"
+#include "vector.h"
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <numeric>
+#include <random>
+
+// Linear scans over a dev::vector<double> of prices and a dev::vector<int64_t> of
+// order ids: std:: algorithms against the runtime-dispatched dev::simd kernels.
+
+static dev::vector<double> make_prices(std::size_t n)
+{
+    std::mt19937_64 gen(42);
+    std::uniform_real_distribution<double> price(90.0, 110.0);
+    dev::vector<double> v;
+    v.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        v.push_back(price(gen));
+    return v;
+}
+
+static dev::vector<std::int64_t> make_ids(std::size_t n)
+{
+    dev::vector<std::int64_t> v;
+    v.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        v.push_back(static_cast<std::int64_t>(i * 7919 % 1000003));
+    return v;
+}
+
+#define SCAN_BENCHMARK(name) BENCHMARK(name)->RangeMultiplier(16)->Range(1 << 10, 1 << 24)
+
+static void bench_std_find_double(benchmark::State& state)
+{
+    auto v = make_prices(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::find(v.begin(), v.end(), -1.0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+}
+SCAN_BENCHMARK(bench_std_find_double);
+
+static void bench_simd_find_double(benchmark::State& state)
+{
+    auto v = make_prices(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(dev::simd::find(v, -1.0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+}
+SCAN_BENCHMARK(bench_simd_find_double);
+
+static void bench_std_find_int64(benchmark::State& state)
+{
+    auto v = make_ids(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::find(v.begin(), v.end(), std::int64_t{ -1 }));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(std::int64_t));
+}
+SCAN_BENCHMARK(bench_std_find_int64);
+
+static void bench_simd_find_int64(benchmark::State& state)
+{
+    auto v = make_ids(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(dev::simd::find(v, std::int64_t{ -1 }));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(std::int64_t));
+}
+SCAN_BENCHMARK(bench_simd_find_int64);
+
+static void bench_std_count_int64(benchmark::State& state)
+{
+    auto v = make_ids(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::count(v.begin(), v.end(), std::int64_t{ 7919 }));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(std::int64_t));
+}
+SCAN_BENCHMARK(bench_std_count_int64);
+
+static void bench_simd_count_int64(benchmark::State& state)
+{
+    auto v = make_ids(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(dev::simd::count(v, std::int64_t{ 7919 }));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(std::int64_t));
+}
+SCAN_BENCHMARK(bench_simd_count_int64);
+
+static void bench_std_minmax_double(benchmark::State& state)
+{
+    auto v = make_prices(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(*std::min_element(v.begin(), v.end()));
+        benchmark::DoNotOptimize(*std::max_element(v.begin(), v.end()));
+    }
+    state.SetBytesProcessed(2 * state.iterations() * state.range(0) * sizeof(double));
+}
+SCAN_BENCHMARK(bench_std_minmax_double);
+
+static void bench_simd_minmax_double(benchmark::State& state)
+{
+    auto v = make_prices(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dev::simd::min(v));
+        benchmark::DoNotOptimize(dev::simd::max(v));
+    }
+    state.SetBytesProcessed(2 * state.iterations() * state.range(0) * sizeof(double));
+}
+SCAN_BENCHMARK(bench_simd_minmax_double);
+
+static void bench_std_minmax_int64(benchmark::State& state)
+{
+    auto v = make_ids(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(*std::min_element(v.begin(), v.end()));
+        benchmark::DoNotOptimize(*std::max_element(v.begin(), v.end()));
+    }
+    state.SetBytesProcessed(2 * state.iterations() * state.range(0) * sizeof(std::int64_t));
+}
+SCAN_BENCHMARK(bench_std_minmax_int64);
+
+static void bench_simd_minmax_int64(benchmark::State& state)
+{
+    auto v = make_ids(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(dev::simd::min(v));
+        benchmark::DoNotOptimize(dev::simd::max(v));
+    }
+    state.SetBytesProcessed(2 * state.iterations() * state.range(0) * sizeof(std::int64_t));
+}
+SCAN_BENCHMARK(bench_simd_minmax_int64);
+
+static void bench_std_accumulate_double(benchmark::State& state)
+{
+    auto v = make_prices(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(std::accumulate(v.begin(), v.end(), 0.0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+}
+SCAN_BENCHMARK(bench_std_accumulate_double);
+
+static void bench_simd_sum_double(benchmark::State& state)
+{
+    auto v = make_prices(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(dev::simd::sum(v));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+}
+SCAN_BENCHMARK(bench_simd_sum_double);
+
+// The same kernel restricted to each instruction set:
+// 0 = scalar, 1 = SSE4.2, 2 = AVX2.
+static void bench_simd_sum_double_by_isa(benchmark::State& state)
+{
+    auto v = make_prices(1 << 16);
+    auto isa = static_cast<dev::simd::isa>(state.range(0));
+    if (dev::simd::set_active_isa(isa) != isa) {
+        state.SkipWithError("Instruction set not supported by this CPU");
+        return;
+    }
+    for (auto _ : state)
+        benchmark::DoNotOptimize(dev::simd::sum(v));
+    dev::simd::set_active_isa(dev::simd::isa::avx2);
+    state.SetBytesProcessed(state.iterations() * v.size() * sizeof(double));
+}
+BENCHMARK(bench_simd_sum_double_by_isa)->DenseRange(0, 2);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,117 @@
+#include "simd_algorithms.h"
+#include "vector.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+
+// Runs the same checks once for every instruction set the CPU supports.
+class SimdAlgorithmsTest : public ::testing::TestWithParam<dev::simd::isa>
+{
+  protected:
+    void SetUp() override
+    {
+        if (dev::simd::set_active_isa(GetParam()) != GetParam())
+            GTEST_SKIP() << "Instruction set not supported by this CPU";
+    }
+
+    void TearDown() override { dev::simd::set_active_isa(dev::simd::isa::avx2); }
+
+    // Sizes around every vector width and unroll factor, plus a large one.
+    static constexpr std::size_t sizes[] = { 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 33, 1000 };
+};
+
+TEST_P(SimdAlgorithmsTest, FindTest)
+{
+    for (std::size_t n : sizes) {
+        dev::vector<double> v(n, 1.5);
+        dev::vector<std::int64_t> w(n, 3);
+        EXPECT_EQ(dev::simd::find(v, 2.5), n);
+        EXPECT_EQ(dev::simd::find(w, std::int64_t{ 4 }), n);
+
+        // Plant a match at every position in turn
+        for (std::size_t i = 0; i < n; ++i) {
+            v[i] = 2.5;
+            w[i] = 4;
+            EXPECT_EQ(dev::simd::find(v, 2.5), i);
+            EXPECT_EQ(dev::simd::find(w, std::int64_t{ 4 }), i);
+            v[i] = 1.5;
+            w[i] = 3;
+        }
+    }
+    EXPECT_EQ(dev::simd::find(std::span<const double>{}, 0.0), 0);
+}
+
+TEST_P(SimdAlgorithmsTest, CountTest)
+{
+    std::mt19937_64 gen(42);
+    for (std::size_t n : sizes) {
+        dev::vector<double> v;
+        dev::vector<std::int64_t> w;
+        for (std::size_t i = 0; i < n; ++i) {
+            v.push_back(static_cast<double>(gen() % 4));
+            w.push_back(static_cast<std::int64_t>(gen() % 4) - 2);
+        }
+        EXPECT_EQ(dev::simd::count(v, 1.0), std::count(v.begin(), v.end(), 1.0));
+        EXPECT_EQ(dev::simd::count(w, std::int64_t{ -1 }),
+                  std::count(w.begin(), w.end(), -1));
+    }
+}
+
+TEST_P(SimdAlgorithmsTest, MinMaxTest)
+{
+    std::mt19937_64 gen(7);
+    std::uniform_real_distribution<double> price(-100.0, 100.0);
+    for (std::size_t n : sizes) {
+        dev::vector<double> v;
+        dev::vector<std::int64_t> w;
+        for (std::size_t i = 0; i < n; ++i) {
+            v.push_back(price(gen));
+            w.push_back(static_cast<std::int64_t>(gen()));
+        }
+        EXPECT_EQ(dev::simd::min(v), *std::min_element(v.begin(), v.end()));
+        EXPECT_EQ(dev::simd::max(v), *std::max_element(v.begin(), v.end()));
+        EXPECT_EQ(dev::simd::min(w), *std::min_element(w.begin(), w.end()));
+        EXPECT_EQ(dev::simd::max(w), *std::max_element(w.begin(), w.end()));
+    }
+}
+
+TEST_P(SimdAlgorithmsTest, SumTest)
+{
+    std::mt19937_64 gen(11);
+    std::uniform_real_distribution<double> price(0.0, 100.0);
+    for (std::size_t n : sizes) {
+        dev::vector<double> v;
+        dev::vector<std::int64_t> w;
+        for (std::size_t i = 0; i < n; ++i) {
+            v.push_back(price(gen));
+            w.push_back(static_cast<std::int64_t>(gen() >> 8));
+        }
+        double expected = std::accumulate(v.begin(), v.end(), 0.0);
+        EXPECT_NEAR(dev::simd::sum(v), expected, 1e-9 * expected);
+        EXPECT_EQ(dev::simd::sum(w),
+                  static_cast<std::int64_t>(std::accumulate(
+                    w.begin(), w.end(), std::uint64_t{ 0 }, [](std::uint64_t a, auto b) {
+                        return a + static_cast<std::uint64_t>(b);
+                    })));
+    }
+    EXPECT_EQ(dev::simd::sum(std::span<const double>{}), 0.0);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllIsas,
+                         SimdAlgorithmsTest,
+                         ::testing::Values(dev::simd::isa::scalar,
+                                           dev::simd::isa::sse42,
+                                           dev::simd::isa::avx2),
+                         [](const auto& info) {
+                             switch (info.param) {
+                                 case dev::simd::isa::avx2:
+                                     return "avx2";
+                                 case dev::simd::isa::sse42:
+                                     return "sse42";
+                                 default:
+                                     return "scalar";
+                             }
+                         });
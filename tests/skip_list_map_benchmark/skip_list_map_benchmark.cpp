@@ -0,0 +1,164 @@
+#include "skip_list_map.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+
+// The price levels of one side of a book, shared by all threads, across
+// thread counts. Point updates add and remove levels and look prices up;
+// ordered scans walk a number of levels from a random price, as when a
+// marketable order sweeps the book. dev::skip_list_map is compared with a
+// std::map behind a std::mutex.
+
+constexpr std::uint64_t price_range = 4096;
+
+/**
+ * @brief The single-lock baseline.
+ */
+class locked_map
+{
+  private:
+    std::map<std::uint64_t, std::uint64_t> m_map;
+    mutable std::mutex m_mutex;
+
+  public:
+    std::optional<std::uint64_t> find(std::uint64_t key) const
+    {
+        std::lock_guard lock(m_mutex);
+        auto it = m_map.find(key);
+        if (it == m_map.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    bool insert(std::uint64_t key, std::uint64_t value)
+    {
+        std::lock_guard lock(m_mutex);
+        return m_map.try_emplace(key, value).second;
+    }
+
+    bool erase(std::uint64_t key)
+    {
+        std::lock_guard lock(m_mutex);
+        return m_map.erase(key) != 0;
+    }
+
+    std::uint64_t scan(std::uint64_t from, std::int64_t depth) const
+    {
+        std::lock_guard lock(m_mutex);
+        std::uint64_t total = 0;
+        for (auto it = m_map.lower_bound(from); it != m_map.end() && depth-- > 0; ++it)
+            total += it->second;
+        return total;
+    }
+};
+
+/**
+ * @brief The lock-free map, with the same interface as the baseline.
+ */
+class lock_free_map
+{
+  private:
+    dev::skip_list_map<std::uint64_t, std::uint64_t> m_map;
+
+  public:
+    std::optional<std::uint64_t> find(std::uint64_t key) const { return m_map.find(key); }
+    bool insert(std::uint64_t key, std::uint64_t value) { return m_map.insert(key, value); }
+    bool erase(std::uint64_t key) { return m_map.erase(key); }
+
+    std::uint64_t scan(std::uint64_t from, std::int64_t depth) const
+    {
+        std::uint64_t total = 0;
+        for (auto it = m_map.lower_bound(from); it != m_map.end() && depth-- > 0; ++it)
+            total += it->second;
+        return total;
+    }
+};
+
+template<typename Map>
+static Map& shared_map()
+{
+    static Map* map = [] {
+        auto* m = new Map();
+        for (std::uint64_t key = 0; key < price_range; key += 2)
+            m->insert(key, key);
+        return m;
+    }();
+    return *map;
+}
+
+/**
+ * @brief The argument is the percentage of lookups; half of the other
+ * operations insert a level, the other half erase one, so about half of the
+ * price range stays populated.
+ */
+template<typename Map>
+static void bench_point_update(benchmark::State& state)
+{
+    auto& map = shared_map<Map>();
+    const auto lookup_percent = static_cast<std::uint64_t>(state.range(0));
+    std::mt19937_64 rng(state.thread_index());
+    std::uint64_t hits = 0;
+    for (auto _ : state) {
+        auto r = rng();
+        auto key = r % price_range;
+        if ((r >> 32) % 100 < lookup_percent)
+            hits += map.find(key).has_value();
+        else if ((r >> 40) & 1)
+            map.insert(key, key);
+        else
+            map.erase(key);
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief The argument is the number of levels scanned. One operation in ten
+ * is a point update, so scans run against concurrent writers.
+ */
+template<typename Map>
+static void bench_ordered_scan(benchmark::State& state)
+{
+    auto& map = shared_map<Map>();
+    const auto depth = state.range(0);
+    std::mt19937_64 rng(state.thread_index());
+    std::uint64_t total = 0;
+    for (auto _ : state) {
+        auto r = rng();
+        auto key = r % price_range;
+        if ((r >> 32) % 10 == 0) {
+            if ((r >> 40) & 1)
+                map.insert(key, key);
+            else
+                map.erase(key);
+        } else {
+            total += map.scan(key, depth);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void update_mixes(benchmark::internal::Benchmark* b)
+{
+    for (int lookup_percent : { 90, 50, 0 })
+        b->Arg(lookup_percent);
+    b->ThreadRange(1, 32)->UseRealTime();
+}
+
+static void scan_depths(benchmark::internal::Benchmark* b)
+{
+    for (int depth : { 10, 100 })
+        b->Arg(depth);
+    b->ThreadRange(1, 32)->UseRealTime();
+}
+
+BENCHMARK(bench_point_update<locked_map>)->Apply(update_mixes);
+BENCHMARK(bench_point_update<lock_free_map>)->Apply(update_mixes);
+BENCHMARK(bench_ordered_scan<locked_map>)->Apply(scan_depths);
+BENCHMARK(bench_ordered_scan<lock_free_map>)->Apply(scan_depths);
+
+BENCHMARK_MAIN();
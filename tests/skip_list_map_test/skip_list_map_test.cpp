@@ -0,0 +1,248 @@
+#include "skip_list_map.h"
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <functional>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+template<typename Map>
+static std::vector<std::pair<typename Map::key_type, typename Map::mapped_type>> to_vector(const Map& map)
+{
+    std::vector<std::pair<typename Map::key_type, typename Map::mapped_type>> entries;
+    for (const auto& entry : map)
+        entries.emplace_back(entry.first, entry.second);
+    return entries;
+}
+
+TEST(SkipListMapTest, DefaultConstructorTest)
+{
+    dev::skip_list_map<int, int> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.size(), 0);
+    EXPECT_FALSE(map.contains(1));
+    EXPECT_FALSE(map.find(1).has_value());
+    EXPECT_FALSE(map.erase(1));
+    EXPECT_EQ(map.begin(), map.end());
+}
+
+TEST(SkipListMapTest, InsertEraseFindTest)
+{
+    dev::skip_list_map<std::string, int> map;
+    EXPECT_TRUE(map.insert("IBM", 1));
+    EXPECT_TRUE(map.insert({ "AAPL", 2 }));
+    EXPECT_TRUE(map.try_emplace("MSFT", 3));
+    EXPECT_FALSE(map.insert("AAPL", 4));
+    EXPECT_EQ(map.size(), 3);
+    EXPECT_EQ(map.find("AAPL"), 2);
+    EXPECT_EQ(to_vector(map),
+              (std::vector<std::pair<std::string, int>>{ { "AAPL", 2 }, { "IBM", 1 }, { "MSFT", 3 } }));
+
+    EXPECT_TRUE(map.erase("IBM"));
+    EXPECT_FALSE(map.erase("IBM"));
+    EXPECT_FALSE(map.contains("IBM"));
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_TRUE(map.insert("IBM", 5));
+    EXPECT_EQ(map.find("IBM"), 5);
+}
+
+TEST(SkipListMapTest, ManyKeysTest)
+{
+    // Enough keys for towers of many levels, inserted and erased out of order
+    dev::skip_list_map<int, int> map;
+    constexpr int num_keys = 10000;
+    std::vector<int> keys(num_keys);
+    for (int i = 0; i < num_keys; ++i)
+        keys[i] = i;
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+    for (int key : keys)
+        ASSERT_TRUE(map.insert(key, -key));
+    EXPECT_EQ(map.size(), num_keys);
+
+    int expected = 0;
+    for (const auto& [key, value] : map) {
+        ASSERT_EQ(key, expected);
+        ASSERT_EQ(value, -expected);
+        ++expected;
+    }
+    EXPECT_EQ(expected, num_keys);
+
+    for (int key : keys) {
+        if (key % 3 != 0) {
+            ASSERT_TRUE(map.erase(key));
+        }
+    }
+    for (int key = 0; key < num_keys; ++key)
+        ASSERT_EQ(map.contains(key), key % 3 == 0);
+    EXPECT_EQ(map.size(), (num_keys + 2) / 3);
+}
+
+TEST(SkipListMapTest, LowerBoundScanTest)
+{
+    dev::skip_list_map<int, std::string> map;
+    for (int key : { 100, 101, 103, 104, 107 })
+        map.insert(key, std::to_string(key));
+
+    auto it = map.lower_bound(102);
+    ASSERT_NE(it, map.end());
+    EXPECT_EQ(it->first, 103);
+    EXPECT_EQ((++it)->second, "104");
+    EXPECT_EQ(map.lower_bound(104)->first, 104);
+    EXPECT_EQ(map.lower_bound(0), map.begin());
+    EXPECT_EQ(map.lower_bound(108), map.end());
+
+    map.erase(103);
+    EXPECT_EQ(map.lower_bound(102)->first, 104);
+}
+
+TEST(SkipListMapTest, CustomCompareTest)
+{
+    // Bids are scanned from the highest price down
+    dev::skip_list_map<int, int, std::greater<int>> map;
+    for (int i : { 3, 1, 4, 1, 5, 9, 2, 6 })
+        map.insert(i, i * 10);
+    EXPECT_EQ(map.begin()->first, 9);
+    EXPECT_EQ(map.lower_bound(7)->first, 6);
+    int sum = 0;
+    map.for_each([&sum](const auto& entry) { sum += entry.second; });
+    EXPECT_EQ(sum, 300);
+}
+
+TEST(SkipListMapTest, ConcurrentDisjointInsertsTest)
+{
+    dev::skip_list_map<int, int> map;
+    constexpr int num_threads = 8;
+    constexpr int per_thread = 500;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&map, t] {
+            for (int i = 0; i < per_thread; ++i)
+                ASSERT_TRUE(map.insert(i * num_threads + t, t));
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(map.size(), num_threads * per_thread);
+    auto entries = to_vector(map);
+    ASSERT_EQ(entries.size(), num_threads * per_thread);
+    for (int i = 0; i < num_threads * per_thread; ++i) {
+        ASSERT_EQ(entries[i].first, i);
+        ASSERT_EQ(entries[i].second, i % num_threads);
+    }
+}
+
+TEST(SkipListMapTest, ExactlyOneWinnerTest)
+{
+    // Every round, all threads race to insert the same keys, then to erase
+    // them: every operation must succeed exactly once per key.
+    dev::skip_list_map<int, int> map;
+    constexpr int num_threads = 4;
+    constexpr int num_keys = 64;
+    constexpr int rounds = 50;
+    std::vector<std::atomic<int>> inserted(num_keys);
+    std::vector<std::atomic<int>> erased(num_keys);
+    std::atomic<int> failures{ 0 };
+    std::barrier sync(num_threads, [&]() noexcept {
+        for (int key = 0; key < num_keys; ++key) {
+            if (inserted[key] != erased[key] && inserted[key] != erased[key] + 1)
+                ++failures;
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int round = 0; round < rounds; ++round) {
+                for (int i = 0; i < num_keys; ++i) {
+                    int key = (i + t * 7) % num_keys;
+                    if (map.insert(key, t))
+                        ++inserted[key];
+                }
+                sync.arrive_and_wait();
+                for (int i = 0; i < num_keys; ++i) {
+                    int key = (i + t * 5) % num_keys;
+                    if (map.erase(key))
+                        ++erased[key];
+                }
+                sync.arrive_and_wait();
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(failures.load(), 0);
+    for (int key = 0; key < num_keys; ++key) {
+        EXPECT_EQ(inserted[key].load(), rounds);
+        EXPECT_EQ(erased[key].load(), rounds);
+    }
+    EXPECT_TRUE(map.empty());
+}
+
+TEST(SkipListMapTest, RandomOperationsStressTest)
+{
+    // Threads insert and erase random keys while readers scan. Successful
+    // inserts and erases of a key must alternate, so their difference ends at
+    // 0 or 1 and matches contains(); readers must always see sorted keys
+    // without duplicates, each with the value it was inserted with.
+    dev::skip_list_map<int, int> map;
+    constexpr int num_keys = 256;
+    constexpr int num_writers = 4;
+    constexpr int ops = 20000;
+    std::vector<std::atomic<int>> balance(num_keys);
+    std::atomic<bool> stop{ false };
+    std::atomic<int> failures{ 0 };
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; ++t) {
+        readers.emplace_back([&, t] {
+            std::mt19937 rng(100 + t);
+            while (!stop) {
+                int previous = -1;
+                for (auto it = map.lower_bound(static_cast<int>(rng() % num_keys)); it != map.end(); ++it) {
+                    if (it->first <= previous || it->second != it->first * 2)
+                        ++failures;
+                    previous = it->first;
+                }
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int t = 0; t < num_writers; ++t) {
+        writers.emplace_back([&, t] {
+            std::mt19937 rng(t);
+            for (int i = 0; i < ops; ++i) {
+                int key = static_cast<int>(rng() % num_keys);
+                if (rng() % 2) {
+                    if (map.insert(key, key * 2))
+                        ++balance[key];
+                } else if (map.erase(key)) {
+                    --balance[key];
+                }
+                auto value = map.find(static_cast<int>(rng() % num_keys));
+                if (value && *value % 2 != 0)
+                    ++failures;
+            }
+        });
+    }
+    for (auto& writer : writers)
+        writer.join();
+    stop = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    EXPECT_EQ(failures.load(), 0);
+    std::size_t present = 0;
+    for (int key = 0; key < num_keys; ++key) {
+        ASSERT_TRUE(balance[key] == 0 || balance[key] == 1);
+        ASSERT_EQ(map.contains(key), balance[key] == 1);
+        present += balance[key];
+    }
+    EXPECT_EQ(map.size(), present);
+    EXPECT_EQ(to_vector(map).size(), present);
+}
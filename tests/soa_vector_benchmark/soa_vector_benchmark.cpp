@@ -0,0 +1,111 @@
+#include "simd_algorithms.h"
+#include "soa_vector.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+// Hot loops over order records only touch the price and the quantity.
+// Array-of-structs: every cache line brings in the whole 40-byte record.
+// Structure-of-arrays: only the price and qty columns are streamed.
+
+struct Order
+{
+    double price;
+    std::int64_t qty;
+    char side;
+    std::int64_t id;
+    std::int64_t ts;
+};
+
+using OrderColumns = dev::soa_vector<double, std::int64_t, char, std::int64_t, std::int64_t>;
+
+static dev::vector<Order> make_aos(std::size_t n)
+{
+    dev::vector<Order> orders;
+    orders.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        orders.push_back(Order{ 100.0 + (i % 64) * 0.25,
+                                static_cast<std::int64_t>(i % 100 + 1),
+                                i % 2 ? 'B' : 'S',
+                                static_cast<std::int64_t>(i),
+                                static_cast<std::int64_t>(i * 1000) });
+    return orders;
+}
+
+static OrderColumns make_soa(std::size_t n)
+{
+    OrderColumns orders;
+    orders.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+        orders.emplace_back(100.0 + (i % 64) * 0.25,
+                            static_cast<std::int64_t>(i % 100 + 1),
+                            i % 2 ? 'B' : 'S',
+                            static_cast<std::int64_t>(i),
+                            static_cast<std::int64_t>(i * 1000));
+    return orders;
+}
+
+static void bench_aos_notional(benchmark::State& state)
+{
+    auto orders = make_aos(state.range(0));
+    for (auto _ : state) {
+        double notional = 0.0;
+        for (const auto& order : orders)
+            notional += order.price * order.qty;
+        benchmark::DoNotOptimize(notional);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bench_aos_notional)->RangeMultiplier(16)->Range(1 << 10, 1 << 24);
+
+static void bench_soa_notional(benchmark::State& state)
+{
+    auto orders = make_soa(state.range(0));
+    for (auto _ : state) {
+        auto prices = orders.column<0>();
+        auto quantities = orders.column<1>();
+        double notional = 0.0;
+        for (std::size_t i = 0; i < prices.size(); ++i)
+            notional += prices[i] * quantities[i];
+        benchmark::DoNotOptimize(notional);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bench_soa_notional)->RangeMultiplier(16)->Range(1 << 10, 1 << 24);
+
+// Same computation through the proxy-reference iterator
+static void bench_soa_notional_iterator(benchmark::State& state)
+{
+    auto orders = make_soa(state.range(0));
+    for (auto _ : state) {
+        double notional = 0.0;
+        for (auto [price, qty, side, id, ts] : orders)
+            notional += price * qty;
+        benchmark::DoNotOptimize(notional);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bench_soa_notional_iterator)->RangeMultiplier(16)->Range(1 << 10, 1 << 24);
+
+static void bench_aos_max_price(benchmark::State& state)
+{
+    auto orders = make_aos(state.range(0));
+    for (auto _ : state) {
+        double best = orders[0].price;
+        for (const auto& order : orders)
+            best = order.price > best ? order.price : best;
+        benchmark::DoNotOptimize(best);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bench_aos_max_price)->RangeMultiplier(16)->Range(1 << 10, 1 << 24);
+
+static void bench_soa_max_price_simd(benchmark::State& state)
+{
+    auto orders = make_soa(state.range(0));
+    for (auto _ : state)
+        benchmark::DoNotOptimize(dev::simd::max(orders.column<0>()));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bench_soa_max_price_simd)->RangeMultiplier(16)->Range(1 << 10, 1 << 24);
+
+BENCHMARK_MAIN();
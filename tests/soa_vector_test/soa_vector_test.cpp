@@ -0,0 +1,112 @@
+#include "soa_vector.h"
+#include <gtest/gtest.h>
+#include <string>
+
+using OrderColumns = dev::soa_vector<double, long, char>;
+
+TEST(SoaVectorTest, DefaultConstructorTest)
+{
+    OrderColumns orders;
+    EXPECT_EQ(orders.empty(), true);
+    EXPECT_EQ(orders.size(), 0);
+    EXPECT_EQ(orders.column<0>().size(), 0);
+}
+
+TEST(SoaVectorTest, PushBackTest)
+{
+    OrderColumns orders;
+    orders.push_back({ 101.5, 10, 'B' });
+    std::tuple<double, long, char> record{ 102.0, 20, 'S' };
+    orders.push_back(record);
+
+    EXPECT_EQ(orders.size(), 2);
+    auto [price, qty, side] = orders[1];
+    EXPECT_EQ(price, 102.0);
+    EXPECT_EQ(qty, 20);
+    EXPECT_EQ(side, 'S');
+    EXPECT_EQ(std::get<0>(orders.front()), 101.5);
+
+    auto ref = orders.emplace_back(99.5, 5, 'B');
+    std::get<1>(ref) = 6;
+    EXPECT_EQ(std::get<1>(orders.back()), 6);
+}
+
+TEST(SoaVectorTest, ColumnsAreContiguousTest)
+{
+    OrderColumns orders{ { 1.0, 1, 'B' }, { 2.0, 2, 'S' }, { 3.0, 3, 'B' } };
+
+    std::span<double> prices = orders.column<0>();
+    std::span<long> quantities = orders.column<1>();
+    EXPECT_EQ(prices.size(), 3);
+    EXPECT_EQ(&prices[1], &prices[0] + 1);
+    EXPECT_EQ(&std::get<0>(orders[2]), &prices[2]);
+
+    for (auto& p : prices)
+        p *= 10;
+    EXPECT_EQ(std::get<0>(orders[1]), 20.0);
+
+    const OrderColumns& view = orders;
+    std::span<const long> const_quantities = view.column<1>();
+    EXPECT_EQ(const_quantities.data(), quantities.data());
+}
+
+TEST(SoaVectorTest, IteratorTest)
+{
+    static_assert(std::random_access_iterator<OrderColumns::iterator>);
+
+    OrderColumns orders{ { 1.0, 10, 'B' }, { 2.0, 20, 'S' }, { 3.0, 30, 'B' } };
+
+    double notional{ 0 };
+    for (auto [price, qty, side] : orders)
+        notional += price * qty;
+    EXPECT_EQ(notional, 140.0);
+
+    // Proxy references write through to the columns
+    for (auto [price, qty, side] : orders)
+        qty *= 2;
+    EXPECT_EQ(orders.column<1>()[2], 60);
+
+    auto it = orders.begin();
+    it += 2;
+    EXPECT_EQ(std::get<2>(*it), 'B');
+    EXPECT_EQ(orders.end() - orders.begin(), 3);
+    EXPECT_EQ(std::get<0>(it[-1]), 2.0);
+    EXPECT_TRUE(orders.begin() < it);
+
+    OrderColumns::const_iterator cit = it;
+    EXPECT_EQ(cit, orders.cbegin() + 2);
+}
+
+TEST(SoaVectorTest, ResizePopBackAndClearTest)
+{
+    dev::soa_vector<int, std::string> records;
+    records.reserve(8);
+    EXPECT_GE(records.capacity(), 8);
+
+    records.emplace_back(1, "one");
+    records.emplace_back(2, "two");
+    records.resize(4);
+    EXPECT_EQ(records.size(), 4);
+    EXPECT_EQ(std::get<0>(records[3]), 0);
+    EXPECT_EQ(std::get<1>(records[3]), "");
+
+    records.pop_back();
+    EXPECT_EQ(records.size(), 3);
+    EXPECT_EQ(records.column<1>().size(), 3);
+
+    EXPECT_THROW(records.at(3), std::out_of_range);
+    EXPECT_EQ(std::get<1>(records.at(1)), "two");
+
+    records.clear();
+    EXPECT_EQ(records.empty(), true);
+}
+
+TEST(SoaVectorTest, SwapTest)
+{
+    OrderColumns a{ { 1.0, 1, 'B' } };
+    OrderColumns b{ { 2.0, 2, 'S' }, { 3.0, 3, 'S' } };
+    a.swap(b);
+    EXPECT_EQ(a.size(), 2);
+    EXPECT_EQ(b.size(), 1);
+    EXPECT_EQ(std::get<0>(b[0]), 1.0);
+}
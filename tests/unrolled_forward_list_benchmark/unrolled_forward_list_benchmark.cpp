@@ -0,0 +1,95 @@
+#include "forward_list/forward_list.h"
+#include "unrolled_forward_list.h"
+#include "vector/vector.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+// Traversal and insertion, from 1K to 10M elements, of dev::unrolled_forward_list
+// against dev::forward_list (with std::allocator and with the node pool), with
+// dev::vector as the array baseline for traversal.
+
+using unrolled_list = dev::unrolled_forward_list<std::int64_t>;
+using node_list = dev::forward_list<std::int64_t>;
+using pooled_list = dev::pooled_forward_list<std::int64_t>;
+using array = dev::vector<std::int64_t>;
+
+template<typename List>
+static List make_list(std::int64_t size)
+{
+    List list;
+    auto tail = list.before_begin();
+    for (std::int64_t i = 0; i < size; ++i)
+        tail = list.insert_after(tail, i);
+    return list;
+}
+
+template<>
+array make_list<array>(std::int64_t size)
+{
+    array a;
+    for (std::int64_t i = 0; i < size; ++i)
+        a.push_back(i);
+    return a;
+}
+
+template<typename List>
+static void bench_traverse(benchmark::State& state)
+{
+    const auto list = make_list<List>(state.range(0));
+    for (auto _ : state) {
+        std::int64_t sum = 0;
+        for (auto value : list)
+            sum += value;
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Appends state.range(0) elements, one insert_after at a time.
+template<typename List>
+static void bench_append(benchmark::State& state)
+{
+    for (auto _ : state) {
+        auto list = make_list<List>(state.range(0));
+        benchmark::DoNotOptimize(&list);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Inserts behind a cursor that skips over a few elements between
+// insertions, so that insertions land inside full nodes of the unrolled list.
+template<typename List>
+static void bench_insert_middle(benchmark::State& state)
+{
+    auto list = make_list<List>(state.range(0));
+    auto cursor = list.begin();
+    std::int64_t i = 0;
+    for (auto _ : state) {
+        cursor = list.insert_after(cursor, ++i);
+        for (int step = 0; step < 3 && cursor != list.end(); ++step)
+            ++cursor;
+        if (cursor == list.end())
+            cursor = list.begin();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void sizes(benchmark::internal::Benchmark* b)
+{
+    b->RangeMultiplier(10)->Range(1'000, 10'000'000);
+}
+
+BENCHMARK(bench_traverse<array>)->Apply(sizes);
+BENCHMARK(bench_traverse<unrolled_list>)->Apply(sizes);
+BENCHMARK(bench_traverse<node_list>)->Apply(sizes);
+BENCHMARK(bench_traverse<pooled_list>)->Apply(sizes);
+
+BENCHMARK(bench_append<unrolled_list>)->Apply(sizes);
+BENCHMARK(bench_append<node_list>)->Apply(sizes);
+BENCHMARK(bench_append<pooled_list>)->Apply(sizes);
+
+BENCHMARK(bench_insert_middle<unrolled_list>)->Apply(sizes);
+BENCHMARK(bench_insert_middle<node_list>)->Apply(sizes);
+BENCHMARK(bench_insert_middle<pooled_list>)->Apply(sizes);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,123 @@
+#include "unrolled_forward_list.h"
+#include <forward_list>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+template<typename List>
+static std::vector<typename List::value_type> to_vector(const List& list)
+{
+    return std::vector<typename List::value_type>(list.begin(), list.end());
+}
+
+TEST(UnrolledForwardListTest, DefaultConstructorTest)
+{
+    dev::unrolled_forward_list<int> list;
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(list.size(), 0);
+    EXPECT_EQ(list.begin(), list.end());
+    EXPECT_EQ(std::next(list.before_begin()), list.end());
+}
+
+TEST(UnrolledForwardListTest, RangeConstructorTest)
+{
+    std::vector<int> values(100);
+    for (int i = 0; i < 100; ++i)
+        values[i] = i;
+    dev::unrolled_forward_list<int, 8> list(values.begin(), values.end());
+    EXPECT_EQ(list.size(), 100);
+    EXPECT_EQ(to_vector(list), values);
+
+    dev::unrolled_forward_list<int, 8> copy(list);
+    EXPECT_EQ(copy, list);
+    dev::unrolled_forward_list<int, 8> moved(std::move(copy));
+    EXPECT_TRUE(copy.empty());
+    EXPECT_EQ(moved, list);
+}
+
+TEST(UnrolledForwardListTest, PushFrontAndPopFrontTest)
+{
+    dev::unrolled_forward_list<std::string, 4> list;
+    for (int i = 0; i < 10; ++i)
+        list.push_front(std::to_string(i));
+    EXPECT_EQ(list.size(), 10);
+    EXPECT_EQ(list.front(), "9");
+    EXPECT_EQ(to_vector(list),
+              (std::vector<std::string>{ "9", "8", "7", "6", "5", "4", "3", "2", "1", "0" }));
+
+    for (int i = 9; i >= 0; --i) {
+        EXPECT_EQ(list.front(), std::to_string(i));
+        list.pop_front();
+    }
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(list.begin(), list.end());
+}
+
+TEST(UnrolledForwardListTest, InsertAfterSplitsFullNodesTest)
+{
+    dev::unrolled_forward_list<int, 4> list{ 0, 1, 2, 3 };
+    // The middle of a full node
+    auto it = list.insert_after(std::next(list.begin()), 10);
+    EXPECT_EQ(*it, 10);
+    EXPECT_EQ(to_vector(list), (std::vector<int>{ 0, 1, 10, 2, 3 }));
+
+    it = list.emplace_after(list.before_begin(), -1);
+    EXPECT_EQ(*it, -1);
+    it = list.insert_after(it, -2);
+    EXPECT_EQ(*++it, 0);
+    EXPECT_EQ(to_vector(list), (std::vector<int>{ -1, -2, 0, 1, 10, 2, 3 }));
+    EXPECT_EQ(list.size(), 7);
+}
+
+TEST(UnrolledForwardListTest, EraseAfterTest)
+{
+    dev::unrolled_forward_list<int, 4> list{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    auto it = list.erase_after(list.begin());
+    EXPECT_EQ(*it, 2);
+    // The last element of a node
+    it = list.erase_after(std::next(list.begin(), 2));
+    EXPECT_EQ(*it, 5);
+    EXPECT_EQ(to_vector(list), (std::vector<int>{ 0, 2, 3, 5, 6, 7, 8, 9 }));
+
+    it = list.erase_after(std::next(list.begin(), 6));
+    EXPECT_EQ(it, list.end());
+    EXPECT_EQ(to_vector(list), (std::vector<int>{ 0, 2, 3, 5, 6, 7, 8 }));
+
+    while (list.size() > 1)
+        list.erase_after(list.begin());
+    EXPECT_EQ(to_vector(list), (std::vector<int>{ 0 }));
+    list.erase_after(list.before_begin());
+    EXPECT_TRUE(list.empty());
+}
+
+TEST(UnrolledForwardListTest, RandomOperationsMatchStdForwardListTest)
+{
+    std::mt19937 rng(7);
+    dev::unrolled_forward_list<int, 6> list;
+    std::forward_list<int> expected;
+    std::size_t size = 0;
+    for (int round = 0; round < 5000; ++round) {
+        std::size_t position = size ? rng() % (size + 1) : 0;
+        auto it = list.before_begin();
+        auto expected_it = expected.before_begin();
+        for (std::size_t i = 0; i < position; ++i, ++it, ++expected_it) {
+        }
+        if (rng() % 3 != 0 || size == 0 || position == size) {
+            auto inserted = list.insert_after(it, round);
+            expected.insert_after(expected_it, round);
+            ASSERT_EQ(*inserted, round);
+            ++size;
+        } else {
+            auto next = list.erase_after(it);
+            auto expected_next = expected.erase_after(expected_it);
+            ASSERT_EQ(next == list.end(), expected_next == expected.end());
+            if (next != list.end()) {
+                ASSERT_EQ(*next, *expected_next);
+            }
+            --size;
+        }
+        ASSERT_EQ(list.size(), size);
+    }
+    EXPECT_EQ(to_vector(list), std::vector<int>(expected.begin(), expected.end()));
+}
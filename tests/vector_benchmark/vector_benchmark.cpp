@@ -0,0 +1,298 @@
+#include "execution/execution.h"
+#include "vector.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+// Fill-after-resize: the common pattern of sizing a numeric buffer and then
+// immediately overwriting every element (e.g. loading a price array).
+template<typename Vec>
+static void fill(Vec& v)
+{
+    for (std::size_t i = 0; i < v.size(); ++i)
+        v[i] = static_cast<double>(i);
+}
+
+static void bench_std_vector_resize_fill(benchmark::State& state)
+{
+    for (auto _ : state) {
+        std::vector<double> v;
+        v.resize(state.range(0));
+        fill(v);
+        benchmark::DoNotOptimize(v.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+}
+BENCHMARK(bench_std_vector_resize_fill)->RangeMultiplier(16)->Range(1 << 10, 1 << 26);
+
+static void bench_resize_fill(benchmark::State& state)
+{
+    for (auto _ : state) {
+        dev::vector<double> v;
+        v.resize(state.range(0));
+        fill(v);
+        benchmark::DoNotOptimize(&v[0]);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+}
+BENCHMARK(bench_resize_fill)->RangeMultiplier(16)->Range(1 << 10, 1 << 26);
+
+static void bench_resize_for_overwrite_fill(benchmark::State& state)
+{
+    for (auto _ : state) {
+        dev::vector<double> v;
+        v.resize_for_overwrite(state.range(0));
+        fill(v);
+        benchmark::DoNotOptimize(&v[0]);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+}
+BENCHMARK(bench_resize_for_overwrite_fill)->RangeMultiplier(16)->Range(1 << 10, 1 << 26);
+
+static void bench_append_uninitialized_fill(benchmark::State& state)
+{
+    for (auto _ : state) {
+        dev::vector<double> v;
+        auto tail = v.append_uninitialized(state.range(0));
+        for (std::size_t i = 0; i < tail.size(); ++i)
+            tail[i] = static_cast<double>(i);
+        benchmark::DoNotOptimize(tail.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+}
+BENCHMARK(bench_append_uninitialized_fill)->RangeMultiplier(16)->Range(1 << 10, 1 << 26);
+
+// Range insertion: insert 1M ints into a vector already holding 1M ints, at the
+// front (0), in the middle (1) or at the back (2).
+static constexpr std::size_t num_inserted = 1 << 20;
+
+static std::size_t insert_offset(std::size_t size, std::int64_t where)
+{
+    return where == 0 ? 0 : (where == 1 ? size / 2 : size);
+}
+
+static void bench_std_vector_insert_range(benchmark::State& state)
+{
+    std::vector<int> source(num_inserted, 42);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<int> v(num_inserted, 7);
+        state.ResumeTiming();
+        v.insert(v.begin() + insert_offset(v.size(), state.range(0)),
+                 source.begin(),
+                 source.end());
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_inserted);
+}
+BENCHMARK(bench_std_vector_insert_range)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+static void bench_insert_range(benchmark::State& state)
+{
+    std::vector<int> source(num_inserted, 42);
+    for (auto _ : state) {
+        state.PauseTiming();
+        dev::vector<int> v(num_inserted, 7);
+        state.ResumeTiming();
+        v.insert_range(v.begin() + insert_offset(v.size(), state.range(0)), source);
+        benchmark::DoNotOptimize(&v[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * num_inserted);
+}
+BENCHMARK(bench_insert_range)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+// Same as above, but with enough spare capacity that no reallocation happens
+// and the existing elements are shifted in place.
+static void bench_std_vector_insert_range_in_place(benchmark::State& state)
+{
+    std::vector<int> source(num_inserted, 42);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<int> v(num_inserted, 7);
+        v.reserve(2 * num_inserted);
+        state.ResumeTiming();
+        v.insert(v.begin() + insert_offset(v.size(), state.range(0)),
+                 source.begin(),
+                 source.end());
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_inserted);
+}
+BENCHMARK(bench_std_vector_insert_range_in_place)
+  ->DenseRange(0, 2)
+  ->Unit(benchmark::kMicrosecond);
+
+static void bench_insert_range_in_place(benchmark::State& state)
+{
+    std::vector<int> source(num_inserted, 42);
+    for (auto _ : state) {
+        state.PauseTiming();
+        dev::vector<int> v(num_inserted, 7);
+        v.reserve(2 * num_inserted);
+        state.ResumeTiming();
+        v.insert_range(v.begin() + insert_offset(v.size(), state.range(0)), source);
+        benchmark::DoNotOptimize(&v[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * num_inserted);
+}
+BENCHMARK(bench_insert_range_in_place)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+static void bench_std_vector_append_range(benchmark::State& state)
+{
+    std::vector<int> source(num_inserted, 42);
+    for (auto _ : state) {
+        std::vector<int> v;
+        v.insert(v.end(), source.begin(), source.end());
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_inserted);
+}
+BENCHMARK(bench_std_vector_append_range)->Unit(benchmark::kMicrosecond);
+
+static void bench_append_range(benchmark::State& state)
+{
+    std::vector<int> source(num_inserted, 42);
+    for (auto _ : state) {
+        dev::vector<int> v;
+        v.append_range(source);
+        benchmark::DoNotOptimize(&v[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * num_inserted);
+}
+BENCHMARK(bench_append_range)->Unit(benchmark::kMicrosecond);
+
+// Parallel construction: copy, fill and transform of a 256 MB vector on 1..N
+// threads. Every iteration allocates a fresh block, so the page faults of the
+// first touch are part of the measurement, as they are in production.
+static constexpr std::size_t num_large = std::size_t{ 1 } << 25;
+
+static void thread_counts(benchmark::internal::Benchmark* b)
+{
+    unsigned max_threads = dev::execution::thread_pool::shared().concurrency();
+    for (unsigned n = 1; n < max_threads; n *= 2)
+        b->Arg(n);
+    b->Arg(max_threads);
+}
+
+static void bench_copy_ctor(benchmark::State& state)
+{
+    dev::vector<double> prices(num_large, 100.0);
+    for (auto _ : state) {
+        dev::vector<double> copy(prices);
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetBytesProcessed(state.iterations() * num_large * sizeof(double));
+}
+BENCHMARK(bench_copy_ctor)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void bench_par_copy_ctor(benchmark::State& state)
+{
+    auto policy = dev::execution::par.with_threads(state.range(0));
+    dev::vector<double> prices(num_large, 100.0);
+    for (auto _ : state) {
+        dev::vector<double> copy(policy, prices);
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetBytesProcessed(state.iterations() * num_large * sizeof(double));
+}
+BENCHMARK(bench_par_copy_ctor)
+  ->Apply(thread_counts)
+  ->Unit(benchmark::kMillisecond)
+  ->UseRealTime();
+
+static void bench_par_assign_fill(benchmark::State& state)
+{
+    auto policy = dev::execution::par.with_threads(state.range(0));
+    for (auto _ : state) {
+        dev::vector<double> v;
+        v.assign(policy, num_large, 100.0);
+        benchmark::DoNotOptimize(v.data());
+    }
+    state.SetBytesProcessed(state.iterations() * num_large * sizeof(double));
+}
+BENCHMARK(bench_par_assign_fill)
+  ->Apply(thread_counts)
+  ->Unit(benchmark::kMillisecond)
+  ->UseRealTime();
+
+static void bench_par_transform_into(benchmark::State& state)
+{
+    auto policy = dev::execution::par.with_threads(state.range(0));
+    dev::vector<std::int64_t> qty(num_large, 25);
+    for (auto _ : state) {
+        dev::vector<double> notional;
+        notional.transform_into(policy, qty, [](std::int64_t q) { return q * 101.25; });
+        benchmark::DoNotOptimize(notional.data());
+    }
+    state.SetBytesProcessed(state.iterations() * num_large * sizeof(double));
+}
+BENCHMARK(bench_par_transform_into)
+  ->Apply(thread_counts)
+  ->Unit(benchmark::kMillisecond)
+  ->UseRealTime();
+
+// Hot loops over the accessors that DEV_HARDENED checks. vector_benchmark and
+// vector_benchmark_hardened are built from this file with the switch off and on;
+// compare the two runs. With the switch off the checks compile to nothing.
+static const char* hardening_label()
+{
+    return DEV_HARDENED ? "hardened" : "unchecked";
+}
+
+static void bench_index_sum(benchmark::State& state)
+{
+    dev::vector<double> prices(state.range(0), 100.25);
+    for (auto _ : state) {
+        double total{ 0 };
+        for (std::size_t i = 0; i < prices.size(); ++i)
+            total += prices[i];
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetLabel(hardening_label());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bench_index_sum)->Range(1 << 10, 1 << 20);
+
+static void bench_index_gather(benchmark::State& state)
+{
+    const auto n = static_cast<std::size_t>(state.range(0));
+    dev::vector<double> prices(n, 100.25);
+    dev::vector<std::uint32_t> order_ids;
+    for (std::size_t i = 0; i < n; ++i)
+        order_ids.push_back(static_cast<std::uint32_t>((i * 2654435761u) % n));
+
+    for (auto _ : state) {
+        double total{ 0 };
+        for (std::size_t i = 0; i < order_ids.size(); ++i)
+            total += prices[order_ids[i]];
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetLabel(hardening_label());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(bench_index_gather)->Range(1 << 10, 1 << 20);
+
+static void bench_stack_front_back_pop(benchmark::State& state)
+{
+    dev::vector<std::int64_t> stack;
+    stack.reserve(1024);
+    for (auto _ : state) {
+        for (std::int64_t i = 0; i < 1024; ++i)
+            stack.push_back(i);
+        std::int64_t total{ 0 };
+        while (!stack.empty()) {
+            total += stack.back() - stack.front();
+            stack.pop_back();
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetLabel(hardening_label());
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(bench_stack_front_back_pop);
+
+BENCHMARK_MAIN();
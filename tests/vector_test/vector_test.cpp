@@ -1,5 +1,11 @@
+#include "execution/execution.h"
 #include "vector.h"
 #include <gtest/gtest.h>
+#include <list>
+#include <numeric>
+#include <ranges>
+#include <sstream>
+#include <string>
 
 struct AllocCounter
 {
@@ -54,6 +60,37 @@ struct AllocCounter
     bool operator==(const AllocCounter& other) const { return value == other.value; }
 };
 
+TEST(VectorTest, ContiguousIteratorTest)
+{
+    static_assert(std::contiguous_iterator<dev::vector<int>::iterator>);
+    static_assert(std::contiguous_iterator<dev::vector<int>::const_iterator>);
+    static_assert(std::ranges::contiguous_range<dev::vector<double>>);
+    static_assert(
+      std::is_same_v<std::iter_value_t<dev::vector<int>::const_iterator>, int>);
+
+    dev::vector<int> v{ 1, 2, 3, 4, 5 };
+    EXPECT_EQ(std::to_address(v.begin()), v.data());
+    EXPECT_EQ(std::to_address(v.end()), v.data() + v.size());
+    EXPECT_EQ(std::ranges::data(v), v.data());
+
+    std::span<const int> s(v);
+    EXPECT_EQ(s.size(), 5);
+    EXPECT_EQ(s[4], 5);
+
+    auto it = v.end();
+    auto old = it--;
+    EXPECT_EQ(old, v.end());
+    EXPECT_EQ(*it, 5);
+    it -= 2;
+    EXPECT_EQ(*it, 3);
+    it += -1;
+    EXPECT_EQ(*it, 2);
+    EXPECT_EQ(it[-1], 1);
+
+    EXPECT_EQ(std::ranges::find(v, 4) - v.begin(), 3);
+    EXPECT_EQ(std::reduce(v.cbegin(), v.cend()), 15);
+}
+
 TEST(VectorTest, DefaultConstructorTest)
 {
     dev::vector<int> v;
@@ -222,6 +259,107 @@ TEST(VectorTest, ResizeTest)
     EXPECT_EQ(v[1], 2);
 }
 
+TEST(VectorTest, ResizeZeroFillsTrivialTypesTest)
+{
+    dev::vector<double> v{ 1.5, 2.5, 3.5, 4.5 };
+    v.resize(1);
+    // The old values at indices 1..3 are still sitting in the buffer.
+    // Growing again must value-initialize them.
+    v.resize(4);
+
+    EXPECT_EQ(v.size(), 4);
+    EXPECT_EQ(v[0], 1.5);
+    EXPECT_EQ(v[1], 0.0);
+    EXPECT_EQ(v[2], 0.0);
+    EXPECT_EQ(v[3], 0.0);
+
+    AllocCounter::reset();
+    dev::vector<AllocCounter> vec;
+    vec.resize(5);
+    EXPECT_EQ(vec.size(), 5);
+    EXPECT_EQ(AllocCounter::default_ctor_count, 5);
+}
+
+TEST(VectorTest, ResizeNullsPointersToMembersTest)
+{
+    struct S
+    {
+        int a;
+        int b;
+    };
+    struct holder
+    {
+        int S::*member;
+    };
+
+    dev::vector<int S::*> v;
+    v.resize(3);
+    EXPECT_EQ(v[0], nullptr);
+    EXPECT_EQ(v[2], nullptr);
+
+    dev::vector<holder> h{ holder{ &S::b } };
+    h.resize(0);
+    h.resize(2);
+    EXPECT_EQ(h[0].member, nullptr);
+    EXPECT_EQ(h[1].member, nullptr);
+}
+
+TEST(VectorTest, ResizeForOverwriteTest)
+{
+    dev::vector<int> v{ 1, 2, 3 };
+    v.resize_for_overwrite(1000);
+    EXPECT_EQ(v.size(), 1000);
+    EXPECT_GE(v.capacity(), 1000);
+    EXPECT_EQ(v[0], 1);
+    EXPECT_EQ(v[1], 2);
+    EXPECT_EQ(v[2], 3);
+
+    for (int i{ 0 }; i < v.size(); ++i)
+        v[i] = i;
+    for (int i{ 0 }; i < v.size(); ++i)
+        EXPECT_EQ(v[i], i);
+
+    v.resize_for_overwrite(2);
+    EXPECT_EQ(v.size(), 2);
+    EXPECT_EQ(v[1], 1);
+
+    // Class types are still default-constructed
+    AllocCounter::reset();
+    dev::vector<AllocCounter> vec;
+    vec.resize_for_overwrite(10);
+    EXPECT_EQ(vec.size(), 10);
+    EXPECT_EQ(AllocCounter::default_ctor_count, 10);
+}
+
+TEST(VectorTest, AppendUninitializedTest)
+{
+    dev::vector<long> v{ 7, 8 };
+    std::span<long> tail = v.append_uninitialized(5);
+
+    EXPECT_EQ(v.size(), 7);
+    EXPECT_EQ(tail.size(), 5);
+    EXPECT_EQ(tail.data(), &v[2]);
+
+    for (long i{ 0 }; i < tail.size(); ++i)
+        tail[i] = 100 + i;
+
+    EXPECT_EQ(v[0], 7);
+    EXPECT_EQ(v[1], 8);
+    for (int i{ 2 }; i < v.size(); ++i)
+        EXPECT_EQ(v[i], 100 + i - 2);
+
+    // Repeated appends grow the capacity geometrically
+    dev::vector<long> w;
+    for (int i{ 0 }; i < 100; ++i)
+        w.append_uninitialized(3)[0] = i;
+    EXPECT_EQ(w.size(), 300);
+    EXPECT_LT(w.capacity(), 600);
+    EXPECT_EQ(w[297], 99);
+
+    EXPECT_EQ(w.append_uninitialized(0).size(), 0);
+    EXPECT_EQ(w.size(), 300);
+}
+
 TEST(VectorTest, PushBackTest)
 {
     dev::vector<int> v;
@@ -404,6 +542,122 @@ TEST(VectorTest, InsertRangeClassTypeTest)
     GTEST_LOG_(INFO) << "\n" << "AllocCounter::dtor_count = " << AllocCounter::dtor_count;
 }
 
+TEST(VectorTest, InsertRangeSelfAliasingTest)
+{
+    // Source entirely in front of the insertion point
+    dev::vector<int> v1{ 0, 1, 2, 3, 4, 5 };
+    v1.reserve(32);
+    v1.insert(v1.begin() + 4, v1.begin(), v1.begin() + 3);
+    dev::vector<int> expected1{ 0, 1, 2, 3, 0, 1, 2, 4, 5 };
+    EXPECT_EQ(v1.size(), expected1.size());
+    for (int i{ 0 }; i < v1.size(); ++i)
+        EXPECT_EQ(v1[i], expected1[i]);
+
+    // Source straddling the insertion point
+    dev::vector<int> v2{ 0, 1, 2, 3, 4, 5 };
+    v2.reserve(32);
+    v2.insert(v2.begin() + 2, v2.begin() + 1, v2.begin() + 5);
+    dev::vector<int> expected2{ 0, 1, 1, 2, 3, 4, 2, 3, 4, 5 };
+    EXPECT_EQ(v2.size(), expected2.size());
+    for (int i{ 0 }; i < v2.size(); ++i)
+        EXPECT_EQ(v2[i], expected2[i]);
+
+    // Source entirely behind the insertion point
+    dev::vector<int> v3{ 0, 1, 2, 3, 4, 5 };
+    v3.reserve(32);
+    v3.insert_range(v3.begin(), std::span<int>(&v3[3], 3));
+    dev::vector<int> expected3{ 3, 4, 5, 0, 1, 2, 3, 4, 5 };
+    EXPECT_EQ(v3.size(), expected3.size());
+    for (int i{ 0 }; i < v3.size(); ++i)
+        EXPECT_EQ(v3[i], expected3[i]);
+
+    // The whole vector into itself, triggering a reallocation
+    dev::vector<int> v4{ 1, 2, 3 };
+    v4.insert_range(v4.begin() + 1, v4);
+    dev::vector<int> expected4{ 1, 1, 2, 3, 2, 3 };
+    EXPECT_EQ(v4.size(), expected4.size());
+    for (int i{ 0 }; i < v4.size(); ++i)
+        EXPECT_EQ(v4[i], expected4[i]);
+
+    // Non-trivially copyable element type
+    dev::vector<std::string> v5{ "a", "b", "c", "d" };
+    v5.reserve(32);
+    v5.insert(v5.begin() + 1, v5.begin() + 2, v5.end());
+    dev::vector<std::string> expected5{ "a", "c", "d", "b", "c", "d" };
+    EXPECT_EQ(v5.size(), expected5.size());
+    for (int i{ 0 }; i < v5.size(); ++i)
+        EXPECT_EQ(v5[i], expected5[i]);
+}
+
+TEST(VectorTest, InsertRangeNonTrivialTest)
+{
+    dev::vector<std::string> v{ "a", "e" };
+    v.reserve(16);
+    std::list<std::string> source{ "b", "c", "d" };
+
+    // Fewer elements to shift than to insert
+    auto pos = v.insert_range(v.begin() + 1, source);
+    EXPECT_EQ(*pos, "b");
+    dev::vector<std::string> expected{ "a", "b", "c", "d", "e" };
+    EXPECT_EQ(v.size(), expected.size());
+    for (int i{ 0 }; i < v.size(); ++i)
+        EXPECT_EQ(v[i], expected[i]);
+
+    // More elements to shift than to insert
+    std::list<std::string> one{ "x" };
+    v.insert_range(v.begin(), one);
+    EXPECT_EQ(v.size(), 6);
+    EXPECT_EQ(v[0], "x");
+    EXPECT_EQ(v[1], "a");
+    EXPECT_EQ(v[5], "e");
+}
+
+TEST(VectorTest, AppendRangeTest)
+{
+    dev::vector<int> v{ 1, 2 };
+    std::vector<int> source{ 3, 4, 5 };
+    v.append_range(source);
+    EXPECT_EQ(v.size(), 5);
+    for (int i{ 0 }; i < v.size(); ++i)
+        EXPECT_EQ(v[i], i + 1);
+
+    // Non-contiguous source
+    v.append_range(std::views::iota(6, 9));
+    EXPECT_EQ(v.size(), 8);
+    for (int i{ 0 }; i < v.size(); ++i)
+        EXPECT_EQ(v[i], i + 1);
+
+    // Single-pass source
+    std::istringstream is("9 10 11");
+    v.append_range(std::ranges::subrange(std::istream_iterator<int>(is),
+                                         std::istream_iterator<int>()));
+    EXPECT_EQ(v.size(), 11);
+    for (int i{ 0 }; i < v.size(); ++i)
+        EXPECT_EQ(v[i], i + 1);
+
+    // A vector appended to itself
+    dev::vector<int> w{ 1, 2, 3 };
+    w.append_range(w);
+    EXPECT_EQ(w.size(), 6);
+    EXPECT_EQ(w[3], 1);
+    EXPECT_EQ(w[5], 3);
+
+    // A single allocation for the whole range
+    dev::vector<int> u;
+    u.append_range(std::views::iota(0, 1000));
+    EXPECT_EQ(u.capacity(), 1000);
+}
+
+TEST(VectorTest, AssignSelfSubrangeTest)
+{
+    dev::vector<int> v{ 1, 2, 3, 4, 5 };
+    v.assign(v.begin() + 2, v.end());
+    EXPECT_EQ(v.size(), 3);
+    EXPECT_EQ(v[0], 3);
+    EXPECT_EQ(v[1], 4);
+    EXPECT_EQ(v[2], 5);
+}
+
 TEST(VectorTest, InsertInitializerListTest)
 {
     // Create a vector and populate it with initial values
@@ -474,4 +728,200 @@ TEST(VectorTest, AssignTest)
     // Check the size of the vector
     EXPECT_EQ(v.size(), 0);
     EXPECT_EQ(v.empty(), true);
-}
\ No newline at end of file
+}
+TEST(VectorTest, ResizeWithValueTest)
+{
+    dev::vector<std::string> v{ "a", "b" };
+    v.resize(4, "x");
+    EXPECT_EQ(v.size(), 4);
+    EXPECT_EQ(v[1], "b");
+    EXPECT_EQ(v[3], "x");
+
+    // The value may be an element of the vector, even when it reallocates
+    v.resize(100, v[0]);
+    EXPECT_EQ(v.size(), 100);
+    EXPECT_EQ(v[99], "a");
+
+    v.resize(1, "y");
+    EXPECT_EQ(v.size(), 1);
+    EXPECT_EQ(v[0], "a");
+}
+
+TEST(VectorTest, InsertWithSpareCapacityTest)
+{
+    dev::vector<std::string> v;
+    v.reserve(8);
+    v.insert(v.cbegin(), "c");
+    v.insert(v.cbegin(), "a");
+    v.insert(v.cbegin() + 1, "b");
+    v.insert(v.cend(), "d");
+    EXPECT_EQ(v.size(), 4);
+    EXPECT_EQ(v[0], "a");
+    EXPECT_EQ(v[1], "b");
+    EXPECT_EQ(v[2], "c");
+    EXPECT_EQ(v[3], "d");
+}
+
+TEST(VectorTest, EraseRangeAndClearTest)
+{
+    dev::vector<std::string> v{ "a", "b", "c", "d", "e" };
+    auto it = v.erase(v.cbegin() + 1, v.cbegin() + 3);
+    EXPECT_EQ(*it, "d");
+    EXPECT_EQ(v.size(), 3);
+    EXPECT_EQ(v[2], "e");
+    it = v.erase(v.cbegin(), v.cbegin());
+    EXPECT_EQ(it, v.begin());
+    EXPECT_EQ(v.size(), 3);
+    it = v.erase(v.cbegin() + 1);
+    EXPECT_EQ(*it, "e");
+
+    auto capacity = v.capacity();
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.capacity(), capacity);
+}
+
+TEST(VectorTest, TransformIntoTest)
+{
+    dev::vector<int> qty{ 1, 2, 3, 4 };
+    dev::vector<double> notional;
+    notional.transform_into(qty, [](int q) { return q * 2.5; });
+    EXPECT_EQ(notional.size(), 4);
+    EXPECT_EQ(notional[3], 10.0);
+
+    // In place, from a non-contiguous range
+    std::list<int> ids{ 7, 8, 9 };
+    qty.transform_into(ids, [](int id) { return id * 10; });
+    EXPECT_EQ(qty.size(), 3);
+    EXPECT_EQ(qty[2], 90);
+    qty.transform_into(qty, [](int q) { return q + 1; });
+    EXPECT_EQ(qty[0], 71);
+}
+
+// Large enough to be split into chunks by the parallel overloads
+static constexpr std::size_t parallel_size = 3 * dev::execution::parallel_threshold_bytes;
+
+TEST(VectorTest, ParallelCopyTest)
+{
+    dev::vector<double> prices;
+    prices.resize_for_overwrite(parallel_size);
+    std::iota(prices.begin(), prices.end(), 0.0);
+
+    dev::vector<double> copy(dev::execution::par, prices);
+    EXPECT_EQ(copy.size(), prices.size());
+    EXPECT_EQ(copy.capacity(), prices.size());
+    EXPECT_NE(copy.data(), prices.data());
+    EXPECT_TRUE(std::ranges::equal(copy, prices));
+
+    dev::vector<double> four(dev::execution::par.with_threads(4), prices);
+    EXPECT_TRUE(std::ranges::equal(four, prices));
+
+    dev::vector<double> empty;
+    dev::vector<double> empty_copy(dev::execution::par, empty);
+    EXPECT_EQ(empty_copy.size(), 0);
+}
+
+TEST(VectorTest, ParallelAssignAndResizeTest)
+{
+    auto par = dev::execution::par.with_threads(4);
+
+    dev::vector<std::string> v;
+    v.assign(par, parallel_size / 8, std::string("bid"));
+    EXPECT_EQ(v.size(), parallel_size / 8);
+    EXPECT_TRUE(std::ranges::all_of(v, [](const auto& s) { return s == "bid"; }));
+
+    dev::vector<std::string> w;
+    w.assign(par, v.begin() + 1, v.end());
+    EXPECT_EQ(w.size(), v.size() - 1);
+    EXPECT_EQ(w.back(), "bid");
+
+    // Growing: the tail is filled with a copy of an existing element before the
+    // existing elements are moved into the new block
+    w[0] = "ask";
+    w.resize(par, 2 * w.size(), w[0]);
+    EXPECT_EQ(w.size(), 2 * (v.size() - 1));
+    EXPECT_EQ(w.front(), "ask");
+    EXPECT_EQ(w[1], "bid");
+    EXPECT_EQ(w.back(), "ask");
+
+    w.resize(par, 10, "x");
+    EXPECT_EQ(w.size(), 10);
+    w.reserve(parallel_size / 4);
+    w.resize(par, parallel_size / 4, "x");
+    EXPECT_EQ(w.back(), "x");
+}
+
+TEST(VectorTest, ParallelTransformIntoTest)
+{
+    dev::vector<std::int64_t> qty;
+    qty.resize_for_overwrite(parallel_size / sizeof(std::int64_t));
+    std::iota(qty.begin(), qty.end(), 0);
+
+    dev::vector<double> halves;
+    halves.transform_into(dev::execution::par.with_threads(4), qty, [](std::int64_t q) {
+        return q / 2.0;
+    });
+    EXPECT_EQ(halves.size(), qty.size());
+    for (std::size_t i = 0; i < halves.size(); i += 4097)
+        ASSERT_EQ(halves[i], i / 2.0);
+}
+
+struct ThrowingCopy
+{
+    static inline int live{ 0 };
+    static inline int copies_until_throw{ -1 };
+    std::int64_t value{ 0 };
+
+    ThrowingCopy() { ++live; }
+    ThrowingCopy(const ThrowingCopy& other)
+      : value{ other.value }
+    {
+        if (copies_until_throw == 0)
+            throw std::runtime_error("copy failed");
+        --copies_until_throw;
+        ++live;
+    }
+    ~ThrowingCopy() { --live; }
+};
+
+TEST(VectorTest, ParallelCopyExceptionSafetyTest)
+{
+    {
+        dev::vector<ThrowingCopy> v;
+        v.resize(parallel_size / sizeof(ThrowingCopy));
+        ASSERT_EQ(ThrowingCopy::live, v.size());
+
+        // Fail in the middle of the copy: every element copied so far is destroyed
+        ThrowingCopy::copies_until_throw = static_cast<int>(v.size() / 2);
+        EXPECT_THROW(dev::vector<ThrowingCopy>(dev::execution::par.with_threads(4), v),
+                     std::runtime_error);
+        EXPECT_EQ(ThrowingCopy::live, v.size());
+
+        ThrowingCopy::copies_until_throw = static_cast<int>(v.size() / 3);
+        dev::vector<ThrowingCopy> target{ ThrowingCopy{} };
+        EXPECT_THROW(target.assign(dev::execution::par.with_threads(4), v.begin(), v.end()),
+                     std::runtime_error);
+        EXPECT_EQ(target.size(), 1);
+        EXPECT_EQ(ThrowingCopy::live, v.size() + 1);
+        ThrowingCopy::copies_until_throw = -1;
+    }
+    EXPECT_EQ(ThrowingCopy::live, 0);
+}
+
+#if DEV_HARDENED
+TEST(VectorDeathTest, HardenedPreconditionsTest)
+{
+    dev::vector<int> v{ 1, 2, 3 };
+    const auto& cv = v;
+    EXPECT_DEATH(v[3], "vector index out of bounds");
+    EXPECT_DEATH(cv[100], "vector index out of bounds");
+
+    dev::vector<int> empty;
+    EXPECT_DEATH(empty.front(), "front\\(\\) called on an empty vector");
+    EXPECT_DEATH(empty.back(), "back\\(\\) called on an empty vector");
+    EXPECT_DEATH(empty.pop_back(), "pop_back\\(\\) called on an empty vector");
+
+    // at() keeps throwing
+    EXPECT_THROW(v.at(3), std::out_of_range);
+}
+#endif